@@ -1,7 +1,7 @@
 ///
 /// @file tftp.hpp
 /// @author Yasin BASAR
-/// @brief Header file for TFTP operations including packet creation and block number management.
+/// @brief Header file for TFTP operations including packet creation.
 /// @version 1.0.0
 /// @date 11/08/2024
 /// @copyright (c) 2024 All rights reserved.
@@ -24,21 +24,10 @@
 namespace YB
 {
     /// @class TFTP
-    /// @brief Provides functions to create TFTP packets and manage block numbers.
+    /// @brief Provides functions to create TFTP packets. Block numbers are
+    ///        owned by TFTPSession, so the factory itself is stateless.
     class TFTP
     {
-        /// @brief TFTP Header structure.
-        typedef struct TFTP_header_s
-        {
-            uint16_t op_code; ///< Operation code.
-        } TFTP_header_t;
-
-        /// @brief TFTP Data Block structure.
-        typedef struct TFTP_data_block_s
-        {
-            uint16_t data_block; ///< Data block number.
-        } TFTP_data_block_t;
-
     public:
     ////////////////////////////////////////////////////////////////////////////
     // Special Members
@@ -57,40 +46,157 @@ namespace YB
 
         /// @brief Creates a Read Request (RRQ) packet.
         /// @param file_name The name of the file to be read.
+        /// @param options Mode and options to request, only the non-default options are sent.
         /// @return The RRQ packet.
-        static packet_t make_rrq_packet(const std::string& file_name);
+        static packet_t make_rrq_packet(const std::string& file_name,
+                                        const transfer_options_t& options = transfer_options_t{});
 
         /// @brief Creates a Write Request (WRQ) packet.
         /// @param file_name The name of the file to be written.
+        /// @param options Mode and options to request, only the non-default options are sent.
         /// @return The WRQ packet.
-        static packet_t make_wrq_packet(const std::string& file_name);
-
-        /// @brief Creates a Data packet.
+        static packet_t make_wrq_packet(const std::string& file_name,
+                                        const transfer_options_t& options = transfer_options_t{});
+
+        /// @brief Writes the header of a Data packet in place. The payload is
+        ///        expected right after it, at buffer + data_begin.
+        /// @param buffer At least data_begin bytes.
+        /// @param block_number Block number to put into the header.
+        /// @return Number of bytes written, always data_begin.
+        static int encode_data_header(char* buffer, int block_number);
+
+        /// @brief Writes an ACK packet in place.
+        /// @param buffer At least data_begin bytes.
+        /// @param block_number Block number being acknowledged.
+        /// @return Number of bytes written, always data_begin.
+        static int encode_ack_packet(char* buffer, int block_number);
+
+        /// @brief Writes the final ACK of a transfer which negotiated the
+        ///        checksum option. The option follows the ACK header and
+        ///        carries the CRC32C of the payload the receiver got.
+        /// @param buffer Destination of the packet.
+        /// @param buffer_len Number of bytes available in the buffer.
+        /// @param block_number Block number being acknowledged.
+        /// @param checksum CRC32C of the received payload.
+        /// @return Number of bytes written, -1 if the buffer is too small.
+        static int encode_ack_packet(char* buffer, int buffer_len, int block_number, uint32_t checksum);
+
+        /// @brief Reads the checksum option of a final ACK.
+        /// @param ack The parsed ACK packet.
+        /// @param checksum Receives the CRC32C the receiver reported.
+        /// @return False if the ACK carries no checksum.
+        static bool parse_ack_checksum(const ack_view_t& ack, uint32_t& checksum);
+
+        /// @brief Writes an OACK packet in place.
+        /// @param buffer Destination of the packet.
+        /// @param buffer_len Number of bytes available in the buffer.
+        /// @param options Negotiated options, only the flagged ones are sent.
+        /// @return Number of bytes written, -1 if the buffer is too small.
+        static int encode_oack_packet(char* buffer, int buffer_len,
+                                      const transfer_options_t& options);
+
+        /// @brief Creates a Data packet with an explicit block number.
         /// @param data_block A pointer to the data block.
+        /// @param data_len Number of payload bytes in the data block.
+        /// @param block_number Block number to put into the header.
         /// @return The Data packet.
-        static packet_t make_data_packet(const char* data_block);
+        static packet_t make_data_packet(const char* data_block, int data_len, int block_number);
 
-        /// @brief Creates an Acknowledgment (ACK) packet.
+        /// @brief Creates an Acknowledgment (ACK) packet with an explicit block number.
+        /// @param block_number Block number being acknowledged.
         /// @return The ACK packet.
-        static packet_t make_ack_packet();
-
-        /// @brief Creates an Error packet.
+        static packet_t make_ack_packet(int block_number);
+
+        /// @brief Creates an Option Acknowledgment (OACK) packet (RFC 2347).
+        /// @param options Negotiated options, only the flagged ones are sent.
+        /// @return The OACK packet.
+        static packet_t make_oack_packet(const transfer_options_t& options);
+
+        /// @brief Parses the mode of a RRQ or WRQ and the options which follow
+        ///        it. Values out of the RFC ranges are clamped or ignored.
+        /// @param request The parsed request packet.
+        /// @param options Filled with the requested mode and options.
+        /// @return False if the options are malformed or the mode unknown.
+        static bool parse_request_options(const request_view_t& request,
+                                          transfer_options_t& options);
+
+        /// @brief Parses the options of an OACK packet.
+        /// @param packet The OACK packet.
+        /// @param packet_len Number of bytes in the OACK packet.
+        /// @param options Filled with the acknowledged options.
+        /// @return False if the OACK is malformed.
+        static bool parse_oack_packet(const char* packet, int packet_len,
+                                      transfer_options_t& options);
+
+        /// @brief Creates an Error packet with a generic message.
         /// @return The Error packet.
         static packet_t make_error_packet();
 
-        /// @brief Resets the acknowledgment block number to its initial value.
-        static void reset_ack_data_block_num();
+        /// @brief Creates an Error packet with the given code and message.
+        /// @param error_code One of the ERR_CODE_* values.
+        /// @param error_message Human readable error message.
+        /// @return The Error packet.
+        static packet_t make_error_packet(int error_code, const std::string& error_message);
+
+        /// @brief Reads the modification time of a file as the mtime option carries it.
+        /// @param file_path Path of the file.
+        /// @param modified_time Filled with nanoseconds since the epoch.
+        /// @return False if the file could not be queried or its time is out of range.
+        static bool read_modified_time(const std::string& file_path, int64_t& modified_time);
 
-        /// @brief Resets the data block number to its initial value.
-        static void reset_data_block_num();
+        /// @brief Sets the modification time of a file from the value of an mtime option.
+        /// @param file_path Path of the file.
+        /// @param modified_time Nanoseconds since the epoch, up to TFTP_MAX_MODIFIED_TIME.
+        /// @return False if the time is out of range or could not be set.
+        static bool write_modified_time(const std::string& file_path, int64_t modified_time);
 
     /////////////////////////////////////////////////////////////////////////////
     // Private Members
     ////////////////////////////////////////////////////////////////////////////
     private:
 
-        static int m_data_block_num; ///< Current data block number.
-        static int m_ack_block_num; ///< Current acknowledgment block number.
+        /// @brief Creates a RRQ or WRQ packet.
+        /// @param code op_code::RRQ or op_code::WRQ.
+        /// @param file_name The name of the file.
+        /// @param options Mode and options to request.
+        /// @return The request packet.
+        static packet_t make_request_packet(op_code code, const std::string& file_name,
+                                            const transfer_options_t& options);
+
+        /// @brief Writes the flagged options as NUL terminated name/value pairs.
+        /// @param options Options to write.
+        /// @param buffer Destination of the pairs.
+        /// @param buffer_len Number of bytes available in the buffer.
+        /// @return Number of bytes written, -1 if the buffer is too small.
+        static int encode_options(const transfer_options_t& options, char* buffer, int buffer_len);
+
+        /// @brief Writes one NUL terminated name/value pair.
+        /// @return Number of bytes written, -1 if the buffer is too small.
+        static int encode_option(const char* name, int64_t value, char* buffer, int buffer_len);
+
+        /// @brief Writes the op code every packet starts with, in network byte order.
+        static void encode_op_code(char* buffer, op_code code);
+
+        /// @brief Writes a 16 bit value in network byte order.
+        static void encode_uint16(char* buffer, int value);
+
+        /// @brief Parses NUL terminated name/value pairs.
+        /// @param begin First byte of the first option name.
+        /// @param end One past the last byte of the packet.
+        /// @param options Filled with the recognised options.
+        /// @return False if the pairs are malformed.
+        static bool parse_options(const char* begin, const char* end,
+                                  transfer_options_t& options);
+
+        /// @brief Parses the decimal value of an option.
+        /// @param value First byte of the value.
+        /// @param value_end The NUL ending the value.
+        /// @param number Filled with the value.
+        /// @return False if the value is empty, has trailing bytes or does not fit.
+        static bool parse_number(const char* value, const char* value_end, long long& number);
+
+        /// @brief Case insensitive comparison of an option name.
+        static bool option_name_equals(const char* name, const char* expected);
 
     ////////////////////////////////////////////////////////////////////////////
     // Protected Members
@@ -0,0 +1,99 @@
+///
+/// @file tftp_checksum.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the running payload checksum shared by the TFTP server and client.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_CHECKSUM_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_CHECKSUM_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include "types_enums_macros.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPChecksum
+    /// @brief Running CRC32C (Castagnoli) of the payload of one transfer,
+    ///        updated block by block in the order the blocks are delivered.
+    ///        Uses the crc32 instruction of SSE4.2 or ARMv8 when the
+    ///        processor has it and a table otherwise.
+    class TFTPChecksum
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPChecksum(TFTPChecksum &&) noexcept = default; ///< Default move constructor.
+        TFTPChecksum &operator=(TFTPChecksum &&) noexcept = default; ///< Default move assignment operator.
+        TFTPChecksum(const TFTPChecksum &) noexcept = default; ///< Default copy constructor.
+        TFTPChecksum &operator=(TFTPChecksum const &) noexcept = default; ///< Default copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPChecksum.
+        TFTPChecksum();
+
+        /// @brief Destructor for TFTPChecksum.
+        ~TFTPChecksum() = default;
+
+        /// @brief Starts the checksum of a new transfer.
+        void reset();
+
+        /// @brief Continues a checksum whose first bytes were added elsewhere,
+        ///        as when a transfer resumes from a checkpoint.
+        /// @param value get_value() after those bytes.
+        void resume(uint32_t value);
+
+        /// @brief Adds the next bytes of the payload.
+        /// @param data First byte.
+        /// @param size Number of bytes.
+        void update(const char* data, size_t size);
+
+        /// @brief Returns the CRC32C of every byte added since the last reset.
+        uint32_t get_value() const;
+
+        /// @brief Returns true if the crc32 instruction is used.
+        static bool is_hardware_accelerated();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Updates a CRC with a byte wise lookup table.
+        static uint32_t update_table(uint32_t crc, const unsigned char* data, size_t size);
+
+        /// @brief Updates a CRC with the crc32 instruction, 8 bytes at a time.
+        static uint32_t update_hardware(uint32_t crc, const unsigned char* data, size_t size);
+
+        uint32_t m_crc; ///< CRC of the bytes added so far, inverted.
+        bool m_hardware; ///< The crc32 instruction is available.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_CHECKSUM_HPP
+
+/* End of File */
@@ -0,0 +1,365 @@
+///
+/// @file tftp_co_session.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the awaitable transfer session of the TFTP coroutines.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_CO_SESSION_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_CO_SESSION_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <coroutine>
+#include <string>
+#include "socket_macros.hpp"
+#include "tftp_packet.hpp"
+#include "tftp_reactor.hpp"
+#include "tftp_receive_batch.hpp"
+#include "tftp_retransmitter.hpp"
+#include "tftp_send_batch.hpp"
+#include "tftp_session.hpp"
+#include "tftp_timing_wheel.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPCoSession
+    /// @brief One side of a transfer, seen by a coroutine as a sequence of
+    ///        awaitable steps: `co_await session.recv_block(data)` suspends
+    ///        until the next packet of the peer arrived, `co_await
+    ///        session.send_ack()` queues the answer without suspending.
+    ///        Retransmissions happen while the coroutine waits: the request,
+    ///        the window or the last ACK are resent as the retransmitter
+    ///        expires, and the coroutine is only resumed by a packet or once
+    ///        the retries ran out. Packets queued by the send steps leave
+    ///        together when the coroutine waits next. The client and the
+    ///        server run their transfers this way; a server coroutine also
+    ///        suspends with `co_await session.wait_for_owner()` until the
+    ///        server reports the file read or write it waits for.
+    class TFTPCoSession
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPCoSession(TFTPCoSession &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPCoSession &operator=(TFTPCoSession &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPCoSession(const TFTPCoSession &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPCoSession &operator=(TFTPCoSession const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @class receive_awaiter
+        /// @brief Waits for the next packet of the peer and parses it as the
+        ///        packet type expected.
+        class receive_awaiter
+        {
+        public:
+            /// @brief Constructor for receive_awaiter.
+            /// @param session The session to wait on.
+            /// @param data Filled if a Data packet is expected, else nullptr.
+            /// @param ack Filled if an ACK packet is expected, else nullptr.
+            /// @param deadline Time the wait ends without retransmissions, or
+            ///        the epoch to let the retransmitter decide.
+            receive_awaiter(TFTPCoSession& session, data_view_t* data, ack_view_t* ack,
+                            TFTPRetransmitter::steady_clock_t::time_point deadline);
+
+            /// @brief Sends the queued packets and takes a packet which is
+            ///        already buffered without suspending.
+            bool await_ready();
+
+            /// @brief Suspends the coroutine until the reactor resumes the session.
+            /// @param handle The awaiting coroutine.
+            void await_suspend(std::coroutine_handle<> handle);
+
+            /// @brief Classifies the packet the coroutine waited for.
+            receive_status_t await_resume();
+
+        private:
+            TFTPCoSession& m_session; ///< The session waited on.
+            data_view_t* m_data; ///< Parsed Data packet, nullptr if not expected.
+            ack_view_t* m_ack; ///< Parsed ACK packet, nullptr if not expected.
+            TFTPRetransmitter::steady_clock_t::time_point m_deadline; ///< End of the wait, the epoch if none.
+        };
+
+        /// @class owner_awaiter
+        /// @brief Waits until the owner of the session calls notify(), for
+        ///        work of the transfer which does not come from the peer such
+        ///        as a file read. Nothing is resent meanwhile, packets of the
+        ///        peer are kept for the next receive.
+        class owner_awaiter
+        {
+        public:
+            /// @brief Constructor for owner_awaiter.
+            /// @param session The session to wait on.
+            explicit owner_awaiter(TFTPCoSession& session);
+
+            /// @brief Sends the queued packets, the coroutine always suspends.
+            bool await_ready();
+
+            /// @brief Suspends the coroutine until the owner resumes the session.
+            /// @param handle The awaiting coroutine.
+            void await_suspend(std::coroutine_handle<> handle);
+
+            /// @brief Returns RECEIVE_STATUS_OK, or RECEIVE_STATUS_TIMED_OUT
+            ///        if the owner stayed silent for the idle time.
+            receive_status_t await_resume();
+
+        private:
+            TFTPCoSession& m_session; ///< The session waited on.
+        };
+
+        /// @brief Constructor for TFTPCoSession. The socket is watched by the
+        ///        reactor until the session is destroyed.
+        /// @param reactor The reactor resuming the session.
+        /// @param socket Non-blocking socket of the transfer, owned by the caller.
+        /// @param peer Address of the peer, or the address the request goes to.
+        /// @param peer_known False while the peer has not answered, its first
+        ///                   packet then fixes its transfer identifier.
+        /// @param role Whether this side sends or receives the Data blocks.
+        /// @param buffer_len Size of a receive buffer, the largest packet expected.
+        /// @param buffer_count Datagrams taken from the socket with one call.
+        /// @param options Negotiated or assumed options of the transfer.
+        /// @param max_retries Retransmissions in a row before giving up.
+        /// @param owner Pointer handed back by TFTPReactor::poll() when the session is resumed.
+        TFTPCoSession(TFTPReactor& reactor,
+                      SOCKET socket,
+                      const SOCKADDR_IN& peer,
+                      bool peer_known,
+                      transfer_role_t role,
+                      int buffer_len,
+                      int buffer_count,
+                      const transfer_options_t& options,
+                      int max_retries,
+                      void* owner);
+
+        /// @brief Destructor for TFTPCoSession. The reactor forgets the socket.
+        ~TFTPCoSession();
+
+        /// @brief Sends a request, resent until the peer answers.
+        /// @param request The RRQ or WRQ packet.
+        std::suspend_never send_request(packet_t request);
+
+        /// @brief Queues the ACK of the last accepted block.
+        std::suspend_never send_ack();
+
+        /// @brief Queues the next block of the window, its payload has been
+        ///        written to TFTPSession::next_block_buffer().
+        /// @param data_len Number of payload bytes.
+        std::suspend_never send_block(int data_len);
+
+        /// @brief Queues the next block of the window, its payload stays
+        ///        outside the session, such as in a memory mapped file.
+        /// @param payload First payload byte, it must outlive the transfer.
+        /// @param data_len Number of payload bytes.
+        std::suspend_never send_block(const char* payload, int data_len);
+
+        /// @brief Queues the OACK of the negotiated options, resent until the peer answers.
+        std::suspend_never send_oack();
+
+        /// @brief Queues the blocks of a rewound window which fit into it.
+        std::suspend_never send_unsent_blocks();
+
+        /// @brief Sends an error packet at once.
+        /// @param error_code One of the ERR_CODE_* values.
+        /// @param error_message Human readable error message.
+        void send_error(int error_code, const std::string& error_message);
+
+        /// @brief Sends every queued packet to the peer at once, the last
+        ///        ACK of a coroutine which ends without waiting again.
+        void flush_packets();
+
+        /// @brief Waits for any packet of the peer.
+        receive_awaiter recv_packet();
+
+        /// @brief Waits for the next Data packet of the peer.
+        /// @param data Filled when the status is RECEIVE_STATUS_OK.
+        receive_awaiter recv_block(data_view_t& data);
+
+        /// @brief Waits for the next ACK packet of the peer.
+        /// @param ack Filled when the status is RECEIVE_STATUS_OK.
+        receive_awaiter recv_ack(ack_view_t& ack);
+
+        /// @brief Waits for the next Data packet of the peer until a fixed
+        ///        time, nothing is resent and no error is sent when it passes.
+        /// @param data Filled when the status is RECEIVE_STATUS_OK.
+        /// @param deadline The wait ends with RECEIVE_STATUS_TIMED_OUT at this time.
+        receive_awaiter recv_block_until(data_view_t& data,
+                                         TFTPRetransmitter::steady_clock_t::time_point deadline);
+
+        /// @brief Waits until the owner calls notify().
+        owner_awaiter wait_for_owner();
+
+        /// @brief Resumes a coroutine which waits for the owner.
+        /// @return True if the coroutine was resumed.
+        bool notify();
+
+        /// @brief Applies an ACK to the send window.
+        /// @param ack The ACK.
+        /// @return True if the window moved forward.
+        bool accept_ack(const ack_view_t& ack);
+
+        /// @brief Applies a Data packet to the receive window.
+        /// @param data The Data packet.
+        /// @return What to do with the packet, see TFTPSession::accept_data().
+        data_verdict_t accept_data(const data_view_t& data);
+
+        /// @brief Notes that the peer answered the last packet, a round trip sample.
+        void on_answer();
+
+        /// @brief Applies negotiated options, the timeout among them.
+        /// @param options The options of the OACK.
+        void set_options(const transfer_options_t& options);
+
+        /// @brief Returns the op code of the packet received last.
+        op_code get_op_code() const;
+
+        /// @brief Returns the packet received last, valid until the next wait.
+        const char* get_packet() const;
+
+        /// @brief Returns the size of the packet received last.
+        int get_packet_size() const;
+
+        /// @brief Returns the error packet of a RECEIVE_STATUS_PEER_ERROR.
+        const error_view_t& get_error() const;
+
+        /// @brief Returns true once the peer has answered.
+        bool is_peer_known() const;
+
+        /// @brief Returns the protocol state of the transfer.
+        TFTPSession& get_session();
+
+        /// @brief Returns the retransmission timer of the transfer.
+        const TFTPRetransmitter& get_retransmitter() const;
+
+        /// @brief Returns the number of retransmissions so far.
+        int get_retransmissions() const;
+
+        /// @brief Returns the socket of the session.
+        SOCKET get_socket() const;
+
+        /// @brief Returns the timer of the session, its context is the session.
+        TFTPTimingWheel::wheel_timer_t& get_timer();
+
+        /// @brief Returns the owner handed to the constructor.
+        void* get_owner() const;
+
+        /// @brief Takes the datagrams which arrived and resumes the waiting
+        ///        coroutine if one is for it. Called by the reactor.
+        /// @return True if the coroutine was resumed.
+        bool on_readable();
+
+        /// @brief Takes a datagram the owner read from the socket, such as
+        ///        through an io_uring receive, and resumes the coroutine if it
+        ///        waits for it. The coroutine is done with the datagram when
+        ///        the call returns, one which waits for the owner finds a copy
+        ///        at its next receive.
+        /// @param packet The datagram.
+        /// @param bytes Number of bytes received.
+        /// @param sender Address of the sender.
+        /// @param sender_size Size of the sender address.
+        /// @return True if the coroutine was resumed.
+        bool on_datagram(const char* packet, int bytes,
+                         const SOCKADDR_STORAGE_LH& sender, socklen_t sender_size);
+
+        /// @brief Retransmits on a passed deadline, or resumes the waiting
+        ///        coroutine once the retries ran out. Called by the reactor.
+        /// @return True if the coroutine was resumed.
+        bool on_timeout();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Takes the next valid datagram of the peer out of the batch.
+        ///        Runts are dropped, strangers get an unknown TID error.
+        /// @return True if a datagram of the peer was taken.
+        bool take_datagram();
+
+        /// @brief Checks the sender of a datagram and makes it the packet
+        ///        received last. Runts are dropped, strangers get an unknown
+        ///        TID error.
+        /// @param packet The datagram.
+        /// @param bytes Number of bytes received.
+        /// @param sender Address of the sender.
+        /// @param sender_size Size of the sender address.
+        /// @return True if the datagram came from the peer.
+        bool accept_datagram(const char* packet, int bytes,
+                             const SOCKADDR_STORAGE_LH& sender, socklen_t sender_size);
+
+        /// @brief Suspends the coroutine until a packet or the deadline.
+        /// @param handle The waiting coroutine.
+        /// @param deadline Fixed end of the wait, or the epoch to let the
+        ///        retransmitter decide.
+        void wait(std::coroutine_handle<> handle, TFTPRetransmitter::steady_clock_t::time_point deadline);
+
+        /// @brief Hands control back to the waiting coroutine.
+        void resume();
+
+        /// @brief Resends what the peer has not answered yet.
+        void retransmit();
+
+        /// @brief Queues a packet for the peer.
+        /// @param packet The packet to send, its buffer must outlive the next flush.
+        void send_packet(const packet_view_t& packet);
+
+        /// @brief Sends an error packet to an address which is not the peer.
+        /// @param address Address of the unknown sender.
+        /// @param address_size Size of the unknown sender address.
+        void send_unknown_tid_packet(const SOCKADDR_STORAGE_LH& address,
+                                     socklen_t address_size);
+
+        TFTPReactor& m_reactor; ///< The reactor resuming the session.
+        SOCKET m_socket; ///< Socket of the transfer.
+        SOCKADDR_IN m_peer; ///< Transfer identifier of the peer.
+        socklen_t m_addr_size; ///< Size of the socket address structure.
+        bool m_peer_known; ///< The peer has answered, m_peer is its TID.
+        transfer_role_t m_role; ///< Whether this side sends the Data blocks.
+        void* m_owner; ///< Handed back by the reactor on resumption.
+
+        TFTPReceiveBatch m_receive_batch; ///< Datagrams taken from the socket at once.
+        int m_batch_count; ///< Datagrams in the receive batch.
+        int m_batch_index; ///< Next datagram of the receive batch to look at.
+        TFTPSendBatch m_send_batch; ///< Packets waiting to be sent to the peer.
+        bool m_ack_queued; ///< The ACK buffer is already in the send batch.
+
+        TFTPSession m_session; ///< Protocol state of the transfer.
+        TFTPRetransmitter m_retransmitter; ///< Retransmission timer of the transfer.
+        packet_t m_request_packet; ///< The request, kept for retransmissions.
+        int m_retransmissions; ///< Retransmissions so far.
+
+        const char* m_packet; ///< Packet received last.
+        int m_packet_size; ///< Size of the packet received last.
+        error_view_t m_error; ///< Error packet received last.
+        bool m_timed_out; ///< The retries ran out while waiting.
+        std::coroutine_handle<> m_waiting; ///< Coroutine waiting for a packet or the owner.
+        bool m_waiting_owner; ///< The coroutine waits for notify(), not for a packet.
+        TFTPRetransmitter::steady_clock_t::time_point m_wait_deadline; ///< Fixed end of the wait, the epoch if none.
+        TFTPTimingWheel::wheel_timer_t m_timer; ///< Deadline of the wait in the wheel of the reactor.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_CO_SESSION_HPP
+
+/* End of File */
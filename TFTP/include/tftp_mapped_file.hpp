@@ -0,0 +1,108 @@
+///
+/// @file tftp_mapped_file.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the read-only memory mapped view of a file.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_MAPPED_FILE_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_MAPPED_FILE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPMappedFile
+    /// @brief Read-only view of a whole file mapped into memory, so Data
+    ///        blocks are sent straight from the page cache. Uses mmap on
+    ///        Linux and a file mapping on Windows. The file must not shrink
+    ///        while it is mapped. A view can also be a slice of another
+    ///        mapping, which it keeps alive instead of mapping anything.
+    class TFTPMappedFile
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPMappedFile(TFTPMappedFile &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPMappedFile &operator=(TFTPMappedFile &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPMappedFile(const TFTPMappedFile &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPMappedFile &operator=(TFTPMappedFile const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPMappedFile.
+        TFTPMappedFile();
+
+        /// @brief Destructor for TFTPMappedFile. Unmaps the file.
+        ~TFTPMappedFile();
+
+        /// @brief Maps a whole file for reading.
+        /// @param file_path Path of the file.
+        /// @param sequential The file is read front to back, let the kernel read ahead.
+        /// @return False if the file could not be opened or mapped.
+        bool open(const std::string& file_path, bool sequential = true);
+
+        /// @brief Views a part of another mapping.
+        /// @param parent The mapping, kept alive by the view.
+        /// @param offset First byte of the part.
+        /// @param size Size of the part.
+        /// @return False if the part is not inside the mapping.
+        bool open_slice(std::shared_ptr<const TFTPMappedFile> parent, size_t offset, size_t size);
+
+        /// @brief Unmaps the file.
+        void close();
+
+        /// @brief Returns true if a file is mapped.
+        bool is_open() const;
+
+        /// @brief Returns the first byte of the file, nullptr for an empty file.
+        const char* get_data() const;
+
+        /// @brief Returns the size of the file.
+        size_t get_size() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        const char* m_data; ///< First byte of the mapping.
+        size_t m_size; ///< Size of the mapping.
+        bool m_open; ///< A file is mapped, possibly an empty one.
+        std::shared_ptr<const TFTPMappedFile> m_parent; ///< Mapping a slice points into, nullptr for a mapping of its own.
+
+#ifdef _WIN32
+        void* m_file; ///< HANDLE of the mapped file, kept opaque so windows.h stays out of the header.
+        void* m_mapping; ///< HANDLE of the file mapping.
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_MAPPED_FILE_HPP
+
+/* End of File */
@@ -0,0 +1,148 @@
+///
+/// @file tftp_netascii.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the netascii translation shared by the TFTP server and client.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_NETASCII_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_NETASCII_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <istream>
+#include <vector>
+#include "types_enums_macros.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPNetascii
+    /// @brief Streaming netascii translation of one transfer. Encoding turns
+    ///        LF into CR LF and a bare CR into CR NUL, decoding reverses it.
+    ///        Plain bytes are copied a vector at a time with SSE2 or AVX2 and
+    ///        only line ends take the scalar path. A pair split by the end
+    ///        of a block is kept in the state and finished by the next call.
+    class TFTPNetascii
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPNetascii(TFTPNetascii &&) noexcept = default; ///< Default move constructor.
+        TFTPNetascii &operator=(TFTPNetascii &&) noexcept = default; ///< Default move assignment operator.
+        TFTPNetascii(const TFTPNetascii &) = default; ///< Default copy constructor.
+        TFTPNetascii &operator=(TFTPNetascii const &) = default; ///< Default copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPNetascii.
+        /// @param kernel Translation to use, lowered to the fastest one the
+        ///        processor supports.
+        explicit TFTPNetascii(netascii_kernel_t kernel = get_best_kernel());
+
+        /// @brief Destructor for TFTPNetascii.
+        ~TFTPNetascii() = default;
+
+        /// @brief Returns the fastest kernel the processor supports.
+        static netascii_kernel_t get_best_kernel();
+
+        /// @brief Returns the kernel in use.
+        netascii_kernel_t get_kernel() const;
+
+        /// @brief Forgets a pair split by the previous transfer.
+        void reset();
+
+        /// @brief Encodes local text into netascii until the input is used up
+        ///        or the output is full. The second byte of a pair which does
+        ///        not fit is sent first by the next call.
+        /// @param input Local text.
+        /// @param input_size Bytes at input.
+        /// @param consumed Receives the number of input bytes used.
+        /// @param output Destination of the netascii bytes.
+        /// @param output_size Bytes available at output.
+        /// @return Number of bytes written to output.
+        int encode(const char* input, size_t input_size, size_t& consumed, char* output, int output_size);
+
+        /// @brief Fills a block with the netascii encoding of a stream.
+        /// @param file Stream of local text.
+        /// @param block Destination of the netascii bytes.
+        /// @param block_size Bytes available at block.
+        /// @return Number of bytes written, less than block_size only at the end of the stream.
+        int encode_block(std::istream& file, char* block, int block_size);
+
+        /// @brief Returns true while the second byte of a pair waits for the next block.
+        bool has_pending() const;
+
+        /// @brief Decodes netascii into local text. A CR at the end of the
+        ///        input is held back until the byte after it arrives.
+        /// @param input Netascii bytes.
+        /// @param input_size Bytes at input.
+        /// @param output Destination of the local text, input_size + 1 bytes
+        ///        which do not overlap the input.
+        /// @return Number of bytes written to output.
+        int decode(const char* input, size_t input_size, char* output);
+
+        /// @brief Ends decoding, a CR held back by the last block is kept as it is.
+        /// @param output Destination of at least one byte.
+        /// @return Number of bytes written to output.
+        int finish_decode(char* output);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Encodes byte by byte, splitting the last pair if the output runs out.
+        void encode_scalar(const char*& input, const char* input_end, char*& output, char* output_end);
+
+        /// @brief Decodes byte by byte, holding back a CR at the end of the input.
+        void decode_scalar(const char*& input, const char* input_end, char*& output);
+
+        /// @brief Encodes 16 bytes at a time while a whole vector and a pair fit.
+        static void encode_sse2(const char*& input, const char* input_end, char*& output, char* output_end);
+
+        /// @brief Decodes 16 bytes at a time while the byte after a CR is in the input.
+        static void decode_sse2(const char*& input, const char* input_end, char*& output);
+
+        /// @brief Encodes 32 bytes at a time while a whole vector and a pair fit.
+        static void encode_avx2(const char*& input, const char* input_end, char*& output, char* output_end);
+
+        /// @brief Decodes 32 bytes at a time while the byte after a CR is in the input.
+        static void decode_avx2(const char*& input, const char* input_end, char*& output);
+
+        /// @brief Returns the index of the lowest set bit of a non zero compare mask.
+        static int first_set_bit(uint32_t mask);
+
+        netascii_kernel_t m_kernel; ///< Translation in use.
+        char m_pending_byte; ///< Second byte of a pair the last encode could not write.
+        bool m_has_pending_byte; ///< m_pending_byte waits for the next block.
+        bool m_pending_cr; ///< The last decoded input ended with a CR.
+        std::vector<char> m_staging; ///< Local text read ahead by encode_block().
+        size_t m_staged_offset; ///< First unused byte of m_staging.
+        size_t m_staged_size; ///< Bytes read into m_staging.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_NETASCII_HPP
+
+/* End of File */
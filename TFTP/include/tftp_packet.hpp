@@ -0,0 +1,158 @@
+///
+/// @file tftp_packet.hpp
+/// @author Yasin BASAR
+/// @brief Header file for parsing received TFTP packets in place.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_PACKET_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_PACKET_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "types_enums_macros.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    static_assert(sizeof(op_header_t) == 2, "op_header_t must match the wire layout");
+    static_assert(sizeof(block_header_t) == 4 && offsetof(block_header_t, block_number) == 2,
+                  "block_header_t must match the wire layout");
+    static_assert(sizeof(error_header_t) == 4 && offsetof(error_header_t, error_code) == 2,
+                  "error_header_t must match the wire layout");
+
+    /// @class TFTPPacket
+    /// @brief Parses received packets without copying them. Each parser
+    ///        checks the op code and the length against the fixed header of
+    ///        the packet type and returns views into the datagram, which stay
+    ///        valid as long as the receive buffer is not reused.
+    class TFTPPacket
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPPacket() noexcept = delete; ///< Deleted default constructor
+        ~TFTPPacket() noexcept = delete; ///< Deleted default destructor
+        TFTPPacket(TFTPPacket &&) noexcept = delete; ///< Deleted move constructor
+        TFTPPacket &operator=(TFTPPacket &&) noexcept = delete;///< Deleted move assignment operator
+        TFTPPacket(const TFTPPacket &) noexcept = delete;///< Deleted copy constructor
+        TFTPPacket &operator=(TFTPPacket const &) noexcept = delete; ///< Deleted copy assignment operator
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Returns the op code of a packet.
+        /// @param packet The received datagram.
+        /// @param packet_len Number of bytes in the datagram.
+        /// @return The op code as sent, op_code::NONE if the datagram is shorter than the op code.
+        static op_code get_op_code(const char* packet, int packet_len);
+
+        /// @brief Parses a RRQ or WRQ. The file name and the mode must both be
+        ///        NUL terminated inside the datagram, the file name must not be empty.
+        /// @param packet The received datagram.
+        /// @param packet_len Number of bytes in the datagram.
+        /// @param request Filled with views of the request fields.
+        /// @return False if the datagram is not a well formed request.
+        static bool parse_request(const char* packet, int packet_len, request_view_t& request);
+
+        /// @brief Parses a Data packet.
+        /// @param packet The received datagram.
+        /// @param packet_len Number of bytes in the datagram.
+        /// @param data Filled with the block number and a view of the payload.
+        /// @return False if the datagram is not a Data packet.
+        static bool parse_data(const char* packet, int packet_len, data_view_t& data);
+
+        /// @brief Parses an ACK packet.
+        /// @param packet The received datagram.
+        /// @param packet_len Number of bytes in the datagram.
+        /// @param ack Filled with the block number and a view of the trailing options.
+        /// @return False if the datagram is not an ACK packet.
+        static bool parse_ack(const char* packet, int packet_len, ack_view_t& ack);
+
+        /// @brief Parses an Error packet. A message without its NUL runs to
+        ///        the end of the datagram.
+        /// @param packet The received datagram.
+        /// @param packet_len Number of bytes in the datagram.
+        /// @param error Filled with the error code and a view of the message.
+        /// @return False if the datagram is not an Error packet.
+        static bool parse_error(const char* packet, int packet_len, error_view_t& error);
+
+        /// @brief Parses an OACK packet.
+        /// @param packet The received datagram.
+        /// @param packet_len Number of bytes in the datagram.
+        /// @param oack Filled with a view of the options.
+        /// @return False if the datagram is not an OACK packet.
+        static bool parse_oack(const char* packet, int packet_len, oack_view_t& oack);
+
+    /////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Returns true if the datagram holds a whole Header and starts
+        ///        with the given op code.
+        template <typename Header>
+        static bool has_header(const char* packet, int packet_len, op_code code)
+        {
+            static_assert(offsetof(Header, op_code) == 0, "Every header starts with the op code");
+
+            return packet != nullptr &&
+                   packet_len >= static_cast<int>(sizeof(Header)) &&
+                   read_uint16(packet) == static_cast<uint16_t>(code);
+        }
+
+        /// @brief Reads the 16 bit field at a compile time offset of a Header.
+        template <typename Header, size_t Offset>
+        static uint16_t read_field(const char* packet)
+        {
+            static_assert(Offset + sizeof(uint16_t) <= sizeof(Header), "Field is outside the header");
+
+            return read_uint16(packet + Offset);
+        }
+
+        /// @brief Returns the bytes which follow a Header.
+        template <typename Header>
+        static std::string_view read_body(const char* packet, int packet_len)
+        {
+            return {packet + sizeof(Header), static_cast<size_t>(packet_len) - sizeof(Header)};
+        }
+
+        /// @brief Reads a 16 bit value in network byte order.
+        static constexpr uint16_t read_uint16(const char* bytes)
+        {
+            return static_cast<uint16_t>((static_cast<unsigned char>(bytes[0]) << 8) |
+                                         static_cast<unsigned char>(bytes[1]));
+        }
+
+        /// @brief Splits the NUL terminated field at the front of rest off.
+        /// @param rest Remaining bytes, advanced past the NUL.
+        /// @param field Receives the field without its NUL.
+        /// @return False if rest holds no NUL.
+        static bool take_field(std::string_view& rest, std::string_view& field);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_PACKET_HPP
+
+/* End of File */
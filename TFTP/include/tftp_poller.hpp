@@ -0,0 +1,102 @@
+///
+/// @file tftp_poller.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the socket readiness poller used by the TFTP event loops.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_POLLER_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_POLLER_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <unordered_map>
+#include "socket_macros.hpp"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPPoller
+    /// @brief Waits for many UDP sockets to become readable at once.
+    ///        Uses epoll on Linux and WSAPoll on Windows.
+    class TFTPPoller
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPPoller(TFTPPoller &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPPoller &operator=(TFTPPoller &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPPoller(const TFTPPoller &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPPoller &operator=(TFTPPoller const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPPoller.
+        TFTPPoller();
+
+        /// @brief Destructor for TFTPPoller.
+        ~TFTPPoller();
+
+        /// @brief Starts watching a socket for readability.
+        /// @param socket Socket to watch.
+        /// @param context Pointer handed back by wait() when the socket is readable.
+        void add(SOCKET socket, void* context);
+
+        /// @brief Stops watching a socket.
+        /// @param socket Socket to forget.
+        void remove(SOCKET socket);
+
+        /// @brief Waits until at least one watched socket is readable.
+        /// @param ready_contexts Filled with the contexts of the readable sockets.
+        /// @param timeout_ms Maximum time to wait, -1 waits forever.
+        /// @return The number of readable sockets.
+        int wait(std::vector<void*>& ready_contexts, int timeout_ms);
+
+        /// @brief Puts a socket into non-blocking mode.
+        /// @param socket Socket to modify.
+        static void set_non_blocking(SOCKET socket);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+#ifdef __linux__
+        int m_epoll_fd; ///< epoll instance descriptor.
+        std::vector<epoll_event> m_epoll_events; ///< Scratch array for epoll_wait().
+#else
+        std::vector<WSAPOLLFD> m_poll_fds; ///< Watched sockets.
+        std::vector<void*> m_contexts; ///< Context of each watched socket.
+        std::unordered_map<SOCKET, size_t> m_indices; ///< Socket to index of m_poll_fds.
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_POLLER_HPP
+
+/* End of File */
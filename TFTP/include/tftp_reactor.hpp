@@ -0,0 +1,151 @@
+///
+/// @file tftp_reactor.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the event loop which resumes the TFTP coroutine sessions.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_REACTOR_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_REACTOR_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "socket_macros.hpp"
+#include "tftp_poller.hpp"
+#include "tftp_timing_wheel.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    class TFTPCoSession;
+
+    /// @class TFTPReactor
+    /// @brief Non-blocking event loop of coroutine sessions. The sockets of
+    ///        the sessions are multiplexed by one poller and their deadlines
+    ///        by one timing wheel; a session whose coroutine waits for a
+    ///        packet is resumed by poll() when one arrived or the peer went
+    ///        silent for too long. The client and the server run their
+    ///        transfers on it; the server also watches its listening socket
+    ///        here, and on io_uring only keeps the deadlines of its sessions
+    ///        while the ring hands their datagrams over.
+    class TFTPReactor
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPReactor(TFTPReactor &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPReactor &operator=(TFTPReactor &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPReactor(const TFTPReactor &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPReactor &operator=(TFTPReactor const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPReactor.
+        /// @param poll_sockets False if the owner reads the sockets of the
+        ///        sessions itself and hands their datagrams to
+        ///        TFTPCoSession::on_datagram(), only deadlines are kept then.
+        explicit TFTPReactor(bool poll_sockets = true);
+
+        /// @brief Destructor for TFTPReactor.
+        ~TFTPReactor() = default;
+
+        /// @brief Starts watching the socket of a session.
+        /// @param session The session, its socket must be non-blocking.
+        void watch(TFTPCoSession& session);
+
+        /// @brief Stops watching the socket and the deadline of a session.
+        /// @param session A watched session.
+        void unwatch(TFTPCoSession& session);
+
+        /// @brief Starts watching a socket which belongs to no session.
+        /// @param socket Non-blocking socket.
+        /// @param context Handed back by poll() while the socket is readable.
+        void watch_socket(SOCKET socket, void* context);
+
+        /// @brief Stops watching a socket which belongs to no session.
+        /// @param socket A socket given to watch_socket().
+        void unwatch_socket(SOCKET socket);
+
+        /// @brief Sets the time a waiting session is resumed even if nothing arrived.
+        /// @param timer Timer of the session.
+        /// @param deadline Time the timer expires at.
+        void schedule(TFTPTimingWheel::wheel_timer_t& timer,
+                      TFTPTimingWheel::steady_clock_t::time_point deadline);
+
+        /// @brief Clears the deadline of a session.
+        /// @param timer Timer of the session.
+        void cancel(TFTPTimingWheel::wheel_timer_t& timer);
+
+        /// @brief Waits for socket events or deadlines and resumes the
+        ///        sessions they concern.
+        /// @param timeout_ms Maximum time to wait, -1 waits for the next event.
+        /// @param resumed Filled with the owners of the sessions resumed.
+        /// @return The number of sessions resumed.
+        int poll(int timeout_ms, std::vector<void*>& resumed);
+
+        /// @brief Waits for socket events or deadlines, resumes the sessions
+        ///        they concern and reports the other sockets which are readable.
+        /// @param timeout_ms Maximum time to wait, -1 waits for the next event.
+        /// @param resumed Filled with the owners of the sessions resumed.
+        /// @param ready Filled with the contexts of the readable sockets given to watch_socket().
+        /// @return The number of sessions resumed.
+        int poll(int timeout_ms, std::vector<void*>& resumed, std::vector<void*>& ready);
+
+        /// @brief Resumes the sessions whose deadline has passed, for an
+        ///        owner which waits for events by other means.
+        /// @param resumed Filled with the owners of the sessions resumed.
+        /// @return The number of sessions resumed.
+        int expire(std::vector<void*>& resumed);
+
+        /// @brief Returns the time until the next deadline in milliseconds, -1 if none is set.
+        int next_timeout_ms() const;
+
+        /// @brief Returns the number of watched sessions.
+        size_t get_session_count() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Resumes the sessions whose deadline has passed.
+        /// @param resumed Extended with the owners of the sessions resumed.
+        void resume_expired(std::vector<void*>& resumed);
+
+        std::unique_ptr<TFTPPoller> m_poller; ///< Readiness poller of the sockets.
+        std::unique_ptr<TFTPTimingWheel> m_timers; ///< Deadlines of the waiting sessions.
+        std::vector<void*> m_ready_contexts; ///< Scratch list of readable sockets.
+        std::vector<void*> m_ready_sockets; ///< Scratch list of readable sockets of no session.
+        std::vector<std::pair<SOCKET, void*>> m_sockets; ///< Watched sockets of no session and their contexts.
+        std::vector<void*> m_expired_timers; ///< Scratch list of sessions whose deadline has passed.
+        size_t m_session_count; ///< Number of watched sessions.
+        bool m_poll_sockets; ///< The sockets of the sessions are polled, else the owner reads them.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_REACTOR_HPP
+
+/* End of File */
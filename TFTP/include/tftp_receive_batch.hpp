@@ -0,0 +1,129 @@
+///
+/// @file tftp_receive_batch.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the batched datagram receiver.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_RECEIVE_BATCH_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_RECEIVE_BATCH_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <vector>
+#include "socket_macros.hpp"
+#include "types_enums_macros.hpp"
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPReceiveBatch
+    /// @brief Drains the datagrams waiting on a socket into a set of
+    ///        buffers. Linux takes up to the whole batch with a single
+    ///        recvmmsg call, other platforms fall back to one recvfrom.
+    class TFTPReceiveBatch
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPReceiveBatch(TFTPReceiveBatch &&) noexcept = default; ///< Default move constructor.
+        TFTPReceiveBatch &operator=(TFTPReceiveBatch &&) noexcept = default; ///< Default move assignment operator.
+        TFTPReceiveBatch(const TFTPReceiveBatch &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPReceiveBatch &operator=(TFTPReceiveBatch const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPReceiveBatch.
+        /// @param buffer_len Size of the largest datagram expected.
+        /// @param capacity Datagrams taken per receive() call.
+        TFTPReceiveBatch(int buffer_len, int capacity);
+
+        /// @brief Destructor for TFTPReceiveBatch.
+        ~TFTPReceiveBatch() = default;
+
+        /// @brief Takes the datagrams waiting on the socket without blocking.
+        ///        Earlier datagrams of the batch are overwritten.
+        /// @param socket Socket to read from.
+        /// @return Number of datagrams received, 0 if none was waiting.
+        int receive(SOCKET socket);
+
+        /// @brief Returns a datagram of the last receive() call.
+        /// @param index Index of the datagram.
+        char* get_data(int index);
+
+        /// @brief Returns the size of a datagram of the last receive() call.
+        /// @param index Index of the datagram.
+        int get_size(int index) const;
+
+        /// @brief Returns the sender of a datagram of the last receive() call.
+        /// @param index Index of the datagram.
+        const SOCKADDR_STORAGE_LH& get_address(int index) const;
+
+        /// @brief Returns the sender address size of a datagram.
+        /// @param index Index of the datagram.
+        socklen_t get_address_size(int index) const;
+
+        /// @brief Copies a datagram read by other means, such as an io_uring
+        ///        receive, into a slot of the batch. Longer datagrams are cut
+        ///        to the buffer size like by receive().
+        /// @param index Slot of the datagram, below get_capacity().
+        /// @param data First byte of the datagram.
+        /// @param size Number of bytes of the datagram.
+        /// @param address Sender of the datagram.
+        /// @param address_size Size of the sender address.
+        void store(int index, const char* data, int size,
+                   const SOCKADDR_STORAGE_LH& address, socklen_t address_size);
+
+        /// @brief Returns the size of every datagram buffer.
+        int get_buffer_len() const;
+
+        /// @brief Returns the number of datagram slots.
+        int get_capacity() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        std::unique_ptr<char[]> m_buffer; ///< One buffer_len slot per datagram.
+        std::vector<int> m_sizes; ///< Size of every received datagram.
+        std::vector<SOCKADDR_STORAGE_LH> m_addresses; ///< Sender of every received datagram.
+        std::vector<socklen_t> m_address_sizes; ///< Sender address sizes.
+        int m_buffer_len; ///< Size of one datagram slot.
+        int m_capacity; ///< Number of datagram slots.
+
+#ifdef __linux__
+        std::vector<mmsghdr> m_headers; ///< Message headers of recvmmsg.
+        std::vector<iovec> m_vectors; ///< One I/O vector per datagram slot.
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_RECEIVE_BATCH_HPP
+
+/* End of File */
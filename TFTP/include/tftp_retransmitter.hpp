@@ -0,0 +1,138 @@
+///
+/// @file tftp_retransmitter.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the retransmission timer shared by the TFTP server and client.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_RETRANSMITTER_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_RETRANSMITTER_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include "types_enums_macros.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPRetransmitter
+    /// @brief Retransmission timer of one transfer. Estimates the round trip
+    ///        time (SRTT/RTTVAR as in RFC 6298, sampled with Karn's rule),
+    ///        backs off exponentially on every timeout and gives up after a
+    ///        retry budget. A timeout negotiated with the RFC 2349 option
+    ///        replaces the estimated one.
+    class TFTPRetransmitter
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPRetransmitter(TFTPRetransmitter &&) noexcept = default; ///< Default move constructor.
+        TFTPRetransmitter &operator=(TFTPRetransmitter &&) noexcept = default; ///< Default move assignment operator.
+        TFTPRetransmitter(const TFTPRetransmitter &) noexcept = default; ///< Default copy constructor.
+        TFTPRetransmitter &operator=(TFTPRetransmitter const &) noexcept = default; ///< Default copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Clock of all deadlines.
+        typedef std::chrono::steady_clock steady_clock_t;
+
+        /// @brief Constructor for TFTPRetransmitter.
+        TFTPRetransmitter();
+
+        /// @brief Destructor for TFTPRetransmitter.
+        ~TFTPRetransmitter() = default;
+
+        /// @brief Sets how many timeouts in a row end the transfer.
+        /// @param max_retries Number of retransmissions before giving up, clamped to 0 to TFTP_MAX_RETRIES.
+        void set_max_retries(int max_retries);
+
+        /// @brief Uses the timeout of the RFC 2349 option instead of the estimated one.
+        /// @param seconds Negotiated timeout in seconds, 0 restores the estimation.
+        void set_fixed_timeout(int seconds);
+
+        /// @brief Starts waiting for an answer to packets which were just sent.
+        ///        Does nothing if the timer is already running.
+        /// @param now Current time.
+        void arm(steady_clock_t::time_point now);
+
+        /// @brief Records an answer which moved the transfer forward. Takes a
+        ///        round trip sample unless the packet was retransmitted, resets
+        ///        the back off and the retry budget and stops the timer.
+        /// @param now Current time.
+        void on_answer(steady_clock_t::time_point now);
+
+        /// @brief Records a timeout, doubles the back off and restarts the timer.
+        /// @param now Current time.
+        /// @return False if the retry budget is exhausted.
+        bool on_expired(steady_clock_t::time_point now);
+
+        /// @brief Returns true if the timer is running.
+        bool is_armed() const;
+
+        /// @brief Returns true if the timer is running and its deadline has passed.
+        /// @param now Current time.
+        bool is_expired(steady_clock_t::time_point now) const;
+
+        /// @brief Returns the deadline of the running timer.
+        steady_clock_t::time_point get_deadline() const;
+
+        /// @brief Returns the current retransmission timeout without back off.
+        std::chrono::microseconds get_rto() const;
+
+        /// @brief Returns the smoothed round trip time.
+        std::chrono::microseconds get_srtt() const;
+
+        /// @brief Returns the number of timeouts in a row so far.
+        int get_retries() const;
+
+        /// @brief Returns the timer to the state of a new transfer, keeping
+        ///        the retry budget.
+        void reset();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Returns the longest wait before a retransmission.
+        std::chrono::microseconds get_max_timeout() const;
+
+        std::chrono::microseconds m_srtt; ///< Smoothed round trip time.
+        std::chrono::microseconds m_rttvar; ///< Round trip time variation.
+        std::chrono::microseconds m_rto; ///< Retransmission timeout.
+        std::chrono::microseconds m_fixed_timeout; ///< Negotiated timeout, zero if none.
+        steady_clock_t::time_point m_sent_at; ///< Start of the running timer.
+        steady_clock_t::time_point m_deadline; ///< Deadline of the running timer.
+        int m_backoff; ///< Multiplier of the timeout.
+        int m_retries; ///< Timeouts in a row.
+        int m_max_retries; ///< Timeouts in a row which end the transfer.
+        bool m_armed; ///< The timer is running.
+        bool m_has_sample; ///< At least one round trip has been measured.
+        bool m_retransmitted; ///< A packet was retransmitted since the last answer.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_RETRANSMITTER_HPP
+
+/* End of File */
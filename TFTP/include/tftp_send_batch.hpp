@@ -0,0 +1,104 @@
+///
+/// @file tftp_send_batch.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the batched datagram sender.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_SEND_BATCH_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_SEND_BATCH_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "socket_macros.hpp"
+#include "types_enums_macros.hpp"
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPSendBatch
+    /// @brief Queues packets for one peer and sends them together. Linux
+    ///        flushes the whole queue with a single sendmmsg call, other
+    ///        platforms fall back to one send per packet. Queued packets are
+    ///        views, their buffers must stay untouched until the flush. A
+    ///        packet with a separate payload leaves as one datagram gathered
+    ///        from both buffers.
+    class TFTPSendBatch
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPSendBatch(TFTPSendBatch &&) noexcept = default; ///< Default move constructor.
+        TFTPSendBatch &operator=(TFTPSendBatch &&) noexcept = default; ///< Default move assignment operator.
+        TFTPSendBatch(const TFTPSendBatch &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPSendBatch &operator=(TFTPSendBatch const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPSendBatch.
+        /// @param capacity Packets queued before the caller has to flush.
+        explicit TFTPSendBatch(int capacity = TFTP_BATCH_SIZE);
+
+        /// @brief Destructor for TFTPSendBatch.
+        ~TFTPSendBatch() = default;
+
+        /// @brief Queues a packet.
+        /// @param packet The packet, its buffer must outlive the next flush.
+        /// @return False if the queue is full and nothing was queued.
+        bool queue(const packet_view_t& packet);
+
+        /// @brief Sends every queued packet to the peer and empties the queue.
+        ///        Packets the socket cannot take right now are dropped, the
+        ///        retransmission timer recovers them like any other loss.
+        /// @param socket Socket to send from.
+        /// @param peer Address of the peer.
+        /// @param peer_size Size of the peer address.
+        /// @return Number of packets sent.
+        int flush(SOCKET socket, const SOCKADDR* peer, socklen_t peer_size);
+
+        /// @brief Returns true if no packet is queued.
+        bool is_empty() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        std::vector<packet_view_t> m_packets; ///< Queued packets.
+        int m_capacity; ///< Maximum number of queued packets.
+
+#ifdef __linux__
+        std::vector<mmsghdr> m_headers; ///< Message headers of sendmmsg.
+        std::vector<iovec> m_vectors; ///< Two I/O vectors per queued packet, header and payload.
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_SEND_BATCH_HPP
+
+/* End of File */
@@ -0,0 +1,210 @@
+///
+/// @file tftp_session.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the per-transfer TFTP protocol state.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_SESSION_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_SESSION_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "tftp.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPSession
+    /// @brief Protocol state of one transfer: block sequence, send window,
+    ///        the last control packet sent and the transfer options. Sessions share nothing, so any
+    ///        number of them can run side by side in one process. Packets are
+    ///        encoded in place into buffers owned by the session, so the steady
+    ///        state of a transfer neither allocates nor copies payloads.
+    ///        Blocks are counted in 64 bits from the start of the transfer and
+    ///        only their wire numbers wrap, as the rollover option says.
+    class TFTPSession
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPSession(TFTPSession &&) noexcept = default; ///< Default move constructor.
+        TFTPSession &operator=(TFTPSession &&) noexcept = default; ///< Default move assignment operator.
+        TFTPSession(const TFTPSession &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPSession &operator=(TFTPSession const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPSession.
+        TFTPSession();
+
+        /// @brief Destructor for TFTPSession.
+        ~TFTPSession() = default;
+
+        /// @brief Returns where the payload of the next new block goes. File
+        ///        reads land here, right after the space of the Data header,
+        ///        so the packet is sent without copying the payload.
+        /// @param ahead Blocks to skip, below free_window_slots(), for reads
+        ///        which fill several blocks at once.
+        /// @return block_size writable bytes.
+        char* next_block_buffer(int ahead = 0);
+
+        /// @brief Returns how many new blocks fit into the send window.
+        int free_window_slots() const;
+
+        /// @brief Writes the Data header in front of the payload placed at
+        ///        next_block_buffer() and keeps the packet in the send window
+        ///        until it is acknowledged.
+        /// @param data_len Number of payload bytes.
+        /// @return The Data packet.
+        packet_view_t commit_data_packet(int data_len);
+
+        /// @brief Writes the Data header of a payload kept outside the
+        ///        session, such as a slice of a memory mapped file, and keeps
+        ///        the packet in the send window until it is acknowledged. The
+        ///        payload is never copied, so it must outlive the transfer.
+        /// @param payload First payload byte.
+        /// @param data_len Number of payload bytes.
+        /// @return The Data packet, header and payload as two segments.
+        packet_view_t commit_data_packet(const char* payload, int data_len);
+
+        /// @brief Encodes the ACK packet of the last Data block received in
+        ///        order and keeps it as the last sent packet.
+        /// @return The ACK packet.
+        packet_view_t make_ack_packet();
+
+        /// @brief Makes the following ACKs carry the checksum option, used
+        ///        for the final ACK of a transfer which negotiated it, so
+        ///        repeats of the final ACK carry it too.
+        /// @param checksum CRC32C of the received payload.
+        void set_final_checksum(uint32_t checksum);
+
+        /// @brief Encodes the OACK packet of the negotiated options and keeps
+        ///        it as the last sent packet.
+        /// @return The OACK packet.
+        packet_view_t make_oack_packet();
+
+        /// @brief Applies a cumulative ACK to the send window (RFC 7440).
+        ///        An ACK which moves the window forward but stays below the
+        ///        highest block sent rewinds the window to the block after it.
+        ///        Duplicate ACKs never trigger a retransmission, which avoids
+        ///        the Sorcerer's Apprentice syndrome; lost blocks they point
+        ///        at are resent by the retransmission timer.
+        /// @param block_number Block number carried by the ACK.
+        /// @return True if the ACK moved the transfer forward (ACK 0 of an
+        ///         OACK included), false if it is a duplicate or stale.
+        bool accept_ack(uint16_t block_number);
+
+        /// @brief Rewinds the send window to the first unacknowledged block,
+        ///        used when the retransmission timer expires.
+        void rewind_window();
+
+        /// @brief Returns true if another Data block may be sent.
+        bool is_window_open() const;
+
+        /// @brief Returns true if the window was rewound and blocks which
+        ///        were already created wait to be sent again.
+        bool has_unsent_packet() const;
+
+        /// @brief Returns the next block of a rewound window.
+        packet_view_t next_unsent_packet();
+
+        /// @brief Returns true if every Data block created has been acknowledged.
+        bool is_window_acked() const;
+
+        /// @brief Checks an incoming Data block against the expected one,
+        ///        advances the sequence if it matches and decides whether an
+        ///        ACK is due (window boundary, last block or out of order).
+        /// @param block_number Block number carried by the Data packet.
+        /// @param data_len Number of payload bytes in the Data packet.
+        /// @return What the receiver should do with the block.
+        data_verdict_t accept_data(uint16_t block_number, int data_len);
+
+        /// @brief Returns true if Data blocks arrived in order since the last ACK sent.
+        bool has_unacked_data() const;
+
+        /// @brief Returns true if a payload of this size ends the transfer.
+        /// @param data_len Number of payload bytes in a Data packet.
+        bool is_last_block(int data_len) const;
+
+        /// @brief Returns the last control packet sent, used for retransmissions.
+        packet_view_t get_last_packet() const;
+
+        /// @brief Returns the options of the transfer.
+        const transfer_options_t& get_options() const;
+
+        /// @brief Returns the options of the transfer for negotiation.
+        transfer_options_t& get_options();
+
+        /// @brief Returns the session to the state of a new transfer. The send
+        ///        window buffer is kept for the next transfer.
+        void reset();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Returns the window slot of a block, sizing the send window
+        ///        buffer for the negotiated options first.
+        /// @param block_number Data block number.
+        /// @param payload_capacity Payload bytes a slot holds, 0 if payloads
+        ///        stay outside the session.
+        /// @return Index of the slot.
+        int window_slot(int64_t block_number, int payload_capacity);
+
+        /// @brief Returns the 16 bit number a block carries on the wire under
+        ///        the rollover policy of the transfer.
+        /// @param block_number Data block number counted from the start of the transfer.
+        uint16_t wire_block_number(int64_t block_number) const;
+
+        /// @brief Returns how many blocks after a block a wire number comes.
+        /// @param block_number Data block number counted from the start of the transfer.
+        /// @param wire_number Block number read from a packet.
+        /// @return Distance in blocks, below 65536, or -1 if the wire number
+        ///         cannot follow the block under the rollover policy.
+        int wire_distance(int64_t block_number, uint16_t wire_number) const;
+
+        int64_t m_data_block_num; ///< Highest data block number created.
+        int64_t m_send_block_num; ///< Highest data block number sent since the last rewind.
+        int64_t m_acked_block_num; ///< Highest data block number acknowledged by the peer.
+        int64_t m_ack_block_num; ///< Last data block number received in order.
+        int m_blocks_since_ack; ///< Blocks received in order since the last ACK sent.
+        bool m_gap_acked; ///< An out of order block has already been acknowledged.
+        std::array<char, TFTP_CONTROL_PACKET_LEN> m_control_buffer; ///< Last control packet sent.
+        int m_control_size; ///< Size of the last control packet, 0 if none.
+        int64_t m_control_block_num; ///< Block number of the last control packet.
+        bool m_ack_checksum; ///< ACKs carry m_options.checksum.
+        std::unique_ptr<char[]> m_window_buffer; ///< Unacknowledged Data packets, one slot per block.
+        std::vector<packet_view_t> m_window_packets; ///< Packet of every window slot.
+        int m_slot_size; ///< Bytes of one window slot, Data header included.
+        transfer_options_t m_options; ///< Options of the transfer.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_SESSION_HPP
+
+/* End of File */
@@ -0,0 +1,223 @@
+///
+/// @file tftp_task.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the coroutine task type of the TFTP coroutine sessions.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_TASK_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_TASK_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPTask
+    /// @brief Result of a coroutine which runs a transfer, or a part of
+    ///        one. A task starts suspended: the owner of a top level task
+    ///        resumes it with start(), a coroutine awaiting a task resumes it
+    ///        and is resumed in turn when the task finished. The frame is
+    ///        freed with the task, whether the coroutine finished or not.
+    /// @tparam T Type of the value the coroutine returns, default constructible.
+    template <typename T>
+    class TFTPTask
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPTask(TFTPTask &&other) noexcept ///< Move constructor, the frame changes owner.
+            : m_handle{std::exchange(other.m_handle, nullptr)}
+        {
+        }
+
+        TFTPTask &operator=(TFTPTask &&other) noexcept ///< Move assignment operator, the old frame is freed.
+        {
+            if (this != &other)
+            {
+                this->destroy();
+                this->m_handle = std::exchange(other.m_handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        TFTPTask(const TFTPTask &) = delete; ///< Deleted copy constructor.
+        TFTPTask &operator=(TFTPTask const &) = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Promise of the coroutine, holds its value and its continuation.
+        class promise_type
+        {
+        public:
+            /// @brief Resumes the awaiting coroutine, if any, once the task finished.
+            class final_awaiter
+            {
+            public:
+                /// @brief The coroutine always suspends at its end, its frame belongs to the task.
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                /// @brief Transfers control to the continuation without growing the stack.
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    const std::coroutine_handle<> continuation = handle.promise().m_continuation;
+
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                /// @brief Never resumed.
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+            /// @brief Creates the task owning the frame.
+            TFTPTask get_return_object()
+            {
+                return TFTPTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            /// @brief The coroutine runs from start() or when first awaited.
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            /// @brief Hands control back to the awaiting coroutine.
+            final_awaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            /// @brief Keeps the value of co_return.
+            void return_value(T value)
+            {
+                this->m_value = std::move(value);
+            }
+
+            /// @brief Keeps an exception for the awaiting side to rethrow.
+            void unhandled_exception()
+            {
+                this->m_exception = std::current_exception();
+            }
+
+            T m_value{}; ///< Value of co_return.
+            std::exception_ptr m_exception{}; ///< Exception which ended the coroutine.
+            std::coroutine_handle<> m_continuation{}; ///< Coroutine awaiting the task.
+        };
+
+        /// @brief Constructor for an empty TFTPTask without a coroutine.
+        TFTPTask()
+            : m_handle{nullptr}
+        {
+        }
+
+        /// @brief Destructor for TFTPTask. Frees the frame of the coroutine.
+        ~TFTPTask()
+        {
+            this->destroy();
+        }
+
+        /// @brief Runs a top level coroutine until it first suspends.
+        void start()
+        {
+            this->m_handle.resume();
+        }
+
+        /// @brief Returns true once the coroutine returned, false for an empty task.
+        bool is_done() const
+        {
+            return this->m_handle && this->m_handle.done();
+        }
+
+        /// @brief Returns the value of a finished coroutine, or rethrows the
+        ///        exception which ended it.
+        T& get_result()
+        {
+            if (this->m_handle.promise().m_exception)
+            {
+                std::rethrow_exception(this->m_handle.promise().m_exception);
+            }
+
+            return this->m_handle.promise().m_value;
+        }
+
+        /// @brief A task is awaited by running it, it never finished before.
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        /// @brief Runs the coroutine of the task, the awaiting one resumes when it finished.
+        /// @param continuation The awaiting coroutine.
+        /// @return The coroutine to run now.
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+        {
+            this->m_handle.promise().m_continuation = continuation;
+
+            return this->m_handle;
+        }
+
+        /// @brief Returns the value of the finished coroutine to the awaiting one.
+        T await_resume()
+        {
+            return std::move(this->get_result());
+        }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Constructor for TFTPTask, called by the promise.
+        /// @param handle Frame of the coroutine.
+        explicit TFTPTask(std::coroutine_handle<promise_type> handle)
+            : m_handle{handle}
+        {
+        }
+
+        /// @brief Frees the frame of the coroutine, if any.
+        void destroy()
+        {
+            if (this->m_handle)
+            {
+                this->m_handle.destroy();
+                this->m_handle = nullptr;
+            }
+        }
+
+        std::coroutine_handle<promise_type> m_handle; ///< Frame of the coroutine.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_TASK_HPP
+
+/* End of File */
@@ -0,0 +1,153 @@
+///
+/// @file tftp_timing_wheel.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the hierarchical timing wheel which keeps the
+///        deadlines of the server sessions.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_TIMING_WHEEL_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_TIMING_WHEEL_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "types_enums_macros.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPTimingWheel
+    /// @brief Hierarchical timing wheel with 1 ms ticks. Four levels of 64
+    ///        slots cover about 4.6 hours; a timer sits in the lowest level
+    ///        whose slots still tell its tick apart from the current one, and
+    ///        falls to a lower level whenever the level above turns over.
+    ///        Later timers wait in an overflow list until the wheel reaches them.
+    ///        Timers are intrusive nodes owned by the caller, so scheduling,
+    ///        moving and cancelling a timer are O(1) and never allocate.
+    class TFTPTimingWheel
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPTimingWheel(TFTPTimingWheel &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPTimingWheel &operator=(TFTPTimingWheel &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPTimingWheel(const TFTPTimingWheel &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPTimingWheel &operator=(TFTPTimingWheel const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Clock of all deadlines.
+        typedef std::chrono::steady_clock steady_clock_t;
+
+        /// @brief A timer, embedded in the object it belongs to.
+        typedef struct wheel_timer_s
+        {
+            wheel_timer_s* prev = nullptr; ///< Previous timer of the slot, nullptr if not scheduled.
+            wheel_timer_s* next = nullptr; ///< Next timer of the slot.
+            uint64_t expiry = 0; ///< Tick the timer expires at.
+            uint32_t slot = 0; ///< Index of the slot holding the timer.
+            void* context = nullptr; ///< Pointer handed back by advance() when the timer expires.
+        } wheel_timer_t;
+
+        /// @brief Constructor for TFTPTimingWheel. Tick 0 is the current time.
+        TFTPTimingWheel();
+
+        /// @brief Destructor for TFTPTimingWheel.
+        ~TFTPTimingWheel() = default;
+
+        /// @brief Schedules a timer, moving it if it is already scheduled.
+        /// @param timer The timer, must stay alive until it expires or is cancelled.
+        /// @param deadline Time the timer expires at, rounded up to a tick.
+        void schedule(wheel_timer_t& timer, steady_clock_t::time_point deadline);
+
+        /// @brief Cancels a timer. Does nothing if it is not scheduled.
+        /// @param timer The timer.
+        void cancel(wheel_timer_t& timer);
+
+        /// @brief Returns true if the timer is scheduled.
+        static bool is_scheduled(const wheel_timer_t& timer);
+
+        /// @brief Moves the wheel up to the current time and collects the
+        ///        expired timers, which are no longer scheduled afterwards.
+        /// @param now Current time.
+        /// @param expired Filled with the contexts of the expired timers.
+        void advance(steady_clock_t::time_point now, std::vector<void*>& expired);
+
+        /// @brief Returns the milliseconds until the wheel next needs to
+        ///        advance, -1 if no timer is scheduled. May be earlier than
+        ///        the first deadline when timers of a higher level fall down.
+        /// @param now Current time.
+        int next_timeout_ms(steady_clock_t::time_point now) const;
+
+        /// @brief Returns the number of scheduled timers.
+        size_t get_size() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        static constexpr int slot_bits = 6; ///< Bits of the tick every level covers.
+        static constexpr int slot_count = 1 << slot_bits; ///< Slots of a level.
+        static constexpr int level_count = 4; ///< Levels of the wheel.
+        static constexpr uint64_t slot_mask = slot_count - 1; ///< Slot index mask.
+        static constexpr uint64_t wheel_mask = (uint64_t{1} << (slot_bits * level_count)) - 1; ///< Ticks of one wheel turn.
+        static constexpr uint32_t overflow_slot = level_count * slot_count; ///< Index of the overflow list.
+
+        /// @brief Converts a time to a tick.
+        /// @param time_point The time.
+        /// @param round_up Round a partial tick up instead of down.
+        uint64_t to_tick(steady_clock_t::time_point time_point, bool round_up) const;
+
+        /// @brief Puts a timer into the slot of its expiry tick.
+        /// @param timer An unscheduled timer.
+        void link(wheel_timer_t& timer);
+
+        /// @brief Takes a timer out of its slot.
+        /// @param timer A scheduled timer.
+        void unlink(wheel_timer_t& timer);
+
+        /// @brief Links every timer of a slot again, moving them down a level.
+        /// @param slot Index of the slot.
+        void relink(uint32_t slot);
+
+        /// @brief Returns the first tick at which the wheel has work.
+        uint64_t next_tick() const;
+
+        /// @brief Returns the index of the lowest set bit.
+        static int lowest_bit(uint64_t bits);
+
+        wheel_timer_t m_slots[level_count * slot_count + 1]; ///< Sentinel of every slot list and of the overflow list.
+        uint64_t m_occupied[level_count]; ///< Bit i is set if slot i of the level holds timers.
+        uint64_t m_current; ///< Next tick to process, every earlier tick has expired.
+        size_t m_size; ///< Number of scheduled timers.
+        steady_clock_t::time_point m_origin; ///< Time of tick 0.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_TIMING_WHEEL_HPP
+
+/* End of File */
@@ -0,0 +1,210 @@
+///
+/// @file tftp_uring.hpp
+/// @author Yasin BASAR
+/// @brief Header file for the io_uring submission and completion rings.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_URING_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_URING_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <vector>
+#include "socket_macros.hpp"
+#include "types_enums_macros.hpp"
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPUring
+    /// @brief Thin io_uring wrapper built on the raw system calls. Owns the
+    ///        submission and completion rings and a group of buffers provided
+    ///        to the kernel, which multishot receives fill without a copy.
+    ///        Only compiled with the TFTP_IO_URING option.
+    class TFTPUring
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPUring(TFTPUring &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPUring &operator=(TFTPUring &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPUring(const TFTPUring &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPUring &operator=(TFTPUring const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief One completion taken from the completion ring.
+        typedef struct completion_s
+        {
+            uint64_t user_data; ///< Value given when the request was submitted.
+            int result; ///< Result of the request, -errno on failure.
+            uint32_t flags; ///< IORING_CQE_F_* flags.
+        } completion_t;
+
+        /// @brief A datagram delivered by a multishot receive.
+        typedef struct datagram_s
+        {
+            char* data; ///< First byte of the datagram.
+            int size; ///< Datagram size.
+            const SOCKADDR_STORAGE_LH* sender; ///< Address of the sender.
+            socklen_t sender_size; ///< Size of the sender address.
+        } datagram_t;
+
+        /// @brief Constructor for TFTPUring. Sets the rings up and hands the
+        ///        provided buffers to the kernel.
+        /// @param entries Size of the submission ring.
+        /// @param buffer_len Size of every provided buffer.
+        /// @param buffer_count Number of provided buffers, at most 65536.
+        /// @throw std::runtime_error if the kernel lacks a required feature.
+        TFTPUring(unsigned entries, int buffer_len, int buffer_count);
+
+        /// @brief Destructor for TFTPUring.
+        ~TFTPUring();
+
+        /// @brief Queues a multishot receive which keeps delivering the
+        ///        datagrams of a socket into provided buffers.
+        /// @param socket Socket to receive from.
+        /// @param user_data Value returned with every completion.
+        void prepare_receive(SOCKET socket, uint64_t user_data);
+
+        /// @brief Queues a vectored file read.
+        /// @param fd File to read from.
+        /// @param vectors Destination buffers, must stay valid until submitted.
+        /// @param count Number of destination buffers.
+        /// @param offset File offset of the first byte.
+        /// @param user_data Value returned with the completion.
+        void prepare_read(int fd, const iovec* vectors, int count, uint64_t offset, uint64_t user_data);
+
+        /// @brief Queues a file write.
+        /// @param fd File to write to.
+        /// @param data Bytes to write, must stay valid until completed.
+        /// @param size Number of bytes to write.
+        /// @param offset File offset of the first byte.
+        /// @param user_data Value returned with the completion.
+        void prepare_write(int fd, const char* data, int size, uint64_t offset, uint64_t user_data);
+
+        /// @brief Queues the cancellation of a request.
+        /// @param target_user_data User data the request was submitted with.
+        void prepare_cancel(uint64_t target_user_data);
+
+        /// @brief Submits the queued requests and waits for completions.
+        /// @param completions Filled with every completion available.
+        /// @param timeout_ms Maximum time to wait, -1 to wait forever.
+        /// @return Number of completions.
+        int submit_and_wait(std::vector<completion_t>& completions, int timeout_ms);
+
+        /// @brief Decodes the datagram of a multishot receive completion.
+        /// @param completion A successful receive completion.
+        /// @param datagram Filled with the datagram.
+        /// @return False if the completion carries no usable datagram.
+        bool get_datagram(const completion_t& completion, datagram_t& datagram);
+
+        /// @brief Returns the provided buffer id of a completion, -1 if none.
+        static int get_buffer_id(const completion_t& completion);
+
+        /// @brief Packs the kind of a request, a provided buffer id and the id
+        ///        of its owner into user data.
+        /// @param op One of the URING_OP_* values.
+        /// @param buffer_id Provided buffer the request uses, 0 if none.
+        /// @param owner_id Id of the owner, below 2^40.
+        static uint64_t make_user_data(uring_op_t op, int buffer_id, uint64_t owner_id);
+
+        /// @brief Returns the request kind packed into user data.
+        static uring_op_t get_op(uint64_t user_data);
+
+        /// @brief Returns the provided buffer id packed into user data.
+        static int get_request_buffer_id(uint64_t user_data);
+
+        /// @brief Returns the owner id packed into user data.
+        static uint64_t get_owner_id(uint64_t user_data);
+
+        /// @brief Hands a provided buffer back to the kernel.
+        /// @param buffer_id Buffer id of a receive completion.
+        void recycle_buffer(int buffer_id);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Returns a free submission entry, submitting first if the
+        ///        ring is full.
+        io_uring_sqe* next_entry();
+
+        /// @brief Submits the queued entries.
+        /// @param wait_for Completions to wait for.
+        /// @param timeout_ms Maximum time to wait, -1 to wait forever.
+        void enter(unsigned wait_for, int timeout_ms);
+
+        /// @brief Moves every available completion into the list.
+        /// @param completions Receives the completions.
+        void reap(std::vector<completion_t>& completions);
+
+        /// @brief Checks that the kernel keeps a multishot receive running.
+        /// @return False if multishot receives are not supported.
+        bool probe_multishot_receive();
+
+        /// @brief Queues the hand over of consecutive provided buffers to the kernel.
+        /// @param first_id Id of the first buffer.
+        /// @param count Number of buffers.
+        void provide_buffers(int first_id, int count);
+
+        /// @brief Releases every ring mapping and the ring descriptor.
+        void release();
+
+        static constexpr uint64_t internal_user_data = UINT64_MAX; ///< Marks requests whose completions are not reported.
+
+        int m_ring_fd; ///< Descriptor of the ring.
+        void* m_sq_ring; ///< Mapping of the submission ring.
+        void* m_cq_ring; ///< Mapping of the completion ring, may equal m_sq_ring.
+        io_uring_sqe* m_sqes; ///< Submission entries.
+        size_t m_sq_ring_size; ///< Size of the submission ring mapping.
+        size_t m_cq_ring_size; ///< Size of the completion ring mapping.
+        size_t m_sqes_size; ///< Size of the submission entries mapping.
+
+        unsigned* m_sq_head; ///< Submission ring head, moved by the kernel.
+        unsigned* m_sq_tail; ///< Submission ring tail.
+        unsigned m_sq_mask; ///< Submission ring index mask.
+        unsigned m_sq_entries; ///< Number of submission entries.
+        unsigned* m_sq_array; ///< Submission ring index array.
+
+        unsigned* m_cq_head; ///< Completion ring head.
+        unsigned* m_cq_tail; ///< Completion ring tail, moved by the kernel.
+        unsigned m_cq_mask; ///< Completion ring index mask.
+        io_uring_cqe* m_cqes; ///< Completion entries.
+
+        char* m_buffers; ///< Memory of the provided buffers.
+        int m_buffer_len; ///< Size of one provided buffer.
+        int m_buffer_count; ///< Number of provided buffers.
+        msghdr m_receive_layout; ///< Address and control space reserved by multishot receives.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_URING_HPP
+
+/* End of File */
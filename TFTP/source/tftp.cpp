@@ -1,7 +1,7 @@
 ///
 /// @file tftp.cpp
 /// @author Yasin BASAR
-/// @brief Implementation file for TFTP operations including packet creation and block number management.
+/// @brief Implementation file for TFTP operations including packet creation.
 /// @version 1.0.0
 /// @date 11/08/2024
 /// @copyright (c) 2024 All rights reserved.
@@ -21,6 +21,16 @@
 #endif
 
 #include "tftp.hpp"
+#include "tftp_packet.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <string>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,122 +39,554 @@
 
 namespace YB
 {
-    /// @brief Initializes the static data block number.
-    int TFTP::m_data_block_num = 1U;
-
-    /// @brief Initializes the static acknowledgment block number.
-    int TFTP::m_ack_block_num = 1U;
-
 ////////////////////////////////////////////////////////////////////////////////
 // Public Functions
 ////////////////////////////////////////////////////////////////////////////////
 
-    packet_t TFTP::make_rrq_packet(const std::string& file_name)
-    {
-        TFTP_header_t header{};
-        header.op_code = htons(OP_CODE_RRQ);
-        int file_name_len = file_name.length() + 1;
-        int header_size = sizeof(header);
-        int data_len = header_size + file_name_len + 5 + 1;
-        packet_t rrq;
-        rrq.data_ptr = std::make_unique<char[]>(data_len);
-        rrq.size = data_len;
-        rrq.data_block_number = -1;
-        memcpy(rrq.data_ptr.get(), &header, header_size);
-        memcpy(rrq.data_ptr.get() + header_size, file_name.c_str(), file_name_len);
-        memcpy(rrq.data_ptr.get() + header_size + file_name_len, "octet", 6);
-        return rrq;
-    }
-
-    packet_t TFTP::make_wrq_packet(const std::string& file_name)
-    {
-        TFTP_header_t header{};
-        header.op_code = htons(OP_CODE_WRQ);
-        int file_name_len = file_name.length() + 1;
-        int header_size = sizeof(header);
-        int data_len = header_size + file_name_len + 5 + 1;
-        packet_t wrq;
-        wrq.data_ptr = std::make_unique<char[]>(data_len);
-        wrq.size = data_len;
-        wrq.data_block_number = -1;
-        memcpy(wrq.data_ptr.get(), &header, header_size);
-        memcpy(wrq.data_ptr.get() + header_size, file_name.c_str(), file_name_len);
-        memcpy(wrq.data_ptr.get() + header_size + file_name_len, "octet", 6);
-        return wrq;
-    }
-
-    packet_t TFTP::make_data_packet(const char* data_block)
-    {
-        TFTP_header_t header{};
-        header.op_code = htons(OP_CODE_DATA);
-        TFTP_data_block_t block{};
-        block.data_block = htons(m_data_block_num);
-        int header_size = sizeof(header);
-        int block_size = sizeof(block);
-        int data_len = header_size + block_size + TFTP_OUTGOING_DATA_BUFFER_LEN;
+    packet_t TFTP::make_rrq_packet(const std::string& file_name,
+                                   const transfer_options_t& options)
+    {
+        return make_request_packet(op_code::RRQ, file_name, options);
+    }
+
+    packet_t TFTP::make_wrq_packet(const std::string& file_name,
+                                   const transfer_options_t& options)
+    {
+        return make_request_packet(op_code::WRQ, file_name, options);
+    }
+
+    int TFTP::encode_data_header(char* buffer, int block_number)
+    {
+        encode_op_code(buffer, op_code::DATA);
+        encode_uint16(buffer + offsetof(block_header_t, block_number), block_number);
+        return data_begin;
+    }
+
+    int TFTP::encode_ack_packet(char* buffer, int block_number)
+    {
+        encode_op_code(buffer, op_code::ACK);
+        encode_uint16(buffer + offsetof(block_header_t, block_number), block_number);
+        return data_begin;
+    }
+
+    int TFTP::encode_ack_packet(char* buffer, int buffer_len, int block_number, uint32_t checksum)
+    {
+        if (buffer_len < data_begin)
+        {
+            return -1;
+        }
+
+        encode_ack_packet(buffer, block_number);
+
+        const int option_len = encode_option(OPTION_NAME_CHECKSUM, checksum,
+                                             buffer + data_begin, buffer_len - data_begin);
+
+        return option_len < 0 ? -1 : data_begin + option_len;
+    }
+
+    bool TFTP::parse_ack_checksum(const ack_view_t& ack, uint32_t& checksum)
+    {
+        transfer_options_t options{};
+
+        // Peers which know nothing of the option send a bare ACK.
+        if (ack.options.empty() ||
+            !parse_options(ack.options.data(), ack.options.data() + ack.options.size(), options) ||
+            (options.negotiated & OPTION_CHECKSUM) == 0)
+        {
+            return false;
+        }
+
+        checksum = options.checksum;
+        return true;
+    }
+
+    int TFTP::encode_oack_packet(char* buffer, int buffer_len,
+                                 const transfer_options_t& options)
+    {
+        constexpr int header_size = sizeof(op_header_t);
+
+        if (buffer_len < header_size)
+        {
+            return -1;
+        }
+
+        encode_op_code(buffer, op_code::OACK);
+
+        const int options_len = encode_options(options, buffer + header_size,
+                                               buffer_len - header_size);
+
+        return options_len < 0 ? -1 : header_size + options_len;
+    }
+
+    packet_t TFTP::make_data_packet(const char* data_block, int data_len, int block_number)
+    {
+        int packet_len = data_begin + data_len;
         packet_t data_packet;
-        data_packet.data_ptr = std::make_unique<char[]>(data_len);
-        data_packet.size = data_len;
-        data_packet.data_block_number = m_data_block_num++;
-        memcpy(data_packet.data_ptr.get(), &header, sizeof(header));
-        memcpy(data_packet.data_ptr.get() + header_size, &block, block_size);
-        memcpy(data_packet.data_ptr.get() + header_size + block_size, data_block, TFTP_OUTGOING_DATA_BUFFER_LEN);
+        data_packet.data_ptr = std::make_unique<char[]>(packet_len);
+        data_packet.size = packet_len;
+        data_packet.data_block_number = block_number;
+        encode_data_header(data_packet.data_ptr.get(), block_number);
+        memcpy(data_packet.data_ptr.get() + data_begin, data_block, data_len);
         return data_packet;
     }
 
-    packet_t TFTP::make_ack_packet()
+    packet_t TFTP::make_ack_packet(int block_number)
     {
-        TFTP_header_t header{};
-        header.op_code = htons(OP_CODE_ACK);
-        TFTP_data_block_t block{};
-        block.data_block = htons(m_ack_block_num);
-        int header_size = sizeof(header);
-        int block_size = sizeof(block);
-        int data_len = header_size + block_size + 1;
         packet_t ack_packet;
-        ack_packet.data_ptr = std::make_unique<char[]>(data_len);
-        ack_packet.size = data_len;
-        ack_packet.data_block_number = m_ack_block_num++;
-        memcpy(ack_packet.data_ptr.get(), &header, header_size);
-        memcpy(ack_packet.data_ptr.get() + header_size, &block, block_size);
+        ack_packet.data_ptr = std::make_unique<char[]>(data_begin);
+        ack_packet.size = encode_ack_packet(ack_packet.data_ptr.get(), block_number);
+        ack_packet.data_block_number = block_number;
         return ack_packet;
     }
 
+    packet_t TFTP::make_oack_packet(const transfer_options_t& options)
+    {
+        packet_t oack_packet;
+        oack_packet.data_ptr = std::make_unique<char[]>(TFTP_CONTROL_PACKET_LEN);
+        oack_packet.size = encode_oack_packet(oack_packet.data_ptr.get(), TFTP_CONTROL_PACKET_LEN, options);
+        oack_packet.data_block_number = 0;
+        return oack_packet;
+    }
+
+    bool TFTP::parse_request_options(const request_view_t& request,
+                                     transfer_options_t& options)
+    {
+        // The views of the request end right before their NUL.
+        if (option_name_equals(request.mode.data(), TRANSFER_MODE_NAME_OCTET))
+        {
+            options.mode = TRANSFER_MODE_OCTET;
+        }
+        else if (option_name_equals(request.mode.data(), TRANSFER_MODE_NAME_NETASCII))
+        {
+            options.mode = TRANSFER_MODE_NETASCII;
+        }
+        else
+        {
+            // The obsolete mail mode is refused like any unknown one.
+            return false;
+        }
+
+        if (!parse_options(request.options.data(),
+                           request.options.data() + request.options.size(), options))
+        {
+            return false;
+        }
+
+        if ((options.negotiated & OPTION_BLOCK_SIZE) != 0)
+        {
+            if (options.block_size < TFTP_MIN_BLOCK_SIZE)
+            {
+                options.negotiated &= ~OPTION_BLOCK_SIZE;
+                options.block_size = TFTP_DEFAULT_BLOCK_SIZE;
+            }
+            else if (options.block_size > TFTP_MAX_BLOCK_SIZE)
+            {
+                options.block_size = TFTP_MAX_BLOCK_SIZE;
+            }
+        }
+
+        if ((options.negotiated & OPTION_WINDOW_SIZE) != 0)
+        {
+            if (options.window_size < 1)
+            {
+                options.negotiated &= ~OPTION_WINDOW_SIZE;
+                options.window_size = TFTP_DEFAULT_WINDOW_SIZE;
+            }
+            else if (options.window_size > TFTP_MAX_WINDOW_SIZE)
+            {
+                options.window_size = TFTP_MAX_WINDOW_SIZE;
+            }
+        }
+
+        if ((options.negotiated & OPTION_TIMEOUT) != 0 &&
+            (options.timeout < TFTP_MIN_TIMEOUT_OPTION || options.timeout > TFTP_MAX_TIMEOUT_OPTION))
+        {
+            // RFC 2349 does not allow the server to pick another value.
+            options.negotiated &= ~OPTION_TIMEOUT;
+            options.timeout = 0;
+        }
+
+        if ((options.negotiated & OPTION_TRANSFER_SIZE) != 0 && options.transfer_size < 0)
+        {
+            options.negotiated &= ~OPTION_TRANSFER_SIZE;
+            options.transfer_size = 0;
+        }
+
+        if ((options.negotiated & OPTION_OFFSET) != 0 && options.offset < 0)
+        {
+            options.negotiated &= ~OPTION_OFFSET;
+            options.offset = 0;
+        }
+
+        if ((options.negotiated & OPTION_LENGTH) != 0 && options.length < 0)
+        {
+            options.negotiated &= ~OPTION_LENGTH;
+            options.length = 0;
+        }
+
+        if ((options.negotiated & OPTION_MODIFIED_TIME) != 0 &&
+            (options.modified_time < 0 || options.modified_time > TFTP_MAX_MODIFIED_TIME))
+        {
+            // Times past 2100 overflow the nanoseconds of the file clock.
+            options.negotiated &= ~OPTION_MODIFIED_TIME;
+            options.modified_time = 0;
+        }
+
+        if (options.mode == TRANSFER_MODE_NETASCII)
+        {
+            // Offsets into the translated stream have no place in the local file.
+            options.negotiated &= ~(OPTION_OFFSET | OPTION_LENGTH);
+            options.offset = 0;
+            options.length = 0;
+        }
+
+        // The digest only travels with the final ACK, the OACK echoes 0.
+        options.checksum = 0;
+
+        return true;
+    }
+
+    bool TFTP::parse_oack_packet(const char* packet, int packet_len,
+                                 transfer_options_t& options)
+    {
+        oack_view_t oack{};
+
+        if (!TFTPPacket::parse_oack(packet, packet_len, oack) ||
+            !parse_options(oack.options.data(), oack.options.data() + oack.options.size(), options))
+        {
+            return false;
+        }
+
+        return options.block_size >= TFTP_MIN_BLOCK_SIZE &&
+               options.block_size <= TFTP_MAX_BLOCK_SIZE &&
+               options.window_size >= 1 &&
+               options.window_size <= UINT16_MAX &&
+               ((options.negotiated & OPTION_TIMEOUT) == 0 ||
+                (options.timeout >= TFTP_MIN_TIMEOUT_OPTION &&
+                 options.timeout <= TFTP_MAX_TIMEOUT_OPTION)) &&
+               options.transfer_size >= 0 &&
+               options.offset >= 0 &&
+               options.length >= 0 &&
+               options.modified_time >= 0 &&
+               options.modified_time <= TFTP_MAX_MODIFIED_TIME;
+    }
+
     packet_t TFTP::make_error_packet()
     {
-        std::string err_msg = "Something went wrong between server and client.";
+        return make_error_packet(ERR_CODE_NOT_DEFINED, "Something went wrong between server and client.");
+    }
 
-        TFTP_header_t header{};
-        header.op_code = htons(OP_CODE_ERR);
-        TFTP_data_block_t block{};
-        block.data_block = htons(m_ack_block_num);
-        int header_size = sizeof(header);
-        int block_size = sizeof(block);
-        int data_len = header_size + block_size + err_msg.length() + 1;
+    packet_t TFTP::make_error_packet(int error_code, const std::string& error_message)
+    {
+        const int header_size = sizeof(error_header_t);
+        const int data_len = header_size + static_cast<int>(error_message.length()) + 1;
         packet_t error_packet;
         error_packet.data_ptr = std::make_unique<char[]>(data_len);
         error_packet.size = data_len;
-        error_packet.data_block_number = m_ack_block_num++;
-        memcpy(error_packet.data_ptr.get(), &header, header_size);
-        memcpy(error_packet.data_ptr.get() + header_size, &block, block_size);
-        memcpy(error_packet.data_ptr.get() + header_size + block_size, err_msg.c_str(), err_msg.length());
+        error_packet.data_block_number = -1;
+        encode_op_code(error_packet.data_ptr.get(), op_code::ERR);
+        encode_uint16(error_packet.data_ptr.get() + offsetof(error_header_t, error_code), error_code);
+        memcpy(error_packet.data_ptr.get() + header_size,
+               error_message.c_str(), error_message.length() + 1);
         return error_packet;
     }
 
-    void TFTP::reset_ack_data_block_num()
+    bool TFTP::read_modified_time(const std::string& file_path, int64_t& modified_time)
     {
-        m_ack_block_num = 1U;
+        std::error_code error;
+        const auto file_time = std::filesystem::last_write_time(file_path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        // The same instant reads the same on both hosts, whatever their file clock.
+        const auto system_time = std::chrono::file_clock::to_sys(file_time);
+        modified_time = std::chrono::duration_cast<std::chrono::nanoseconds>(system_time.time_since_epoch()).count();
+
+        // A time the peer would refuse is not worth offering.
+        return modified_time >= 0 && modified_time <= TFTP_MAX_MODIFIED_TIME;
     }
 
-    void TFTP::reset_data_block_num()
+    bool TFTP::write_modified_time(const std::string& file_path, int64_t modified_time)
     {
-        m_data_block_num = 1U;
+        if (modified_time < 0 || modified_time > TFTP_MAX_MODIFIED_TIME)
+        {
+            return false;
+        }
+
+        const std::chrono::sys_time<std::chrono::nanoseconds> system_time{std::chrono::nanoseconds(modified_time)};
+        const auto file_time = std::chrono::file_clock::from_sys(system_time);
+
+        std::error_code error;
+        std::filesystem::last_write_time(file_path,
+                                         std::chrono::time_point_cast<std::filesystem::file_time_type::duration>(file_time),
+                                         error);
+
+        return !error;
     }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Private Functions
 ////////////////////////////////////////////////////////////////////////////////
 
+    packet_t TFTP::make_request_packet(op_code code, const std::string& file_name,
+                                       const transfer_options_t& options)
+    {
+        const char* mode = options.mode == TRANSFER_MODE_NETASCII
+                           ? TRANSFER_MODE_NAME_NETASCII
+                           : TRANSFER_MODE_NAME_OCTET;
+        const int name_len = static_cast<int>(file_name.length()) + 1;
+        const int mode_len = static_cast<int>(strlen(mode)) + 1;
+        const int buffer_len = static_cast<int>(sizeof(op_header_t)) + name_len + mode_len + TFTP_CONTROL_PACKET_LEN;
+        packet_t request;
+        request.data_ptr = std::make_unique<char[]>(buffer_len);
+        request.data_block_number = -1;
+
+        char* cursor = request.data_ptr.get();
+        encode_op_code(cursor, code);
+        cursor += sizeof(op_header_t);
+        memcpy(cursor, file_name.c_str(), name_len);
+        cursor += name_len;
+        memcpy(cursor, mode, mode_len);
+        cursor += mode_len;
+
+        const int options_len = encode_options(options, cursor, TFTP_CONTROL_PACKET_LEN);
+        request.size = static_cast<int>(cursor - request.data_ptr.get()) + std::max(options_len, 0);
+        return request;
+    }
+
+    int TFTP::encode_options(const transfer_options_t& options, char* buffer, int buffer_len)
+    {
+        const struct
+        {
+            int flag;
+            const char* name;
+            int64_t value;
+        } pairs[] = {
+            {OPTION_BLOCK_SIZE, OPTION_NAME_BLOCK_SIZE, options.block_size},
+            {OPTION_WINDOW_SIZE, OPTION_NAME_WINDOW_SIZE, options.window_size},
+            {OPTION_TIMEOUT, OPTION_NAME_TIMEOUT, options.timeout},
+            {OPTION_TRANSFER_SIZE, OPTION_NAME_TRANSFER_SIZE, options.transfer_size},
+            {OPTION_CHECKSUM, OPTION_NAME_CHECKSUM, options.checksum},
+            {OPTION_ROLLOVER, OPTION_NAME_ROLLOVER, options.rollover},
+            {OPTION_OFFSET, OPTION_NAME_OFFSET, options.offset},
+            {OPTION_LENGTH, OPTION_NAME_LENGTH, options.length},
+            {OPTION_MODIFIED_TIME, OPTION_NAME_MODIFIED_TIME, options.modified_time},
+        };
+
+        int written = 0;
+
+        for (const auto& pair : pairs)
+        {
+            if ((options.negotiated & pair.flag) == 0)
+            {
+                continue;
+            }
+
+            const int pair_len = encode_option(pair.name, pair.value,
+                                               buffer + written, buffer_len - written);
+
+            if (pair_len < 0)
+            {
+                return -1;
+            }
+
+            written += pair_len;
+        }
+
+        return written;
+    }
+
+    int TFTP::encode_option(const char* name, int64_t value, char* buffer, int buffer_len)
+    {
+        // snprintf counts the NUL of the value out, the name brings its own.
+        const int name_len = static_cast<int>(strlen(name)) + 1;
+
+        if (name_len >= buffer_len)
+        {
+            return -1;
+        }
+
+        memcpy(buffer, name, name_len);
+
+        const int value_len = snprintf(buffer + name_len, buffer_len - name_len, "%lld",
+                                       static_cast<long long>(value));
+
+        if (value_len < 0 || value_len >= buffer_len - name_len)
+        {
+            return -1;
+        }
+
+        return name_len + value_len + 1;
+    }
+
+    void TFTP::encode_op_code(char* buffer, op_code code)
+    {
+        static_assert(offsetof(op_header_t, op_code) == 0, "Every header starts with the op code");
+
+        encode_uint16(buffer, static_cast<uint16_t>(code));
+    }
+
+    void TFTP::encode_uint16(char* buffer, int value)
+    {
+        const uint16_t network_value = htons(static_cast<uint16_t>(value));
+        memcpy(buffer, &network_value, sizeof(network_value));
+    }
+
+    bool TFTP::parse_options(const char* begin, const char* end,
+                             transfer_options_t& options)
+    {
+        const char* cursor = begin;
+
+        while (cursor < end)
+        {
+            const auto* name_end = static_cast<const char*>(memchr(cursor, '\0', end - cursor));
+
+            if (name_end == nullptr || name_end + 1 >= end)
+            {
+                return false;
+            }
+
+            const char* value = name_end + 1;
+            const auto* value_end = static_cast<const char*>(memchr(value, '\0', end - value));
+
+            if (value_end == nullptr)
+            {
+                return false;
+            }
+
+            long long number = 0;
+
+            if (option_name_equals(cursor, OPTION_NAME_BLOCK_SIZE))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                // Clamped before narrowing, a value below the minimum is still dropped later.
+                options.block_size = static_cast<int>(std::clamp<long long>(number, 0, TFTP_MAX_BLOCK_SIZE));
+                options.negotiated |= OPTION_BLOCK_SIZE;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_WINDOW_SIZE))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                options.window_size = static_cast<int>(std::clamp<long long>(number, 0, TFTP_MAX_WINDOW_SIZE));
+                options.negotiated |= OPTION_WINDOW_SIZE;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_TIMEOUT))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                // One past the limit keeps an invalid timeout invalid, RFC 2349 has no counter offer.
+                options.timeout = static_cast<int>(std::clamp<long long>(number, 0, TFTP_MAX_TIMEOUT_OPTION + 1));
+                options.negotiated |= OPTION_TIMEOUT;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_TRANSFER_SIZE))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                options.transfer_size = number;
+                options.negotiated |= OPTION_TRANSFER_SIZE;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_CHECKSUM))
+            {
+                if (!parse_number(value, value_end, number) || number < 0 || number > UINT32_MAX)
+                {
+                    return false;
+                }
+
+                options.checksum = static_cast<uint32_t>(number);
+                options.negotiated |= OPTION_CHECKSUM;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_ROLLOVER))
+            {
+                // Only 0 and 1 are defined, any other value leaves the option out.
+                if (parse_number(value, value_end, number) &&
+                    (number == ROLLOVER_POLICY_ZERO || number == ROLLOVER_POLICY_ONE))
+                {
+                    options.rollover = static_cast<rollover_policy_t>(number);
+                    options.negotiated |= OPTION_ROLLOVER;
+                }
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_OFFSET))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                options.offset = number;
+                options.negotiated |= OPTION_OFFSET;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_LENGTH))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                options.length = number;
+                options.negotiated |= OPTION_LENGTH;
+            }
+            else if (option_name_equals(cursor, OPTION_NAME_MODIFIED_TIME))
+            {
+                if (!parse_number(value, value_end, number))
+                {
+                    return false;
+                }
+
+                options.modified_time = number;
+                options.negotiated |= OPTION_MODIFIED_TIME;
+            }
+
+            // Unknown options are silently ignored as RFC 2347 requires.
+            cursor = value_end + 1;
+        }
+
+        return true;
+    }
+
+    bool TFTP::parse_number(const char* value, const char* value_end, long long& number)
+    {
+        // strtoll would skip blanks and stop at the first stray byte.
+        if (value == value_end || (*value != '-' && isdigit(static_cast<unsigned char>(*value)) == 0))
+        {
+            return false;
+        }
+
+        char* parsed_end = nullptr;
+        errno = 0;
+        number = strtoll(value, &parsed_end, 10);
+
+        return errno != ERANGE && parsed_end == value_end;
+    }
+
+    bool TFTP::option_name_equals(const char* name, const char* expected)
+    {
+        for (; *name != '\0' && *expected != '\0'; ++name, ++expected)
+        {
+            if (tolower(static_cast<unsigned char>(*name)) != *expected)
+            {
+                return false;
+            }
+        }
+
+        return *name == *expected;
+    }
+
 ////////////////////////////////////////////////////////////////////////////////
 // Protected Functions
 ////////////////////////////////////////////////////////////////////////////////
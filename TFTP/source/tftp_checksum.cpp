@@ -0,0 +1,179 @@
+///
+/// @file tftp_checksum.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the running payload checksum.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cstring>
+#include "tftp_checksum.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHECKSUM_X86_64
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define CHECKSUM_ARM
+#include <arm_acle.h>
+#endif
+
+// GCC and Clang build the SSE4.2 path alone and pick it at runtime, MSVC only
+// has it if the whole build targets AVX or later.
+#if defined(CHECKSUM_X86_64) && defined(__GNUC__)
+#define CHECKSUM_TARGET_SSE42 __attribute__((target("sse4.2")))
+#elif defined(CHECKSUM_X86_64) && (defined(__AVX__) || defined(__SSE4_2__))
+#define CHECKSUM_TARGET_SSE42
+#else
+#undef CHECKSUM_X86_64
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPChecksum::TFTPChecksum()
+        : m_crc{0xFFFFFFFFu},
+          m_hardware{is_hardware_accelerated()}
+    {
+    }
+
+    void TFTPChecksum::reset()
+    {
+        this->m_crc = 0xFFFFFFFFu;
+    }
+
+    void TFTPChecksum::resume(uint32_t value)
+    {
+        this->m_crc = ~value;
+    }
+
+    void TFTPChecksum::update(const char* data, size_t size)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+        this->m_crc = this->m_hardware
+                      ? update_hardware(this->m_crc, bytes, size)
+                      : update_table(this->m_crc, bytes, size);
+    }
+
+    uint32_t TFTPChecksum::get_value() const
+    {
+        return ~this->m_crc;
+    }
+
+    bool TFTPChecksum::is_hardware_accelerated()
+    {
+#if defined(CHECKSUM_X86_64) && defined(__GNUC__)
+        return __builtin_cpu_supports("sse4.2");
+#elif defined(CHECKSUM_X86_64) || defined(CHECKSUM_ARM)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    uint32_t TFTPChecksum::update_table(uint32_t crc, const unsigned char* data, size_t size)
+    {
+        static const std::array<uint32_t, 256> table = []
+        {
+            std::array<uint32_t, 256> entries{};
+
+            // Reflected Castagnoli polynomial.
+            for (uint32_t i = 0; i < entries.size(); ++i)
+            {
+                uint32_t entry = i;
+
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    entry = (entry >> 1) ^ ((entry & 1u) != 0 ? 0x82F63B78u : 0u);
+                }
+
+                entries[i] = entry;
+            }
+
+            return entries;
+        }();
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+        }
+
+        return crc;
+    }
+
+#if defined(CHECKSUM_X86_64)
+
+    CHECKSUM_TARGET_SSE42
+    uint32_t TFTPChecksum::update_hardware(uint32_t crc, const unsigned char* data, size_t size)
+    {
+        uint64_t crc64 = crc;
+
+        for (; size >= 8; data += 8, size -= 8)
+        {
+            uint64_t word{};
+            memcpy(&word, data, sizeof(word));
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+
+        crc = static_cast<uint32_t>(crc64);
+
+        for (; size > 0; ++data, --size)
+        {
+            crc = _mm_crc32_u8(crc, *data);
+        }
+
+        return crc;
+    }
+
+#elif defined(CHECKSUM_ARM)
+
+    uint32_t TFTPChecksum::update_hardware(uint32_t crc, const unsigned char* data, size_t size)
+    {
+        for (; size >= 8; data += 8, size -= 8)
+        {
+            uint64_t word{};
+            memcpy(&word, data, sizeof(word));
+            crc = __crc32cd(crc, word);
+        }
+
+        for (; size > 0; ++data, --size)
+        {
+            crc = __crc32cb(crc, *data);
+        }
+
+        return crc;
+    }
+
+#else
+
+    uint32_t TFTPChecksum::update_hardware(uint32_t crc, const unsigned char* data, size_t size)
+    {
+        return update_table(crc, data, size);
+    }
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
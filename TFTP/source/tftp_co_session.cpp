@@ -0,0 +1,647 @@
+///
+/// @file tftp_co_session.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPCoSession class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tftp.hpp"
+#include "tftp_co_session.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPCoSession::receive_awaiter::receive_awaiter(TFTPCoSession& session,
+                                                    data_view_t* data,
+                                                    ack_view_t* ack,
+                                                    TFTPRetransmitter::steady_clock_t::time_point deadline)
+        : m_session{session},
+          m_data{data},
+          m_ack{ack},
+          m_deadline{deadline}
+    {
+    }
+
+    bool TFTPCoSession::receive_awaiter::await_ready()
+    {
+        this->m_session.flush_packets();
+
+        return this->m_session.take_datagram();
+    }
+
+    void TFTPCoSession::receive_awaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        this->m_session.wait(handle, this->m_deadline);
+    }
+
+    receive_status_t TFTPCoSession::receive_awaiter::await_resume()
+    {
+        TFTPCoSession& session = this->m_session;
+
+        if (session.m_timed_out)
+        {
+            return RECEIVE_STATUS_TIMED_OUT;
+        }
+
+        if (TFTPPacket::parse_error(session.m_packet, session.m_packet_size, session.m_error))
+        {
+            return RECEIVE_STATUS_PEER_ERROR;
+        }
+
+        if (this->m_data != nullptr)
+        {
+            return TFTPPacket::parse_data(session.m_packet, session.m_packet_size, *this->m_data)
+                   ? RECEIVE_STATUS_OK
+                   : RECEIVE_STATUS_UNEXPECTED;
+        }
+
+        if (this->m_ack != nullptr)
+        {
+            return TFTPPacket::parse_ack(session.m_packet, session.m_packet_size, *this->m_ack)
+                   ? RECEIVE_STATUS_OK
+                   : RECEIVE_STATUS_UNEXPECTED;
+        }
+
+        return RECEIVE_STATUS_OK;
+    }
+
+    TFTPCoSession::owner_awaiter::owner_awaiter(TFTPCoSession& session)
+        : m_session{session}
+    {
+    }
+
+    bool TFTPCoSession::owner_awaiter::await_ready()
+    {
+        this->m_session.flush_packets();
+
+        return false;
+    }
+
+    void TFTPCoSession::owner_awaiter::await_suspend(std::coroutine_handle<> handle)
+    {
+        this->m_session.m_waiting_owner = true;
+        this->m_session.wait(handle, TFTPRetransmitter::steady_clock_t::now() +
+                                     std::chrono::milliseconds(TFTP_SESSION_IDLE_MS));
+    }
+
+    receive_status_t TFTPCoSession::owner_awaiter::await_resume()
+    {
+        return this->m_session.m_timed_out ? RECEIVE_STATUS_TIMED_OUT : RECEIVE_STATUS_OK;
+    }
+
+    TFTPCoSession::TFTPCoSession(TFTPReactor& reactor,
+                                 SOCKET socket,
+                                 const SOCKADDR_IN& peer,
+                                 bool peer_known,
+                                 transfer_role_t role,
+                                 int buffer_len,
+                                 int buffer_count,
+                                 const transfer_options_t& options,
+                                 int max_retries,
+                                 void* owner)
+        : m_reactor{reactor},
+          m_socket{socket},
+          m_peer{peer},
+          m_addr_size{sizeof(SOCKADDR_IN)},
+          m_peer_known{peer_known},
+          m_role{role},
+          m_owner{owner},
+          m_receive_batch{buffer_len, buffer_count},
+          m_batch_count{0},
+          m_batch_index{0},
+          m_send_batch{},
+          m_ack_queued{false},
+          m_session{},
+          m_retransmitter{},
+          m_request_packet{},
+          m_retransmissions{0},
+          m_packet{nullptr},
+          m_packet_size{0},
+          m_error{},
+          m_timed_out{false},
+          m_waiting{},
+          m_waiting_owner{false},
+          m_wait_deadline{},
+          m_timer{}
+    {
+        this->m_timer.context = this;
+        this->m_retransmitter.set_max_retries(max_retries);
+        this->set_options(options);
+        this->m_reactor.watch(*this);
+    }
+
+    TFTPCoSession::~TFTPCoSession()
+    {
+        this->m_reactor.unwatch(*this);
+    }
+
+    std::suspend_never TFTPCoSession::send_request(packet_t request)
+    {
+        this->m_request_packet = std::move(request);
+
+        (void)sendto(this->m_socket,
+                     this->m_request_packet.data_ptr.get(),
+                     this->m_request_packet.size,
+                     0,
+                     reinterpret_cast<const SOCKADDR*>(&this->m_peer),
+                     this->m_addr_size);
+
+        this->m_retransmitter.arm(TFTPRetransmitter::steady_clock_t::now());
+
+        return {};
+    }
+
+    std::suspend_never TFTPCoSession::send_ack()
+    {
+        const packet_view_t ack_packet = this->m_session.make_ack_packet();
+
+        // ACKs are cumulative and share one buffer, the newest one queued
+        // replaces the others of the same batch.
+        if (!this->m_ack_queued)
+        {
+            this->send_packet(ack_packet);
+            this->m_ack_queued = true;
+        }
+
+        this->m_retransmitter.arm(TFTPRetransmitter::steady_clock_t::now());
+
+        return {};
+    }
+
+    std::suspend_never TFTPCoSession::send_block(int data_len)
+    {
+        this->send_packet(this->m_session.commit_data_packet(data_len));
+        this->m_retransmitter.arm(TFTPRetransmitter::steady_clock_t::now());
+
+        return {};
+    }
+
+    std::suspend_never TFTPCoSession::send_block(const char* payload, int data_len)
+    {
+        this->send_packet(this->m_session.commit_data_packet(payload, data_len));
+        this->m_retransmitter.arm(TFTPRetransmitter::steady_clock_t::now());
+
+        return {};
+    }
+
+    std::suspend_never TFTPCoSession::send_oack()
+    {
+        this->send_packet(this->m_session.make_oack_packet());
+        this->m_retransmitter.arm(TFTPRetransmitter::steady_clock_t::now());
+
+        return {};
+    }
+
+    std::suspend_never TFTPCoSession::send_unsent_blocks()
+    {
+        while (this->m_session.is_window_open() && this->m_session.has_unsent_packet())
+        {
+            this->send_packet(this->m_session.next_unsent_packet());
+        }
+
+        this->m_retransmitter.arm(TFTPRetransmitter::steady_clock_t::now());
+
+        return {};
+    }
+
+    void TFTPCoSession::send_error(int error_code, const std::string& error_message)
+    {
+        const packet_t error_packet = TFTP::make_error_packet(error_code, error_message);
+
+        this->send_packet(packet_view_t{error_packet.data_ptr.get(), error_packet.size, -1});
+        this->flush_packets();
+    }
+
+    void TFTPCoSession::flush_packets()
+    {
+        if (!this->m_send_batch.is_empty())
+        {
+            (void)this->m_send_batch.flush(this->m_socket,
+                                           reinterpret_cast<const SOCKADDR*>(&this->m_peer),
+                                           this->m_addr_size);
+        }
+
+        this->m_ack_queued = false;
+    }
+
+    TFTPCoSession::receive_awaiter TFTPCoSession::recv_packet()
+    {
+        return receive_awaiter(*this, nullptr, nullptr, {});
+    }
+
+    TFTPCoSession::receive_awaiter TFTPCoSession::recv_block(data_view_t& data)
+    {
+        return receive_awaiter(*this, &data, nullptr, {});
+    }
+
+    TFTPCoSession::receive_awaiter TFTPCoSession::recv_ack(ack_view_t& ack)
+    {
+        return receive_awaiter(*this, nullptr, &ack, {});
+    }
+
+    TFTPCoSession::receive_awaiter TFTPCoSession::recv_block_until(data_view_t& data,
+                                                                   TFTPRetransmitter::steady_clock_t::time_point deadline)
+    {
+        return receive_awaiter(*this, &data, nullptr, deadline);
+    }
+
+    TFTPCoSession::owner_awaiter TFTPCoSession::wait_for_owner()
+    {
+        return owner_awaiter(*this);
+    }
+
+    bool TFTPCoSession::notify()
+    {
+        if (!this->m_waiting_owner)
+        {
+            return false;
+        }
+
+        this->resume();
+
+        return true;
+    }
+
+    bool TFTPCoSession::accept_ack(const ack_view_t& ack)
+    {
+        if (!this->m_session.accept_ack(ack.block_number))
+        {
+            // Duplicate or stale ACK, never answered to keep the Sorcerer's
+            // Apprentice away. Lost blocks are resent by the timer.
+            return false;
+        }
+
+        this->m_retransmitter.on_answer(TFTPRetransmitter::steady_clock_t::now());
+
+        return true;
+    }
+
+    data_verdict_t TFTPCoSession::accept_data(const data_view_t& data)
+    {
+        const data_verdict_t verdict
+            = this->m_session.accept_data(data.block_number, static_cast<int>(data.payload.size()));
+
+        if (verdict == DATA_VERDICT_STORE || verdict == DATA_VERDICT_STORE_AND_ACK)
+        {
+            const auto now = TFTPRetransmitter::steady_clock_t::now();
+
+            // The timer also runs inside a window, its loss is noticed without an ACK.
+            this->m_retransmitter.on_answer(now);
+            this->m_retransmitter.arm(now);
+        }
+
+        return verdict;
+    }
+
+    void TFTPCoSession::on_answer()
+    {
+        this->m_retransmitter.on_answer(TFTPRetransmitter::steady_clock_t::now());
+    }
+
+    void TFTPCoSession::set_options(const transfer_options_t& options)
+    {
+        this->m_session.get_options() = options;
+
+        if ((options.negotiated & OPTION_TIMEOUT) != 0)
+        {
+            this->m_retransmitter.set_fixed_timeout(options.timeout);
+        }
+    }
+
+    op_code TFTPCoSession::get_op_code() const
+    {
+        return TFTPPacket::get_op_code(this->m_packet, this->m_packet_size);
+    }
+
+    const char* TFTPCoSession::get_packet() const
+    {
+        return this->m_packet;
+    }
+
+    int TFTPCoSession::get_packet_size() const
+    {
+        return this->m_packet_size;
+    }
+
+    const error_view_t& TFTPCoSession::get_error() const
+    {
+        return this->m_error;
+    }
+
+    bool TFTPCoSession::is_peer_known() const
+    {
+        return this->m_peer_known;
+    }
+
+    TFTPSession& TFTPCoSession::get_session()
+    {
+        return this->m_session;
+    }
+
+    const TFTPRetransmitter& TFTPCoSession::get_retransmitter() const
+    {
+        return this->m_retransmitter;
+    }
+
+    int TFTPCoSession::get_retransmissions() const
+    {
+        return this->m_retransmissions;
+    }
+
+    SOCKET TFTPCoSession::get_socket() const
+    {
+        return this->m_socket;
+    }
+
+    TFTPTimingWheel::wheel_timer_t& TFTPCoSession::get_timer()
+    {
+        return this->m_timer;
+    }
+
+    void* TFTPCoSession::get_owner() const
+    {
+        return this->m_owner;
+    }
+
+    bool TFTPCoSession::on_readable()
+    {
+        if (!this->m_waiting)
+        {
+            return false;
+        }
+
+        // Every datagram waiting on the socket is taken with one call, the
+        // coroutine works through them before it suspends again. One which
+        // waits for the owner finds them at its next receive, what was left
+        // of an earlier batch is dropped like by a full socket buffer.
+        this->m_batch_count = this->m_receive_batch.receive(this->m_socket);
+        this->m_batch_index = 0;
+
+        if (this->m_waiting_owner || !this->take_datagram())
+        {
+            return false;
+        }
+
+        this->resume();
+
+        return true;
+    }
+
+    bool TFTPCoSession::on_datagram(const char* packet, int bytes,
+                                    const SOCKADDR_STORAGE_LH& sender, socklen_t sender_size)
+    {
+        if (!this->m_waiting)
+        {
+            return false;
+        }
+
+        if (!this->m_waiting_owner)
+        {
+            // Handled in place, the batch is empty while a receive waits.
+            if (!this->accept_datagram(packet, bytes, sender, sender_size))
+            {
+                return false;
+            }
+
+            this->resume();
+
+            return true;
+        }
+
+        if (this->m_batch_index == this->m_batch_count)
+        {
+            this->m_batch_index = 0;
+            this->m_batch_count = 0;
+        }
+
+        // The owner reuses its buffer, a full batch drops the datagram like a full socket buffer.
+        if (this->m_batch_count < this->m_receive_batch.get_capacity())
+        {
+            this->m_receive_batch.store(this->m_batch_count++, packet, bytes, sender, sender_size);
+        }
+
+        return false;
+    }
+
+    bool TFTPCoSession::on_timeout()
+    {
+        if (!this->m_waiting)
+        {
+            return false;
+        }
+
+        const auto now = TFTPRetransmitter::steady_clock_t::now();
+
+        if (this->m_wait_deadline != TFTPRetransmitter::steady_clock_t::time_point{})
+        {
+            if (now < this->m_wait_deadline)
+            {
+                this->m_reactor.schedule(this->m_timer, this->m_wait_deadline);
+                return false;
+            }
+
+            // An owner which stays silent fails the transfer, a receive with
+            // a deadline just ends.
+            if (this->m_waiting_owner)
+            {
+                this->send_error(ERR_CODE_NOT_DEFINED, "Transfer timed out");
+            }
+
+            this->m_timed_out = true;
+            this->resume();
+
+            return true;
+        }
+
+        if (this->m_retransmitter.is_armed() && !this->m_retransmitter.is_expired(now))
+        {
+            this->m_reactor.schedule(this->m_timer, this->m_retransmitter.get_deadline());
+            return false;
+        }
+
+        // Nothing is outstanding after the idle wait, or the retries ran out.
+        if (!this->m_retransmitter.is_armed() || !this->m_retransmitter.on_expired(now))
+        {
+            if (this->m_peer_known)
+            {
+                this->send_error(ERR_CODE_NOT_DEFINED, "Transfer timed out");
+            }
+
+            this->m_timed_out = true;
+            this->resume();
+
+            return true;
+        }
+
+        ++this->m_retransmissions;
+        this->retransmit();
+        this->flush_packets();
+        this->m_reactor.schedule(this->m_timer, this->m_retransmitter.get_deadline());
+
+        return false;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPCoSession::take_datagram()
+    {
+        while (this->m_batch_index < this->m_batch_count)
+        {
+            const int index = this->m_batch_index++;
+
+            if (this->accept_datagram(this->m_receive_batch.get_data(index),
+                                      this->m_receive_batch.get_size(index),
+                                      this->m_receive_batch.get_address(index),
+                                      this->m_receive_batch.get_address_size(index)))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool TFTPCoSession::accept_datagram(const char* packet, int bytes,
+                                        const SOCKADDR_STORAGE_LH& sender, socklen_t sender_size)
+    {
+        if (bytes < data_begin)
+        {
+            // Runt datagram, wait for the next one.
+            return false;
+        }
+
+        const auto* sender_in = reinterpret_cast<const SOCKADDR_IN*>(&sender);
+
+        if (!this->m_peer_known)
+        {
+            // The first answer fixes the transfer identifier of the peer.
+            this->m_peer = *sender_in;
+            this->m_peer_known = true;
+        }
+        else if (sender_in->sin_addr.s_addr != this->m_peer.sin_addr.s_addr ||
+                 sender_in->sin_port != this->m_peer.sin_port)
+        {
+            this->send_unknown_tid_packet(sender, sender_size);
+            return false;
+        }
+
+        this->m_packet = packet;
+        this->m_packet_size = bytes;
+
+        return true;
+    }
+
+    void TFTPCoSession::wait(std::coroutine_handle<> handle,
+                             TFTPRetransmitter::steady_clock_t::time_point deadline)
+    {
+        this->m_waiting = handle;
+        this->m_wait_deadline = deadline;
+        this->m_timed_out = false;
+
+        if (deadline != TFTPRetransmitter::steady_clock_t::time_point{})
+        {
+            this->m_reactor.schedule(this->m_timer, deadline);
+            return;
+        }
+
+        // An idle receiver still gives up once the peer stays silent.
+        this->m_reactor.schedule(this->m_timer,
+                                 this->m_retransmitter.is_armed()
+                                 ? this->m_retransmitter.get_deadline()
+                                 : TFTPRetransmitter::steady_clock_t::now() +
+                                   std::chrono::milliseconds(TFTP_SESSION_IDLE_MS));
+    }
+
+    void TFTPCoSession::resume()
+    {
+        const std::coroutine_handle<> handle = this->m_waiting;
+
+        this->m_waiting = nullptr;
+        this->m_waiting_owner = false;
+        this->m_wait_deadline = TFTPRetransmitter::steady_clock_t::time_point{};
+        this->m_reactor.cancel(this->m_timer);
+
+        handle.resume();
+    }
+
+    void TFTPCoSession::retransmit()
+    {
+        if (!this->m_peer_known)
+        {
+            // The request or the first answer got lost.
+            (void)sendto(this->m_socket,
+                         this->m_request_packet.data_ptr.get(),
+                         this->m_request_packet.size,
+                         0,
+                         reinterpret_cast<const SOCKADDR*>(&this->m_peer),
+                         this->m_addr_size);
+            return;
+        }
+
+        if (this->m_role == TRANSFER_ROLE_SENDER)
+        {
+            this->m_session.rewind_window();
+
+            if (this->m_session.has_unsent_packet())
+            {
+                (void)this->send_unsent_blocks();
+                return;
+            }
+        }
+        else if (this->m_session.has_unacked_data())
+        {
+            // The peer lost a part of the window, the blocks received are
+            // acknowledged so the rest is resent.
+            (void)this->send_ack();
+            return;
+        }
+
+        // Our last ACK or OACK got lost.
+        this->send_packet(this->m_session.get_last_packet());
+    }
+
+    void TFTPCoSession::send_packet(const packet_view_t& packet)
+    {
+        if (!this->m_send_batch.queue(packet))
+        {
+            this->flush_packets();
+            (void)this->m_send_batch.queue(packet);
+        }
+    }
+
+    void TFTPCoSession::send_unknown_tid_packet(const SOCKADDR_STORAGE_LH& address,
+                                                socklen_t address_size)
+    {
+        packet_t error_packet = TFTP::make_error_packet(ERR_CODE_UNKNOWN_TID,
+                                                        "Unknown transfer ID");
+
+        (void)sendto(this->m_socket,
+                     error_packet.data_ptr.get(),
+                     error_packet.size,
+                     0,
+                     reinterpret_cast<const SOCKADDR*>(&address),
+                     address_size);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,244 @@
+///
+/// @file tftp_mapped_file.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the read-only memory mapped view of a file.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "tftp_mapped_file.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+
+    TFTPMappedFile::TFTPMappedFile()
+        : m_data{nullptr},
+          m_size{0},
+          m_open{false},
+          m_parent{nullptr}
+    {
+    }
+
+    TFTPMappedFile::~TFTPMappedFile()
+    {
+        this->close();
+    }
+
+    bool TFTPMappedFile::open(const std::string& file_path, bool sequential)
+    {
+        this->close();
+
+        const int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat file_stat{};
+
+        if (fstat(fd, &file_stat) < 0 || !S_ISREG(file_stat.st_mode))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        this->m_size = static_cast<size_t>(file_stat.st_size);
+
+        // mmap refuses empty mappings, an empty file is served without one.
+        if (this->m_size != 0)
+        {
+            void* data = mmap(nullptr, this->m_size, PROT_READ, MAP_SHARED, fd, 0);
+
+            if (data == MAP_FAILED)
+            {
+                ::close(fd);
+                this->m_size = 0;
+                return false;
+            }
+
+            if (sequential)
+            {
+                // Blocks are sent front to back, let the kernel read ahead.
+                (void)madvise(data, this->m_size, MADV_SEQUENTIAL);
+            }
+
+            this->m_data = static_cast<const char*>(data);
+        }
+
+        // The mapping keeps the file alive on its own.
+        ::close(fd);
+        this->m_open = true;
+
+        return true;
+    }
+
+    void TFTPMappedFile::close()
+    {
+        if (this->m_data != nullptr && this->m_parent == nullptr)
+        {
+            munmap(const_cast<char*>(this->m_data), this->m_size);
+        }
+
+        this->m_data = nullptr;
+        this->m_size = 0;
+        this->m_open = false;
+        this->m_parent.reset();
+    }
+
+#else
+
+    TFTPMappedFile::TFTPMappedFile()
+        : m_data{nullptr},
+          m_size{0},
+          m_open{false},
+          m_parent{nullptr},
+          m_file{INVALID_HANDLE_VALUE},
+          m_mapping{nullptr}
+    {
+    }
+
+    TFTPMappedFile::~TFTPMappedFile()
+    {
+        this->close();
+    }
+
+    bool TFTPMappedFile::open(const std::string& file_path, bool sequential)
+    {
+        this->close();
+
+        this->m_file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS,
+                                   nullptr);
+
+        LARGE_INTEGER file_size{};
+
+        if (this->m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(static_cast<HANDLE>(this->m_file), &file_size))
+        {
+            this->close();
+            return false;
+        }
+
+        this->m_size = static_cast<size_t>(file_size.QuadPart);
+
+        // File mappings of empty files fail, an empty file is served without one.
+        if (this->m_size != 0)
+        {
+            this->m_mapping = CreateFileMappingA(static_cast<HANDLE>(this->m_file), nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+            if (this->m_mapping == nullptr)
+            {
+                this->close();
+                return false;
+            }
+
+            this->m_data = static_cast<const char*>(MapViewOfFile(static_cast<HANDLE>(this->m_mapping), FILE_MAP_READ, 0, 0, 0));
+
+            if (this->m_data == nullptr)
+            {
+                this->close();
+                return false;
+            }
+        }
+
+        this->m_open = true;
+
+        return true;
+    }
+
+    void TFTPMappedFile::close()
+    {
+        if (this->m_data != nullptr && this->m_parent == nullptr)
+        {
+            UnmapViewOfFile(this->m_data);
+        }
+
+        if (this->m_mapping != nullptr)
+        {
+            CloseHandle(static_cast<HANDLE>(this->m_mapping));
+        }
+
+        if (this->m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(static_cast<HANDLE>(this->m_file));
+        }
+
+        this->m_data = nullptr;
+        this->m_size = 0;
+        this->m_open = false;
+        this->m_mapping = nullptr;
+        this->m_file = INVALID_HANDLE_VALUE;
+        this->m_parent.reset();
+    }
+
+#endif
+
+    bool TFTPMappedFile::open_slice(std::shared_ptr<const TFTPMappedFile> parent, size_t offset, size_t size)
+    {
+        this->close();
+
+        if (parent == nullptr || !parent->is_open() ||
+            offset > parent->get_size() || size > parent->get_size() - offset)
+        {
+            return false;
+        }
+
+        this->m_data = size != 0 ? parent->get_data() + offset : nullptr;
+        this->m_size = size;
+        this->m_parent = std::move(parent);
+        this->m_open = true;
+
+        return true;
+    }
+
+    bool TFTPMappedFile::is_open() const
+    {
+        return this->m_open;
+    }
+
+    const char* TFTPMappedFile::get_data() const
+    {
+        return this->m_data;
+    }
+
+    size_t TFTPMappedFile::get_size() const
+    {
+        return this->m_size;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,476 @@
+///
+/// @file tftp_netascii.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the netascii translation.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include "tftp_netascii.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define NETASCII_X86
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// GCC and Clang build the vector kernels for their instruction set alone and
+// pick one at runtime, MSVC only has AVX2 if the whole build targets it.
+#if defined(NETASCII_X86) && defined(__GNUC__)
+#define NETASCII_TARGET_SSE2 __attribute__((target("sse2")))
+#define NETASCII_TARGET_AVX2 __attribute__((target("avx2")))
+#define NETASCII_AVX2
+#elif defined(NETASCII_X86)
+#define NETASCII_TARGET_SSE2
+#define NETASCII_TARGET_AVX2
+#ifdef __AVX2__
+#define NETASCII_AVX2
+#endif
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPNetascii::TFTPNetascii(netascii_kernel_t kernel)
+        : m_kernel{std::min(kernel, get_best_kernel())},
+          m_pending_byte{0},
+          m_has_pending_byte{false},
+          m_pending_cr{false},
+          m_staging{},
+          m_staged_offset{0},
+          m_staged_size{0}
+    {
+    }
+
+    netascii_kernel_t TFTPNetascii::get_best_kernel()
+    {
+#if defined(NETASCII_AVX2) && defined(__GNUC__)
+        return __builtin_cpu_supports("avx2") ? NETASCII_KERNEL_AVX2 : NETASCII_KERNEL_SSE2;
+#elif defined(NETASCII_AVX2)
+        return NETASCII_KERNEL_AVX2;
+#elif defined(NETASCII_X86) && defined(__GNUC__)
+        return __builtin_cpu_supports("sse2") ? NETASCII_KERNEL_SSE2 : NETASCII_KERNEL_SCALAR;
+#elif defined(NETASCII_X86)
+        return NETASCII_KERNEL_SSE2;
+#else
+        return NETASCII_KERNEL_SCALAR;
+#endif
+    }
+
+    netascii_kernel_t TFTPNetascii::get_kernel() const
+    {
+        return this->m_kernel;
+    }
+
+    void TFTPNetascii::reset()
+    {
+        this->m_has_pending_byte = false;
+        this->m_pending_cr = false;
+        this->m_staged_offset = 0;
+        this->m_staged_size = 0;
+    }
+
+    int TFTPNetascii::encode(const char* input, size_t input_size, size_t& consumed,
+                             char* output, int output_size)
+    {
+        const char* in = input;
+        const char* in_end = input + input_size;
+        char* out = output;
+        char* out_end = output + output_size;
+
+        if (this->m_has_pending_byte && out < out_end)
+        {
+            *out++ = this->m_pending_byte;
+            this->m_has_pending_byte = false;
+        }
+
+        switch (this->m_kernel)
+        {
+#ifdef NETASCII_AVX2
+        case NETASCII_KERNEL_AVX2:
+            encode_avx2(in, in_end, out, out_end);
+            // The tail shorter than an AVX2 vector may still fill SSE2 ones.
+            [[fallthrough]];
+#endif
+#ifdef NETASCII_X86
+        case NETASCII_KERNEL_SSE2:
+            encode_sse2(in, in_end, out, out_end);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        this->encode_scalar(in, in_end, out, out_end);
+
+        consumed = static_cast<size_t>(in - input);
+        return static_cast<int>(out - output);
+    }
+
+    int TFTPNetascii::encode_block(std::istream& file, char* block, int block_size)
+    {
+        if (this->m_staging.size() < static_cast<size_t>(block_size))
+        {
+            this->m_staging.resize(block_size);
+        }
+
+        int produced = 0;
+
+        while (produced < block_size)
+        {
+            if (this->m_staged_offset == this->m_staged_size && file.good())
+            {
+                file.read(this->m_staging.data(), static_cast<std::streamsize>(this->m_staging.size()));
+                this->m_staged_offset = 0;
+                this->m_staged_size = static_cast<size_t>(file.gcount());
+            }
+
+            const size_t available = this->m_staged_size - this->m_staged_offset;
+
+            if (available == 0 && !this->m_has_pending_byte)
+            {
+                break;
+            }
+
+            size_t consumed = 0;
+
+            produced += this->encode(this->m_staging.data() + this->m_staged_offset, available, consumed,
+                                     block + produced, block_size - produced);
+            this->m_staged_offset += consumed;
+        }
+
+        return produced;
+    }
+
+    bool TFTPNetascii::has_pending() const
+    {
+        return this->m_has_pending_byte;
+    }
+
+    int TFTPNetascii::decode(const char* input, size_t input_size, char* output)
+    {
+        const char* in = input;
+        const char* in_end = input + input_size;
+        char* out = output;
+
+        if (this->m_pending_cr && in < in_end)
+        {
+            // The CR ended the previous block, its pair starts this one.
+            this->m_pending_cr = false;
+
+            if (*in == '\n' || *in == '\0')
+            {
+                *out++ = *in++ == '\n' ? '\n' : '\r';
+            }
+            else
+            {
+                *out++ = '\r';
+            }
+        }
+
+        switch (this->m_kernel)
+        {
+#ifdef NETASCII_AVX2
+        case NETASCII_KERNEL_AVX2:
+            decode_avx2(in, in_end, out);
+            [[fallthrough]];
+#endif
+#ifdef NETASCII_X86
+        case NETASCII_KERNEL_SSE2:
+            decode_sse2(in, in_end, out);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        this->decode_scalar(in, in_end, out);
+
+        return static_cast<int>(out - output);
+    }
+
+    int TFTPNetascii::finish_decode(char* output)
+    {
+        if (!this->m_pending_cr)
+        {
+            return 0;
+        }
+
+        // A CR without its pair breaks netascii, keeping it loses nothing.
+        this->m_pending_cr = false;
+        *output = '\r';
+        return 1;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPNetascii::encode_scalar(const char*& input, const char* input_end,
+                                     char*& output, char* output_end)
+    {
+        while (input < input_end && output < output_end)
+        {
+            const char byte = *input++;
+
+            if (byte != '\n' && byte != '\r')
+            {
+                *output++ = byte;
+                continue;
+            }
+
+            *output++ = '\r';
+
+            const char second = byte == '\n' ? '\n' : '\0';
+
+            if (output == output_end)
+            {
+                this->m_pending_byte = second;
+                this->m_has_pending_byte = true;
+                return;
+            }
+
+            *output++ = second;
+        }
+    }
+
+    void TFTPNetascii::decode_scalar(const char*& input, const char* input_end, char*& output)
+    {
+        while (input < input_end)
+        {
+            const char byte = *input++;
+
+            if (byte != '\r')
+            {
+                *output++ = byte;
+                continue;
+            }
+
+            if (input == input_end)
+            {
+                this->m_pending_cr = true;
+                return;
+            }
+
+            if (*input == '\n' || *input == '\0')
+            {
+                *output++ = *input++ == '\n' ? '\n' : '\r';
+            }
+            else
+            {
+                // A CR followed by anything else is kept, the byte is decoded on its own.
+                *output++ = '\r';
+            }
+        }
+    }
+
+#ifdef NETASCII_X86
+
+    NETASCII_TARGET_SSE2
+    void TFTPNetascii::encode_sse2(const char*& input, const char* input_end,
+                                   char*& output, char* output_end)
+    {
+        const __m128i line_feed = _mm_set1_epi8('\n');
+        const __m128i carriage_return = _mm_set1_epi8('\r');
+
+        // The vector is stored whole, the bytes after a line end are overwritten.
+        while (input_end - input >= 16 && output_end - output >= 18)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, line_feed), _mm_cmpeq_epi8(bytes, carriage_return))));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), bytes);
+
+            if (mask == 0)
+            {
+                input += 16;
+                output += 16;
+                continue;
+            }
+
+            const int plain = first_set_bit(mask);
+
+            input += plain;
+            output += plain;
+            output[0] = '\r';
+            output[1] = *input++ == '\n' ? '\n' : '\0';
+            output += 2;
+        }
+    }
+
+    NETASCII_TARGET_SSE2
+    void TFTPNetascii::decode_sse2(const char*& input, const char* input_end, char*& output)
+    {
+        const __m128i carriage_return = _mm_set1_epi8('\r');
+
+        // One byte more than a vector, the pair of a CR is always in the input.
+        while (input_end - input > 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, carriage_return)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), bytes);
+
+            if (mask == 0)
+            {
+                input += 16;
+                output += 16;
+                continue;
+            }
+
+            const int plain = first_set_bit(mask);
+
+            input += plain + 1;
+            output += plain;
+
+            if (*input == '\n' || *input == '\0')
+            {
+                *output++ = *input++ == '\n' ? '\n' : '\r';
+            }
+            else
+            {
+                *output++ = '\r';
+            }
+        }
+    }
+
+#else
+
+    void TFTPNetascii::encode_sse2(const char*& input, const char* input_end,
+                                   char*& output, char* output_end)
+    {
+        (void)input;
+        (void)input_end;
+        (void)output;
+        (void)output_end;
+    }
+
+    void TFTPNetascii::decode_sse2(const char*& input, const char* input_end, char*& output)
+    {
+        (void)input;
+        (void)input_end;
+        (void)output;
+    }
+
+#endif
+
+#ifdef NETASCII_AVX2
+
+    NETASCII_TARGET_AVX2
+    void TFTPNetascii::encode_avx2(const char*& input, const char* input_end,
+                                   char*& output, char* output_end)
+    {
+        const __m256i line_feed = _mm256_set1_epi8('\n');
+        const __m256i carriage_return = _mm256_set1_epi8('\r');
+
+        while (input_end - input >= 32 && output_end - output >= 34)
+        {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(bytes, line_feed), _mm256_cmpeq_epi8(bytes, carriage_return))));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), bytes);
+
+            if (mask == 0)
+            {
+                input += 32;
+                output += 32;
+                continue;
+            }
+
+            const int plain = first_set_bit(mask);
+
+            input += plain;
+            output += plain;
+            output[0] = '\r';
+            output[1] = *input++ == '\n' ? '\n' : '\0';
+            output += 2;
+        }
+    }
+
+    NETASCII_TARGET_AVX2
+    void TFTPNetascii::decode_avx2(const char*& input, const char* input_end, char*& output)
+    {
+        const __m256i carriage_return = _mm256_set1_epi8('\r');
+
+        while (input_end - input > 32)
+        {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, carriage_return)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), bytes);
+
+            if (mask == 0)
+            {
+                input += 32;
+                output += 32;
+                continue;
+            }
+
+            const int plain = first_set_bit(mask);
+
+            input += plain + 1;
+            output += plain;
+
+            if (*input == '\n' || *input == '\0')
+            {
+                *output++ = *input++ == '\n' ? '\n' : '\r';
+            }
+            else
+            {
+                *output++ = '\r';
+            }
+        }
+    }
+
+#else
+
+    void TFTPNetascii::encode_avx2(const char*& input, const char* input_end,
+                                   char*& output, char* output_end)
+    {
+        encode_sse2(input, input_end, output, output_end);
+    }
+
+    void TFTPNetascii::decode_avx2(const char*& input, const char* input_end, char*& output)
+    {
+        decode_sse2(input, input_end, output);
+    }
+
+#endif
+
+    int TFTPNetascii::first_set_bit(uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
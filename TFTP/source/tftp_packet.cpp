@@ -0,0 +1,139 @@
+///
+/// @file tftp_packet.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for parsing received TFTP packets in place.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tftp_packet.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    op_code TFTPPacket::get_op_code(const char* packet, int packet_len)
+    {
+        if (packet == nullptr || packet_len < static_cast<int>(sizeof(op_header_t)))
+        {
+            return op_code::NONE;
+        }
+
+        return static_cast<op_code>(read_field<op_header_t, offsetof(op_header_t, op_code)>(packet));
+    }
+
+    bool TFTPPacket::parse_request(const char* packet, int packet_len, request_view_t& request)
+    {
+        if (has_header<op_header_t>(packet, packet_len, op_code::RRQ))
+        {
+            request.transfer_type = TRANSFER_TYPE_RRQ;
+        }
+        else if (has_header<op_header_t>(packet, packet_len, op_code::WRQ))
+        {
+            request.transfer_type = TRANSFER_TYPE_WRQ;
+        }
+        else
+        {
+            return false;
+        }
+
+        std::string_view rest = read_body<op_header_t>(packet, packet_len);
+
+        // A request without a file name names nothing to transfer.
+        if (!take_field(rest, request.file_name) ||
+            request.file_name.empty() ||
+            !take_field(rest, request.mode))
+        {
+            return false;
+        }
+
+        request.options = rest;
+        return true;
+    }
+
+    bool TFTPPacket::parse_data(const char* packet, int packet_len, data_view_t& data)
+    {
+        if (!has_header<block_header_t>(packet, packet_len, op_code::DATA))
+        {
+            return false;
+        }
+
+        data.block_number = read_field<block_header_t, offsetof(block_header_t, block_number)>(packet);
+        data.payload = read_body<block_header_t>(packet, packet_len);
+        return true;
+    }
+
+    bool TFTPPacket::parse_ack(const char* packet, int packet_len, ack_view_t& ack)
+    {
+        if (!has_header<block_header_t>(packet, packet_len, op_code::ACK))
+        {
+            return false;
+        }
+
+        ack.block_number = read_field<block_header_t, offsetof(block_header_t, block_number)>(packet);
+        ack.options = read_body<block_header_t>(packet, packet_len);
+        return true;
+    }
+
+    bool TFTPPacket::parse_error(const char* packet, int packet_len, error_view_t& error)
+    {
+        if (!has_header<error_header_t>(packet, packet_len, op_code::ERR))
+        {
+            return false;
+        }
+
+        error.error_code = read_field<error_header_t, offsetof(error_header_t, error_code)>(packet);
+        error.message = read_body<error_header_t>(packet, packet_len);
+
+        // Some peers leave the NUL out, the message then ends with the datagram.
+        error.message = error.message.substr(0, error.message.find('\0'));
+        return true;
+    }
+
+    bool TFTPPacket::parse_oack(const char* packet, int packet_len, oack_view_t& oack)
+    {
+        if (!has_header<op_header_t>(packet, packet_len, op_code::OACK))
+        {
+            return false;
+        }
+
+        oack.options = read_body<op_header_t>(packet, packet_len);
+        return true;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPPacket::take_field(std::string_view& rest, std::string_view& field)
+    {
+        const size_t terminator = rest.find('\0');
+
+        if (terminator == std::string_view::npos)
+        {
+            return false;
+        }
+
+        field = rest.substr(0, terminator);
+        rest.remove_prefix(terminator + 1);
+        return true;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
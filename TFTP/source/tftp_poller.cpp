@@ -0,0 +1,171 @@
+///
+/// @file tftp_poller.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the socket readiness poller.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+#include <stdexcept>
+#include "tftp_poller.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+
+    TFTPPoller::TFTPPoller()
+        : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)},
+          m_epoll_events(256)
+    {
+        if (this->m_epoll_fd < 0)
+        {
+            throw std::runtime_error("Error at epoll creation. Error code: " +
+                                     GET_LAST_ERROR());
+        }
+    }
+
+    TFTPPoller::~TFTPPoller()
+    {
+        close(this->m_epoll_fd);
+    }
+
+    void TFTPPoller::add(SOCKET socket, void* context)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = context;
+
+        if (epoll_ctl(this->m_epoll_fd, EPOLL_CTL_ADD, socket, &event) < 0)
+        {
+            throw std::runtime_error("Error at epoll registration. Error code: " +
+                                     GET_LAST_ERROR());
+        }
+    }
+
+    void TFTPPoller::remove(SOCKET socket)
+    {
+        (void)epoll_ctl(this->m_epoll_fd, EPOLL_CTL_DEL, socket, nullptr);
+    }
+
+    int TFTPPoller::wait(std::vector<void*>& ready_contexts, int timeout_ms)
+    {
+        ready_contexts.clear();
+
+        const int count = epoll_wait(this->m_epoll_fd,
+                                     this->m_epoll_events.data(),
+                                     static_cast<int>(this->m_epoll_events.size()),
+                                     timeout_ms);
+
+        for (int i = 0; i < count; ++i)
+        {
+            ready_contexts.push_back(this->m_epoll_events[i].data.ptr);
+        }
+
+        return count < 0 ? 0 : count;
+    }
+
+    void TFTPPoller::set_non_blocking(SOCKET socket)
+    {
+        const int flags = fcntl(socket, F_GETFL, 0);
+        (void)fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+    }
+
+#else
+
+    TFTPPoller::TFTPPoller() = default;
+
+    TFTPPoller::~TFTPPoller() = default;
+
+    void TFTPPoller::add(SOCKET socket, void* context)
+    {
+        WSAPOLLFD poll_fd{};
+        poll_fd.fd = socket;
+        poll_fd.events = POLLRDNORM;
+
+        this->m_indices[socket] = this->m_poll_fds.size();
+        this->m_poll_fds.push_back(poll_fd);
+        this->m_contexts.push_back(context);
+    }
+
+    void TFTPPoller::remove(SOCKET socket)
+    {
+        const auto it = this->m_indices.find(socket);
+
+        if (it == this->m_indices.end())
+        {
+            return;
+        }
+
+        const size_t index = it->second;
+        const size_t last = this->m_poll_fds.size() - 1;
+
+        this->m_poll_fds[index] = this->m_poll_fds[last];
+        this->m_contexts[index] = this->m_contexts[last];
+        this->m_indices[this->m_poll_fds[index].fd] = index;
+
+        this->m_poll_fds.pop_back();
+        this->m_contexts.pop_back();
+        this->m_indices.erase(it);
+    }
+
+    int TFTPPoller::wait(std::vector<void*>& ready_contexts, int timeout_ms)
+    {
+        ready_contexts.clear();
+
+        if (this->m_poll_fds.empty())
+        {
+            Sleep(timeout_ms < 0 ? 0 : timeout_ms);
+            return 0;
+        }
+
+        const int count = WSAPoll(this->m_poll_fds.data(),
+                                  static_cast<ULONG>(this->m_poll_fds.size()),
+                                  timeout_ms);
+
+        for (size_t i = 0; i < this->m_poll_fds.size() && count > 0; ++i)
+        {
+            if (this->m_poll_fds[i].revents != 0)
+            {
+                ready_contexts.push_back(this->m_contexts[i]);
+            }
+        }
+
+        return static_cast<int>(ready_contexts.size());
+    }
+
+    void TFTPPoller::set_non_blocking(SOCKET socket)
+    {
+        u_long mode = 1;
+        (void)ioctlsocket(socket, FIONBIO, &mode);
+    }
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
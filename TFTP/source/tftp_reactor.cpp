@@ -0,0 +1,181 @@
+///
+/// @file tftp_reactor.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPReactor class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "tftp_reactor.hpp"
+#include "tftp_co_session.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPReactor::TFTPReactor(bool poll_sockets)
+        : m_poller(new TFTPPoller()),
+          m_timers(new TFTPTimingWheel()),
+          m_ready_contexts{},
+          m_ready_sockets{},
+          m_sockets{},
+          m_expired_timers{},
+          m_session_count{0},
+          m_poll_sockets{poll_sockets}
+    {
+    }
+
+    void TFTPReactor::watch(TFTPCoSession& session)
+    {
+        if (this->m_poll_sockets)
+        {
+            this->m_poller->add(session.get_socket(), &session);
+        }
+
+        ++this->m_session_count;
+    }
+
+    void TFTPReactor::unwatch(TFTPCoSession& session)
+    {
+        this->m_timers->cancel(session.get_timer());
+
+        if (this->m_poll_sockets)
+        {
+            this->m_poller->remove(session.get_socket());
+        }
+
+        --this->m_session_count;
+    }
+
+    void TFTPReactor::watch_socket(SOCKET socket, void* context)
+    {
+        this->m_poller->add(socket, context);
+        this->m_sockets.emplace_back(socket, context);
+    }
+
+    void TFTPReactor::unwatch_socket(SOCKET socket)
+    {
+        this->m_poller->remove(socket);
+        this->m_sockets.erase(std::find_if(this->m_sockets.begin(), this->m_sockets.end(),
+                                           [socket](const std::pair<SOCKET, void*>& watched)
+                                           {
+                                               return watched.first == socket;
+                                           }));
+    }
+
+    void TFTPReactor::schedule(TFTPTimingWheel::wheel_timer_t& timer,
+                               TFTPTimingWheel::steady_clock_t::time_point deadline)
+    {
+        this->m_timers->schedule(timer, deadline);
+    }
+
+    void TFTPReactor::cancel(TFTPTimingWheel::wheel_timer_t& timer)
+    {
+        this->m_timers->cancel(timer);
+    }
+
+    int TFTPReactor::poll(int timeout_ms, std::vector<void*>& resumed)
+    {
+        return this->poll(timeout_ms, resumed, this->m_ready_sockets);
+    }
+
+    int TFTPReactor::poll(int timeout_ms, std::vector<void*>& resumed, std::vector<void*>& ready)
+    {
+        resumed.clear();
+        ready.clear();
+
+        const int deadline_ms = this->next_timeout_ms();
+
+        if (timeout_ms < 0 || (deadline_ms >= 0 && deadline_ms < timeout_ms))
+        {
+            timeout_ms = deadline_ms;
+        }
+
+        (void)this->m_poller->wait(this->m_ready_contexts, timeout_ms);
+
+        for (void* context : this->m_ready_contexts)
+        {
+            // Only a few sockets belong to no session, a listening one for instance.
+            if (std::find_if(this->m_sockets.begin(), this->m_sockets.end(),
+                             [context](const std::pair<SOCKET, void*>& watched)
+                             {
+                                 return watched.second == context;
+                             }) != this->m_sockets.end())
+            {
+                ready.push_back(context);
+                continue;
+            }
+
+            auto* session = static_cast<TFTPCoSession*>(context);
+            void* owner = session->get_owner();
+
+            // The coroutine may run to its end, the session is not touched after.
+            if (session->on_readable())
+            {
+                resumed.push_back(owner);
+            }
+        }
+
+        this->resume_expired(resumed);
+
+        return static_cast<int>(resumed.size());
+    }
+
+    int TFTPReactor::expire(std::vector<void*>& resumed)
+    {
+        resumed.clear();
+        this->resume_expired(resumed);
+
+        return static_cast<int>(resumed.size());
+    }
+
+    int TFTPReactor::next_timeout_ms() const
+    {
+        return this->m_timers->next_timeout_ms(TFTPTimingWheel::steady_clock_t::now());
+    }
+
+    size_t TFTPReactor::get_session_count() const
+    {
+        return this->m_session_count;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPReactor::resume_expired(std::vector<void*>& resumed)
+    {
+        // Only the sessions whose deadline has passed are visited.
+        this->m_timers->advance(TFTPTimingWheel::steady_clock_t::now(), this->m_expired_timers);
+
+        for (void* context : this->m_expired_timers)
+        {
+            auto* session = static_cast<TFTPCoSession*>(context);
+            void* owner = session->get_owner();
+
+            if (session->on_timeout())
+            {
+                resumed.push_back(owner);
+            }
+        }
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
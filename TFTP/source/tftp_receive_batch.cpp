@@ -0,0 +1,149 @@
+///
+/// @file tftp_receive_batch.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the batched datagram receiver.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#endif
+
+#include "tftp_receive_batch.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPReceiveBatch::TFTPReceiveBatch(int buffer_len, int capacity)
+        : m_buffer{new char[static_cast<size_t>(buffer_len) * capacity]},
+          m_sizes(capacity),
+          m_addresses(capacity),
+          m_address_sizes(capacity),
+          m_buffer_len{buffer_len},
+          m_capacity{capacity}
+#ifdef __linux__
+          ,
+          m_headers(capacity),
+          m_vectors(capacity)
+#endif
+    {
+    }
+
+#ifdef __linux__
+
+    int TFTPReceiveBatch::receive(SOCKET socket)
+    {
+        for (int i = 0; i < this->m_capacity; ++i)
+        {
+            this->m_vectors[i].iov_base = &this->m_buffer[static_cast<size_t>(i) * this->m_buffer_len];
+            this->m_vectors[i].iov_len = this->m_buffer_len;
+
+            msghdr& header = this->m_headers[i].msg_hdr;
+            header = msghdr{};
+            header.msg_name = &this->m_addresses[i];
+            header.msg_namelen = sizeof(SOCKADDR_STORAGE_LH);
+            header.msg_iov = &this->m_vectors[i];
+            header.msg_iovlen = 1;
+        }
+
+        int count = 0;
+
+        do
+        {
+            count = recvmmsg(socket, this->m_headers.data(), this->m_capacity, MSG_DONTWAIT, nullptr);
+        } while (count < 0 && errno == EINTR);
+
+        for (int i = 0; i < count; ++i)
+        {
+            this->m_sizes[i] = static_cast<int>(this->m_headers[i].msg_len);
+            this->m_address_sizes[i] = this->m_headers[i].msg_hdr.msg_namelen;
+        }
+
+        return count < 0 ? 0 : count;
+    }
+
+#else
+
+    int TFTPReceiveBatch::receive(SOCKET socket)
+    {
+        this->m_address_sizes[0] = sizeof(SOCKADDR_STORAGE_LH);
+        this->m_sizes[0] = recvfrom(socket,
+                                    this->m_buffer.get(),
+                                    this->m_buffer_len,
+                                    0,
+                                    reinterpret_cast<SOCKADDR*>(&this->m_addresses[0]),
+                                    &this->m_address_sizes[0]);
+
+        return this->m_sizes[0] < 0 ? 0 : 1;
+    }
+
+#endif
+
+    char* TFTPReceiveBatch::get_data(int index)
+    {
+        return &this->m_buffer[static_cast<size_t>(index) * this->m_buffer_len];
+    }
+
+    int TFTPReceiveBatch::get_size(int index) const
+    {
+        return this->m_sizes[index];
+    }
+
+    const SOCKADDR_STORAGE_LH& TFTPReceiveBatch::get_address(int index) const
+    {
+        return this->m_addresses[index];
+    }
+
+    socklen_t TFTPReceiveBatch::get_address_size(int index) const
+    {
+        return this->m_address_sizes[index];
+    }
+
+    void TFTPReceiveBatch::store(int index, const char* data, int size,
+                                 const SOCKADDR_STORAGE_LH& address, socklen_t address_size)
+    {
+        const int stored = std::min(size, this->m_buffer_len);
+
+        std::memcpy(this->get_data(index), data, static_cast<size_t>(stored));
+        this->m_sizes[index] = stored;
+        this->m_addresses[index] = address;
+        this->m_address_sizes[index] = address_size;
+    }
+
+    int TFTPReceiveBatch::get_buffer_len() const
+    {
+        return this->m_buffer_len;
+    }
+
+    int TFTPReceiveBatch::get_capacity() const
+    {
+        return this->m_capacity;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,173 @@
+///
+/// @file tftp_retransmitter.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the retransmission timer.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "tftp_retransmitter.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPRetransmitter::TFTPRetransmitter()
+        : m_srtt{0},
+          m_rttvar{0},
+          m_rto{std::chrono::milliseconds(TFTP_INITIAL_RTO_MS)},
+          m_fixed_timeout{0},
+          m_sent_at{},
+          m_deadline{},
+          m_backoff{1},
+          m_retries{0},
+          m_max_retries{TFTP_DEFAULT_MAX_RETRIES},
+          m_armed{false},
+          m_has_sample{false},
+          m_retransmitted{false}
+    {
+    }
+
+    void TFTPRetransmitter::set_max_retries(int max_retries)
+    {
+        this->m_max_retries = std::clamp(max_retries, 0, TFTP_MAX_RETRIES);
+    }
+
+    void TFTPRetransmitter::set_fixed_timeout(int seconds)
+    {
+        this->m_fixed_timeout = std::chrono::seconds(seconds);
+    }
+
+    void TFTPRetransmitter::arm(steady_clock_t::time_point now)
+    {
+        if (this->m_armed)
+        {
+            return;
+        }
+
+        this->m_sent_at = now;
+        this->m_deadline = now + std::min(this->get_rto() * this->m_backoff, this->get_max_timeout());
+        this->m_armed = true;
+    }
+
+    void TFTPRetransmitter::on_answer(steady_clock_t::time_point now)
+    {
+        if (this->m_armed && !this->m_retransmitted)
+        {
+            const auto sample = std::chrono::duration_cast<std::chrono::microseconds>(now - this->m_sent_at);
+
+            if (!this->m_has_sample)
+            {
+                this->m_srtt = sample;
+                this->m_rttvar = sample / 2;
+                this->m_has_sample = true;
+            }
+            else
+            {
+                const auto error = this->m_srtt > sample ? this->m_srtt - sample : sample - this->m_srtt;
+
+                this->m_rttvar = (this->m_rttvar * 3 + error) / 4;
+                this->m_srtt = (this->m_srtt * 7 + sample) / 8;
+            }
+
+            this->m_rto = std::clamp<std::chrono::microseconds>(this->m_srtt + this->m_rttvar * 4,
+                                                                std::chrono::milliseconds(TFTP_MIN_RTO_MS),
+                                                                std::chrono::milliseconds(TFTP_MAX_RTO_MS));
+        }
+
+        // Karn's rule: answers to retransmitted packets are ambiguous and
+        // are never sampled, the next fresh packet is.
+        this->m_retransmitted = false;
+        this->m_backoff = 1;
+        this->m_retries = 0;
+        this->m_armed = false;
+    }
+
+    bool TFTPRetransmitter::on_expired(steady_clock_t::time_point now)
+    {
+        if (++this->m_retries > this->m_max_retries)
+        {
+            this->m_armed = false;
+            return false;
+        }
+
+        // Doubling stops at the ceiling, the multiplier never grows past it.
+        if (this->get_rto() * this->m_backoff < this->get_max_timeout())
+        {
+            this->m_backoff *= 2;
+        }
+
+        this->m_retransmitted = true;
+        this->m_armed = false;
+        this->arm(now);
+
+        return true;
+    }
+
+    bool TFTPRetransmitter::is_armed() const
+    {
+        return this->m_armed;
+    }
+
+    bool TFTPRetransmitter::is_expired(steady_clock_t::time_point now) const
+    {
+        return this->m_armed && now >= this->m_deadline;
+    }
+
+    TFTPRetransmitter::steady_clock_t::time_point TFTPRetransmitter::get_deadline() const
+    {
+        return this->m_deadline;
+    }
+
+    std::chrono::microseconds TFTPRetransmitter::get_rto() const
+    {
+        return this->m_fixed_timeout.count() != 0 ? this->m_fixed_timeout : this->m_rto;
+    }
+
+    std::chrono::microseconds TFTPRetransmitter::get_srtt() const
+    {
+        return this->m_srtt;
+    }
+
+    int TFTPRetransmitter::get_retries() const
+    {
+        return this->m_retries;
+    }
+
+    void TFTPRetransmitter::reset()
+    {
+        const int max_retries = this->m_max_retries;
+
+        *this = TFTPRetransmitter();
+        this->m_max_retries = max_retries;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    std::chrono::microseconds TFTPRetransmitter::get_max_timeout() const
+    {
+        return std::max<std::chrono::microseconds>(std::chrono::milliseconds(TFTP_MAX_RTO_MS),
+                                                   this->m_fixed_timeout);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,145 @@
+///
+/// @file tftp_send_batch.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the batched datagram sender.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+#include <cerrno>
+#endif
+
+#include "tftp_send_batch.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPSendBatch::TFTPSendBatch(int capacity)
+        : m_packets{},
+          m_capacity{capacity}
+#ifdef __linux__
+          ,
+          m_headers(capacity),
+          m_vectors(static_cast<size_t>(capacity) * 2)
+#endif
+    {
+        this->m_packets.reserve(capacity);
+    }
+
+    bool TFTPSendBatch::queue(const packet_view_t& packet)
+    {
+        if (static_cast<int>(this->m_packets.size()) >= this->m_capacity)
+        {
+            return false;
+        }
+
+        this->m_packets.push_back(packet);
+
+        return true;
+    }
+
+#ifdef __linux__
+
+    int TFTPSendBatch::flush(SOCKET socket, const SOCKADDR* peer, socklen_t peer_size)
+    {
+        const int count = static_cast<int>(this->m_packets.size());
+
+        for (int i = 0; i < count; ++i)
+        {
+            const packet_view_t& packet = this->m_packets[i];
+            iovec* vectors = &this->m_vectors[static_cast<size_t>(i) * 2];
+
+            vectors[0].iov_base = const_cast<char*>(packet.data);
+            vectors[0].iov_len = packet.size;
+            vectors[1].iov_base = const_cast<char*>(packet.payload);
+            vectors[1].iov_len = packet.payload_size;
+
+            msghdr& header = this->m_headers[i].msg_hdr;
+            header = msghdr{};
+            header.msg_name = const_cast<SOCKADDR*>(peer);
+            header.msg_namelen = peer_size;
+            header.msg_iov = vectors;
+            header.msg_iovlen = packet.payload != nullptr ? 2 : 1;
+        }
+
+        int sent = 0;
+
+        while (sent < count)
+        {
+            const int result = sendmmsg(socket, &this->m_headers[sent], count - sent, 0);
+
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (result <= 0)
+            {
+                break;
+            }
+
+            sent += result;
+        }
+
+        this->m_packets.clear();
+
+        return sent;
+    }
+
+#else
+
+    int TFTPSendBatch::flush(SOCKET socket, const SOCKADDR* peer, socklen_t peer_size)
+    {
+        int sent = 0;
+
+        for (const packet_view_t& packet : this->m_packets)
+        {
+            WSABUF buffers[2] = {
+                {static_cast<ULONG>(packet.size), const_cast<char*>(packet.data)},
+                {static_cast<ULONG>(packet.payload_size), const_cast<char*>(packet.payload)},
+            };
+            DWORD bytes_sent = 0;
+
+            if (WSASendTo(socket, buffers, packet.payload != nullptr ? 2 : 1, &bytes_sent, 0,
+                          peer, peer_size, nullptr, nullptr) != SOCKET_ERROR)
+            {
+                ++sent;
+            }
+        }
+
+        this->m_packets.clear();
+
+        return sent;
+    }
+
+#endif
+
+    bool TFTPSendBatch::is_empty() const
+    {
+        return this->m_packets.empty();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,303 @@
+///
+/// @file tftp_session.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the per-transfer TFTP protocol state.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tftp_session.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPSession::TFTPSession()
+        : m_data_block_num{0},
+          m_send_block_num{0},
+          m_acked_block_num{0},
+          m_ack_block_num{0},
+          m_blocks_since_ack{0},
+          m_gap_acked{false},
+          m_control_buffer{},
+          m_control_size{0},
+          m_control_block_num{-1},
+          m_ack_checksum{false},
+          m_window_buffer{nullptr},
+          m_window_packets{},
+          m_slot_size{0},
+          m_options{}
+    {
+    }
+
+    char* TFTPSession::next_block_buffer(int ahead)
+    {
+        const int slot = this->window_slot(this->m_data_block_num + 1 + ahead,
+                                           this->m_options.block_size);
+
+        return &this->m_window_buffer[slot * this->m_slot_size + data_begin];
+    }
+
+    int TFTPSession::free_window_slots() const
+    {
+        return this->m_options.window_size - static_cast<int>(this->m_data_block_num - this->m_acked_block_num);
+    }
+
+    packet_view_t TFTPSession::commit_data_packet(int data_len)
+    {
+        const int slot = this->window_slot(++this->m_data_block_num, this->m_options.block_size);
+        char* packet = &this->m_window_buffer[slot * this->m_slot_size];
+        const int header_size = TFTP::encode_data_header(packet, this->wire_block_number(this->m_data_block_num));
+
+        this->m_window_packets[slot] = packet_view_t{packet,
+                                                     header_size + data_len,
+                                                     this->m_data_block_num};
+        this->m_send_block_num = this->m_data_block_num;
+
+        return this->m_window_packets[slot];
+    }
+
+    packet_view_t TFTPSession::commit_data_packet(const char* payload, int data_len)
+    {
+        // Slots only hold the header, a retransmission points at the payload again.
+        const int slot = this->window_slot(++this->m_data_block_num, 0);
+        char* header = &this->m_window_buffer[slot * this->m_slot_size];
+
+        this->m_window_packets[slot] = packet_view_t{header,
+                                                     TFTP::encode_data_header(header, this->wire_block_number(this->m_data_block_num)),
+                                                     this->m_data_block_num,
+                                                     payload,
+                                                     data_len};
+        this->m_send_block_num = this->m_data_block_num;
+
+        return this->m_window_packets[slot];
+    }
+
+    packet_view_t TFTPSession::make_ack_packet()
+    {
+        this->m_control_size = this->m_ack_checksum
+                               ? TFTP::encode_ack_packet(this->m_control_buffer.data(),
+                                                         static_cast<int>(this->m_control_buffer.size()),
+                                                         this->wire_block_number(this->m_ack_block_num),
+                                                         this->m_options.checksum)
+                               : TFTP::encode_ack_packet(this->m_control_buffer.data(),
+                                                         this->wire_block_number(this->m_ack_block_num));
+        this->m_control_block_num = this->m_ack_block_num;
+        this->m_blocks_since_ack = 0;
+
+        return this->get_last_packet();
+    }
+
+    void TFTPSession::set_final_checksum(uint32_t checksum)
+    {
+        this->m_options.checksum = checksum;
+        this->m_ack_checksum = true;
+    }
+
+    packet_view_t TFTPSession::make_oack_packet()
+    {
+        this->m_control_size = TFTP::encode_oack_packet(this->m_control_buffer.data(),
+                                                        static_cast<int>(this->m_control_buffer.size()),
+                                                        this->m_options);
+        this->m_control_block_num = 0;
+
+        return this->get_last_packet();
+    }
+
+    bool TFTPSession::accept_ack(uint16_t block_number)
+    {
+        // Block numbers wrap on the wire, the distance from the last ACK tells
+        // where the ACK sits in the window.
+        const int distance = this->wire_distance(this->m_acked_block_num, block_number);
+        const int64_t acked_block_num = this->m_acked_block_num + distance;
+
+        if (distance < 0 || acked_block_num > this->m_data_block_num)
+        {
+            return false;
+        }
+
+        if (distance == 0)
+        {
+            // Only the ACK 0 of an OACK counts, every other repeat is a duplicate.
+            return this->m_data_block_num == 0;
+        }
+
+        this->m_acked_block_num = acked_block_num;
+
+        if (acked_block_num < this->m_send_block_num)
+        {
+            // The peer lost a block in the middle of the window.
+            this->m_send_block_num = acked_block_num;
+        }
+
+        return true;
+    }
+
+    void TFTPSession::rewind_window()
+    {
+        this->m_send_block_num = this->m_acked_block_num;
+    }
+
+    bool TFTPSession::is_window_open() const
+    {
+        return this->m_send_block_num - this->m_acked_block_num < this->m_options.window_size;
+    }
+
+    bool TFTPSession::has_unsent_packet() const
+    {
+        return this->m_send_block_num < this->m_data_block_num;
+    }
+
+    packet_view_t TFTPSession::next_unsent_packet()
+    {
+        ++this->m_send_block_num;
+
+        return this->m_window_packets[static_cast<size_t>(this->m_send_block_num % this->m_options.window_size)];
+    }
+
+    bool TFTPSession::is_window_acked() const
+    {
+        return this->m_acked_block_num == this->m_data_block_num;
+    }
+
+    data_verdict_t TFTPSession::accept_data(uint16_t block_number, int data_len)
+    {
+        if (block_number == this->wire_block_number(this->m_ack_block_num + 1))
+        {
+            ++this->m_ack_block_num;
+            ++this->m_blocks_since_ack;
+            this->m_gap_acked = false;
+
+            if (this->m_blocks_since_ack >= this->m_options.window_size ||
+                this->is_last_block(data_len))
+            {
+                return DATA_VERDICT_STORE_AND_ACK;
+            }
+
+            return DATA_VERDICT_STORE;
+        }
+
+        if (block_number == this->wire_block_number(this->m_ack_block_num))
+        {
+            // The sender retransmitted up to our last ACK, so it was lost.
+            return DATA_VERDICT_ACK;
+        }
+
+        const int distance = this->wire_distance(this->m_ack_block_num, block_number);
+
+        if (distance > 0 && distance <= this->m_options.window_size && !this->m_gap_acked)
+        {
+            // A block of the window was lost, ask for it once.
+            this->m_gap_acked = true;
+            return DATA_VERDICT_ACK;
+        }
+
+        return DATA_VERDICT_IGNORE;
+    }
+
+    bool TFTPSession::has_unacked_data() const
+    {
+        return this->m_blocks_since_ack > 0;
+    }
+
+    bool TFTPSession::is_last_block(int data_len) const
+    {
+        return data_len < this->m_options.block_size;
+    }
+
+    packet_view_t TFTPSession::get_last_packet() const
+    {
+        return packet_view_t{this->m_control_buffer.data(), this->m_control_size, this->m_control_block_num};
+    }
+
+    const transfer_options_t& TFTPSession::get_options() const
+    {
+        return this->m_options;
+    }
+
+    transfer_options_t& TFTPSession::get_options()
+    {
+        return this->m_options;
+    }
+
+    void TFTPSession::reset()
+    {
+        this->m_data_block_num = 0;
+        this->m_send_block_num = 0;
+        this->m_acked_block_num = 0;
+        this->m_ack_block_num = 0;
+        this->m_blocks_since_ack = 0;
+        this->m_gap_acked = false;
+        this->m_control_size = 0;
+        this->m_control_block_num = -1;
+        this->m_ack_checksum = false;
+        this->m_options = transfer_options_t{};
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    int TFTPSession::window_slot(int64_t block_number, int payload_capacity)
+    {
+        const int slot_size = data_begin + payload_capacity;
+        const int window_size = this->m_options.window_size;
+
+        // Allocated once per transfer shape, a client reuses it across transfers.
+        if (this->m_slot_size != slot_size || static_cast<int>(this->m_window_packets.size()) != window_size)
+        {
+            this->m_window_buffer.reset(new char[static_cast<size_t>(slot_size) * window_size]);
+            this->m_window_packets.assign(window_size, packet_view_t{nullptr, 0, -1});
+            this->m_slot_size = slot_size;
+        }
+
+        return static_cast<int>(block_number % window_size);
+    }
+
+    uint16_t TFTPSession::wire_block_number(int64_t block_number) const
+    {
+        if (block_number <= UINT16_MAX || this->m_options.rollover == ROLLOVER_POLICY_ZERO)
+        {
+            return static_cast<uint16_t>(block_number);
+        }
+
+        // After the first wrap the numbers cycle through 1 to 65535.
+        return static_cast<uint16_t>((block_number - 1) % UINT16_MAX + 1);
+    }
+
+    int TFTPSession::wire_distance(int64_t block_number, uint16_t wire_number) const
+    {
+        const uint16_t base = this->wire_block_number(block_number);
+
+        if (this->m_options.rollover == ROLLOVER_POLICY_ZERO || block_number == 0)
+        {
+            return static_cast<uint16_t>(wire_number - base);
+        }
+
+        if (wire_number == 0)
+        {
+            // 0 only comes before block 1 when the numbers wrap to 1.
+            return -1;
+        }
+
+        return (wire_number + UINT16_MAX - base) % UINT16_MAX;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,320 @@
+///
+/// @file tftp_timing_wheel.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPTimingWheel class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "tftp_timing_wheel.hpp"
+
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPTimingWheel::TFTPTimingWheel()
+        : m_slots{},
+          m_occupied{},
+          m_current{0},
+          m_size{0},
+          m_origin{steady_clock_t::now()}
+    {
+        for (wheel_timer_t& sentinel : this->m_slots)
+        {
+            sentinel.prev = &sentinel;
+            sentinel.next = &sentinel;
+        }
+    }
+
+    void TFTPTimingWheel::schedule(wheel_timer_t& timer, steady_clock_t::time_point deadline)
+    {
+        if (is_scheduled(timer))
+        {
+            this->unlink(timer);
+        }
+
+        timer.expiry = this->to_tick(deadline, true);
+        this->link(timer);
+    }
+
+    void TFTPTimingWheel::cancel(wheel_timer_t& timer)
+    {
+        if (is_scheduled(timer))
+        {
+            this->unlink(timer);
+        }
+    }
+
+    bool TFTPTimingWheel::is_scheduled(const wheel_timer_t& timer)
+    {
+        return timer.prev != nullptr;
+    }
+
+    void TFTPTimingWheel::advance(steady_clock_t::time_point now, std::vector<void*>& expired)
+    {
+        const uint64_t target = this->to_tick(now, false);
+
+        expired.clear();
+
+        while (this->m_current <= target)
+        {
+            if (this->m_size == 0)
+            {
+                this->m_current = target + 1;
+                break;
+            }
+
+            const int index = static_cast<int>(this->m_current & slot_mask);
+
+            if (index == 0)
+            {
+                // Higher levels first, their timers may land in a slot which
+                // turns over at the same tick.
+                if ((this->m_current & wheel_mask) == 0)
+                {
+                    this->relink(overflow_slot);
+                }
+
+                for (int level = level_count - 1; level > 0; --level)
+                {
+                    if ((this->m_current & ((uint64_t{1} << (slot_bits * level)) - 1)) == 0)
+                    {
+                        const uint64_t level_index = (this->m_current >> (slot_bits * level)) & slot_mask;
+
+                        this->relink(static_cast<uint32_t>(level * slot_count + level_index));
+                    }
+                }
+            }
+
+            wheel_timer_t& sentinel = this->m_slots[index];
+
+            while (sentinel.next != &sentinel)
+            {
+                wheel_timer_t& timer = *sentinel.next;
+
+                this->unlink(timer);
+                expired.push_back(timer.context);
+            }
+
+            // Jump over the empty slots up to the end of this turn.
+            const uint64_t later = index == slot_mask ? 0 : this->m_occupied[0] & (~uint64_t{0} << (index + 1));
+            const uint64_t next = later != 0
+                                  ? (this->m_current & ~slot_mask) | static_cast<uint64_t>(lowest_bit(later))
+                                  : (this->m_current | slot_mask) + 1;
+
+            this->m_current = std::min(next, target + 1);
+        }
+    }
+
+    int TFTPTimingWheel::next_timeout_ms(steady_clock_t::time_point now) const
+    {
+        if (this->m_size == 0)
+        {
+            return -1;
+        }
+
+        const auto wake_at = this->m_origin + std::chrono::milliseconds(this->next_tick());
+
+        if (wake_at <= now)
+        {
+            return 0;
+        }
+
+        // Round up so the loop never wakes before the tick.
+        const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(wake_at - now);
+
+        return static_cast<int>((remaining.count() + 999) / 1000);
+    }
+
+    size_t TFTPTimingWheel::get_size() const
+    {
+        return this->m_size;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    uint64_t TFTPTimingWheel::to_tick(steady_clock_t::time_point time_point, bool round_up) const
+    {
+        if (time_point <= this->m_origin)
+        {
+            return 0;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time_point - this->m_origin);
+        const auto ticks = static_cast<uint64_t>(elapsed.count());
+
+        return round_up ? (ticks + 999) / 1000 : ticks / 1000;
+    }
+
+    void TFTPTimingWheel::link(wheel_timer_t& timer)
+    {
+        const uint64_t tick = std::max(timer.expiry, this->m_current);
+
+        if (((tick ^ this->m_current) & ~wheel_mask) != 0)
+        {
+            // Beyond this turn of the wheel.
+            timer.slot = overflow_slot;
+        }
+        else
+        {
+            int level = 0;
+
+            while (level < level_count - 1 && ((tick ^ this->m_current) >> (slot_bits * (level + 1))) != 0)
+            {
+                ++level;
+            }
+
+            const uint64_t index = (tick >> (slot_bits * level)) & slot_mask;
+
+            timer.slot = static_cast<uint32_t>(level * slot_count + index);
+            this->m_occupied[level] |= uint64_t{1} << index;
+        }
+
+        wheel_timer_t& sentinel = this->m_slots[timer.slot];
+
+        timer.prev = sentinel.prev;
+        timer.next = &sentinel;
+        sentinel.prev->next = &timer;
+        sentinel.prev = &timer;
+
+        ++this->m_size;
+    }
+
+    void TFTPTimingWheel::unlink(wheel_timer_t& timer)
+    {
+        wheel_timer_t& sentinel = this->m_slots[timer.slot];
+
+        timer.prev->next = timer.next;
+        timer.next->prev = timer.prev;
+        timer.prev = nullptr;
+        timer.next = nullptr;
+
+        if (sentinel.next == &sentinel && timer.slot != overflow_slot)
+        {
+            this->m_occupied[timer.slot / slot_count] &= ~(uint64_t{1} << (timer.slot % slot_count));
+        }
+
+        --this->m_size;
+    }
+
+    void TFTPTimingWheel::relink(uint32_t slot)
+    {
+        wheel_timer_t& sentinel = this->m_slots[slot];
+
+        if (sentinel.next == &sentinel)
+        {
+            return;
+        }
+
+        // Detached first, timers which stay in the same slot are not visited twice.
+        wheel_timer_t* timer = sentinel.next;
+
+        sentinel.prev->next = nullptr;
+        sentinel.prev = &sentinel;
+        sentinel.next = &sentinel;
+
+        if (slot != overflow_slot)
+        {
+            this->m_occupied[slot / slot_count] &= ~(uint64_t{1} << (slot % slot_count));
+        }
+
+        while (timer != nullptr)
+        {
+            wheel_timer_t* next = timer->next;
+
+            timer->prev = nullptr;
+            timer->next = nullptr;
+            --this->m_size;
+            this->link(*timer);
+            timer = next;
+        }
+    }
+
+    uint64_t TFTPTimingWheel::next_tick() const
+    {
+        // Slots which turn over at the current tick have not cascaded yet.
+        for (int level = 1; level < level_count; ++level)
+        {
+            const int shift = slot_bits * level;
+
+            if ((this->m_current & ((uint64_t{1} << shift) - 1)) != 0)
+            {
+                break;
+            }
+
+            if ((this->m_occupied[level] >> ((this->m_current >> shift) & slot_mask)) & 1)
+            {
+                return this->m_current;
+            }
+        }
+
+        const wheel_timer_t& overflow = this->m_slots[overflow_slot];
+
+        if ((this->m_current & wheel_mask) == 0 && overflow.next != &overflow)
+        {
+            return this->m_current;
+        }
+
+        const int index = static_cast<int>(this->m_current & slot_mask);
+        const uint64_t current_turn = this->m_occupied[0] & (~uint64_t{0} << index);
+
+        if (current_turn != 0)
+        {
+            return (this->m_current & ~slot_mask) | static_cast<uint64_t>(lowest_bit(current_turn));
+        }
+
+        for (int level = 1; level < level_count; ++level)
+        {
+            const int shift = slot_bits * level;
+            const int first = static_cast<int>((this->m_current >> shift) & slot_mask) + 1;
+            const uint64_t later = first == slot_count ? 0 : this->m_occupied[level] & (~uint64_t{0} << first);
+
+            if (later != 0)
+            {
+                // The start of the slot, where its timers fall down a level.
+                const uint64_t turn = (this->m_current >> (shift + slot_bits)) << (shift + slot_bits);
+
+                return turn | (static_cast<uint64_t>(lowest_bit(later)) << shift);
+            }
+        }
+
+        // Only the overflow list is left, it moves on when the wheel turns over.
+        return (this->m_current | wheel_mask) + 1;
+    }
+
+    int TFTPTimingWheel::lowest_bit(uint64_t bits)
+    {
+#ifdef _WIN32
+        unsigned long index = 0;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
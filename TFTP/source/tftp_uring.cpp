@@ -0,0 +1,417 @@
+///
+/// @file tftp_uring.cpp
+/// @author Yasin BASAR
+/// @brief Implementation file for the io_uring submission and completion rings.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <stdexcept>
+#include "tftp_uring.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPUring::TFTPUring(unsigned entries, int buffer_len, int buffer_count)
+        : m_ring_fd{-1},
+          m_sq_ring{MAP_FAILED},
+          m_cq_ring{MAP_FAILED},
+          m_sqes{static_cast<io_uring_sqe*>(MAP_FAILED)},
+          m_sq_ring_size{0},
+          m_cq_ring_size{0},
+          m_sqes_size{0},
+          m_sq_head{nullptr},
+          m_sq_tail{nullptr},
+          m_sq_mask{0},
+          m_sq_entries{0},
+          m_sq_array{nullptr},
+          m_cq_head{nullptr},
+          m_cq_tail{nullptr},
+          m_cq_mask{0},
+          m_cqes{nullptr},
+          m_buffers{nullptr},
+          m_buffer_len{buffer_len},
+          m_buffer_count{buffer_count},
+          m_receive_layout{}
+    {
+        io_uring_params params{};
+        this->m_ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+
+        if (this->m_ring_fd < 0)
+        {
+            throw std::runtime_error("Error at io_uring setup. Error code: " + GET_LAST_ERROR());
+        }
+
+        if ((params.features & IORING_FEAT_EXT_ARG) == 0)
+        {
+            this->release();
+            throw std::runtime_error("io_uring of this kernel has no timed waits");
+        }
+
+        this->m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        this->m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        {
+            this->m_sq_ring_size = std::max(this->m_sq_ring_size, this->m_cq_ring_size);
+            this->m_cq_ring_size = this->m_sq_ring_size;
+        }
+
+        this->m_sq_ring = mmap(nullptr, this->m_sq_ring_size, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, this->m_ring_fd, IORING_OFF_SQ_RING);
+
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        {
+            this->m_cq_ring = this->m_sq_ring;
+        }
+        else
+        {
+            this->m_cq_ring = mmap(nullptr, this->m_cq_ring_size, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, this->m_ring_fd, IORING_OFF_CQ_RING);
+        }
+
+        this->m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        this->m_sqes = static_cast<io_uring_sqe*>(mmap(nullptr, this->m_sqes_size, PROT_READ | PROT_WRITE,
+                                                       MAP_SHARED | MAP_POPULATE, this->m_ring_fd,
+                                                       IORING_OFF_SQES));
+
+        if (this->m_sq_ring == MAP_FAILED || this->m_cq_ring == MAP_FAILED ||
+            this->m_sqes == MAP_FAILED)
+        {
+            const std::string error_str = "Error at io_uring mapping. Error code: " + GET_LAST_ERROR();
+            this->release();
+            throw std::runtime_error(error_str);
+        }
+
+        char* sq_ring = static_cast<char*>(this->m_sq_ring);
+        char* cq_ring = static_cast<char*>(this->m_cq_ring);
+
+        this->m_sq_head = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.head);
+        this->m_sq_tail = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+        this->m_sq_mask = *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+        this->m_sq_entries = params.sq_entries;
+        this->m_sq_array = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+        this->m_cq_head = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+        this->m_cq_tail = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+        this->m_cq_mask = *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+        this->m_cqes = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+
+        // One slab holds every provided buffer, the kernel hands them out
+        // to receives one by one.
+        this->m_buffers = new char[static_cast<size_t>(buffer_len) * buffer_count];
+        this->provide_buffers(0, buffer_count);
+
+        this->m_receive_layout.msg_namelen = sizeof(SOCKADDR_STORAGE_LH);
+        this->m_receive_layout.msg_controllen = 0;
+
+        if (!this->probe_multishot_receive())
+        {
+            this->release();
+            throw std::runtime_error("io_uring of this kernel has no multishot receive");
+        }
+    }
+
+    TFTPUring::~TFTPUring()
+    {
+        this->release();
+    }
+
+    void TFTPUring::prepare_receive(SOCKET socket, uint64_t user_data)
+    {
+        io_uring_sqe* entry = this->next_entry();
+
+        entry->opcode = IORING_OP_RECVMSG;
+        entry->fd = socket;
+        entry->addr = reinterpret_cast<uint64_t>(&this->m_receive_layout);
+        entry->len = 0;
+        entry->ioprio = IORING_RECV_MULTISHOT;
+        entry->flags = IOSQE_BUFFER_SELECT;
+        entry->buf_group = 0;
+        entry->user_data = user_data;
+    }
+
+    void TFTPUring::prepare_read(int fd, const iovec* vectors, int count, uint64_t offset, uint64_t user_data)
+    {
+        io_uring_sqe* entry = this->next_entry();
+
+        entry->opcode = IORING_OP_READV;
+        entry->fd = fd;
+        entry->addr = reinterpret_cast<uint64_t>(vectors);
+        entry->len = count;
+        entry->off = offset;
+        entry->user_data = user_data;
+    }
+
+    void TFTPUring::prepare_write(int fd, const char* data, int size, uint64_t offset, uint64_t user_data)
+    {
+        io_uring_sqe* entry = this->next_entry();
+
+        entry->opcode = IORING_OP_WRITE;
+        entry->fd = fd;
+        entry->addr = reinterpret_cast<uint64_t>(data);
+        entry->len = size;
+        entry->off = offset;
+        entry->user_data = user_data;
+    }
+
+    void TFTPUring::prepare_cancel(uint64_t target_user_data)
+    {
+        io_uring_sqe* entry = this->next_entry();
+
+        entry->opcode = IORING_OP_ASYNC_CANCEL;
+        entry->fd = -1;
+        entry->addr = target_user_data;
+        entry->user_data = internal_user_data;
+    }
+
+    int TFTPUring::submit_and_wait(std::vector<completion_t>& completions, int timeout_ms)
+    {
+        completions.clear();
+
+        this->reap(completions);
+        this->enter(completions.empty() ? 1 : 0, timeout_ms);
+        this->reap(completions);
+
+        return static_cast<int>(completions.size());
+    }
+
+    bool TFTPUring::get_datagram(const completion_t& completion, datagram_t& datagram)
+    {
+        const int buffer_id = get_buffer_id(completion);
+
+        if (completion.result < static_cast<int>(sizeof(io_uring_recvmsg_out)) || buffer_id < 0)
+        {
+            return false;
+        }
+
+        char* buffer = &this->m_buffers[static_cast<size_t>(buffer_id) * this->m_buffer_len];
+        const auto* header = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+
+        if ((header->flags & MSG_TRUNC) != 0)
+        {
+            // A cut Data block would look like the last one of the file.
+            return false;
+        }
+
+        // Layout of a multishot receive: header, reserved address space,
+        // reserved control space, then the payload.
+        const int payload_offset = static_cast<int>(sizeof(io_uring_recvmsg_out) +
+                                                    this->m_receive_layout.msg_namelen +
+                                                    this->m_receive_layout.msg_controllen);
+
+        datagram.data = buffer + payload_offset;
+        datagram.size = std::min<int>(static_cast<int>(header->payloadlen),
+                                      completion.result - payload_offset);
+        datagram.sender = reinterpret_cast<const SOCKADDR_STORAGE_LH*>(buffer + sizeof(io_uring_recvmsg_out));
+        datagram.sender_size = static_cast<socklen_t>(header->namelen);
+
+        return datagram.size >= 0;
+    }
+
+    int TFTPUring::get_buffer_id(const completion_t& completion)
+    {
+        if ((completion.flags & IORING_CQE_F_BUFFER) == 0)
+        {
+            return -1;
+        }
+
+        return static_cast<int>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+
+    uint64_t TFTPUring::make_user_data(uring_op_t op, int buffer_id, uint64_t owner_id)
+    {
+        return (static_cast<uint64_t>(op) << 56) |
+               (static_cast<uint64_t>(buffer_id & 0xFFFF) << 40) |
+               (owner_id & 0xFFFFFFFFFFULL);
+    }
+
+    uring_op_t TFTPUring::get_op(uint64_t user_data)
+    {
+        return static_cast<uring_op_t>(user_data >> 56);
+    }
+
+    int TFTPUring::get_request_buffer_id(uint64_t user_data)
+    {
+        return static_cast<int>((user_data >> 40) & 0xFFFF);
+    }
+
+    uint64_t TFTPUring::get_owner_id(uint64_t user_data)
+    {
+        return user_data & 0xFFFFFFFFFFULL;
+    }
+
+    void TFTPUring::recycle_buffer(int buffer_id)
+    {
+        this->provide_buffers(buffer_id, 1);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPUring::provide_buffers(int first_id, int count)
+    {
+        io_uring_sqe* entry = this->next_entry();
+
+        entry->opcode = IORING_OP_PROVIDE_BUFFERS;
+        entry->fd = count;
+        entry->addr = reinterpret_cast<uint64_t>(&this->m_buffers[static_cast<size_t>(first_id) *
+                                                                  this->m_buffer_len]);
+        entry->len = static_cast<uint32_t>(this->m_buffer_len);
+        entry->off = static_cast<uint64_t>(first_id);
+        entry->buf_group = 0;
+        entry->user_data = internal_user_data;
+    }
+
+    io_uring_sqe* TFTPUring::next_entry()
+    {
+        unsigned tail = *this->m_sq_tail;
+
+        if (tail - __atomic_load_n(this->m_sq_head, __ATOMIC_ACQUIRE) >= this->m_sq_entries)
+        {
+            this->enter(0, -1);
+            tail = *this->m_sq_tail;
+        }
+
+        const unsigned index = tail & this->m_sq_mask;
+        io_uring_sqe* entry = &this->m_sqes[index];
+
+        *entry = io_uring_sqe{};
+        this->m_sq_array[index] = index;
+
+        // The kernel only looks at the ring inside io_uring_enter, so the
+        // entry may be filled in after the tail moved.
+        __atomic_store_n(this->m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        return entry;
+    }
+
+    void TFTPUring::enter(unsigned wait_for, int timeout_ms)
+    {
+        const unsigned pending = *this->m_sq_tail - __atomic_load_n(this->m_sq_head, __ATOMIC_ACQUIRE);
+
+        if (pending == 0 && wait_for == 0)
+        {
+            return;
+        }
+
+        unsigned flags = wait_for != 0 ? IORING_ENTER_GETEVENTS : 0;
+
+        __kernel_timespec timeout{};
+        io_uring_getevents_arg argument{};
+
+        if (wait_for != 0 && timeout_ms >= 0)
+        {
+            timeout.tv_sec = timeout_ms / 1000;
+            timeout.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+            argument.ts = reinterpret_cast<uint64_t>(&timeout);
+            flags |= IORING_ENTER_EXT_ARG;
+        }
+
+        // Timeouts and signals end the wait with ETIME or EINTR, the caller
+        // simply finds no completion.
+        (void)syscall(__NR_io_uring_enter, this->m_ring_fd, pending, wait_for, flags,
+                      (flags & IORING_ENTER_EXT_ARG) != 0 ? static_cast<void*>(&argument) : nullptr,
+                      (flags & IORING_ENTER_EXT_ARG) != 0 ? sizeof(argument) : _NSIG / 8);
+    }
+
+    void TFTPUring::reap(std::vector<completion_t>& completions)
+    {
+        unsigned head = *this->m_cq_head;
+        const unsigned tail = __atomic_load_n(this->m_cq_tail, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head)
+        {
+            const io_uring_cqe& entry = this->m_cqes[head & this->m_cq_mask];
+
+            if (entry.user_data != internal_user_data)
+            {
+                completions.push_back(completion_t{entry.user_data, entry.res, entry.flags});
+            }
+        }
+
+        __atomic_store_n(this->m_cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    bool TFTPUring::probe_multishot_receive()
+    {
+        const SOCKET probe_socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_IP);
+
+        if (probe_socket == SOCKET_ERROR)
+        {
+            return false;
+        }
+
+        // Kernels without multishot receives reject the request right away,
+        // the others keep it running until it is cancelled.
+        const uint64_t probe_user_data = internal_user_data - 1;
+        std::vector<completion_t> completions;
+
+        this->prepare_receive(probe_socket, probe_user_data);
+        this->prepare_cancel(probe_user_data);
+
+        while (this->submit_and_wait(completions, 1000) > 0 &&
+               completions.front().user_data != probe_user_data)
+        {
+        }
+
+        CLOSE_SOCKET(probe_socket);
+
+        return !completions.empty() && completions.front().result == -ECANCELED;
+    }
+
+    void TFTPUring::release()
+    {
+        if (this->m_sqes != MAP_FAILED)
+        {
+            munmap(this->m_sqes, this->m_sqes_size);
+        }
+
+        if (this->m_cq_ring != MAP_FAILED && this->m_cq_ring != this->m_sq_ring)
+        {
+            munmap(this->m_cq_ring, this->m_cq_ring_size);
+        }
+
+        if (this->m_sq_ring != MAP_FAILED)
+        {
+            munmap(this->m_sq_ring, this->m_sq_ring_size);
+        }
+
+        if (this->m_ring_fd >= 0)
+        {
+            close(this->m_ring_fd);
+        }
+
+        delete[] this->m_buffers;
+
+        this->m_sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        this->m_cq_ring = MAP_FAILED;
+        this->m_sq_ring = MAP_FAILED;
+        this->m_ring_fd = -1;
+        this->m_buffers = nullptr;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,54 @@
+/**
+ * @file socket_macros.hpp
+ * @author Yasin BASAR
+ * @brief This file contains the cross-platform socket type and macro definitions
+ *        shared by the TFTP library, server and client.
+ * @version 1.0.0
+ * @date 12/08/2024
+ * @copyright (c) 2024 All rights reserved.
+ */
+
+#ifndef TFTP_SEVER_AND_CLIENT_SOCKET_MACROS_HPP
+#define TFTP_SEVER_AND_CLIENT_SOCKET_MACROS_HPP
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+
+#ifdef _WIN32
+#include <WinSock2.h> /*Windows socket architecture*/
+
+typedef int socklen_t;
+
+#define GET_LAST_ERROR() std::to_string(WSAGetLastError())
+#define CLOSE_SOCKET(s) closesocket(s)
+#define CLEANUP() WSACleanup();
+#endif
+
+#ifdef __linux__
+#include <sys/socket.h> /*Linux socket architecture*/
+#include <netinet/in.h> /*Internet socket structures*/
+#include <arpa/inet.h> /*Contains inet_ functions*/
+#include <unistd.h> /*Contains close() function for linux file describers*/
+
+#include <algorithm> /*Contains std::replace()*/
+#include <cstring> /*Contains memset()*/
+
+typedef int SOCKET;
+typedef sockaddr SOCKADDR;
+typedef sockaddr_in SOCKADDR_IN;
+typedef sockaddr_storage SOCKADDR_STORAGE_LH;
+
+#define SOCKET_ERROR (-1)
+#define INVALID_SOCKET 0
+
+#define GET_LAST_ERROR() std::string(strerror(errno))
+#define CLOSE_SOCKET(s) close(s)
+#define CLEANUP()
+#endif
+
+#include <string>
+
+#endif //TFTP_SEVER_AND_CLIENT_SOCKET_MACROS_HPP
+
+/* End of File */
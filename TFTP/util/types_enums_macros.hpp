@@ -14,7 +14,11 @@
  * Includes
  ******************************************************************************/
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 
 /*******************************************************************************
  * Third Party Libraries
@@ -23,18 +27,189 @@
 namespace YB
 {
 
-#define TFTP_INCOMING_DATA_BUFFER_LEN 1024
-#define TFTP_OUTGOING_DATA_BUFFER_LEN 512
+#define TFTP_REQUEST_BUFFER_LEN 1024
+#define TFTP_CONTROL_PACKET_LEN 256
+#define TFTP_BATCH_SIZE 32
 
-#define OP_CODE_RRQ 1
-#define OP_CODE_WRQ 2
-#define OP_CODE_DATA 3
-#define OP_CODE_ACK 4
-#define OP_CODE_ERR 5
+#define TFTP_URING_ENTRIES 256
+#define TFTP_URING_BUFFER_COUNT 512
+#define TFTP_URING_MAX_BLOCK_SIZE 8192
 
-#define OP_CODE_BYTE_SIZE 2
-#define BLOCK_NUMBER_BYTE_SIZE 2
-#define DATA_BEGIN (OP_CODE_BYTE_SIZE + BLOCK_NUMBER_BYTE_SIZE)
+#define TFTP_FILE_CACHE_CAPACITY (256u * 1024u * 1024u)
+#define TFTP_ROOT_INDEX_ENTRIES 65536
+#define TFTP_PACK_MAGIC "TFTPPAK1"
+#define TFTP_PACK_VERSION 1
+#define TFTP_PACK_ALIGNMENT 64
+#define TFTP_WRITE_BEHIND_BUFFER_SIZE size_t{256 * 1024}
+#define TFTP_WRITE_BEHIND_BUFFERS 2
+#define TFTP_WRITE_BEHIND_ALIGNMENT 4096
+
+#define TFTP_DEFAULT_BLOCK_SIZE 512
+#define TFTP_MIN_BLOCK_SIZE 8
+#define TFTP_MAX_BLOCK_SIZE 65464
+#define TFTP_PREFERRED_BLOCK_SIZE 1468
+
+#define TFTP_DEFAULT_WINDOW_SIZE 1
+#define TFTP_MAX_WINDOW_SIZE 64
+#define TFTP_PREFERRED_WINDOW_SIZE 8
+
+#define TFTP_INITIAL_RTO_MS 1000
+#define TFTP_MIN_RTO_MS 50
+#define TFTP_MAX_RTO_MS 16000
+#define TFTP_DEFAULT_MAX_RETRIES 6
+#define TFTP_MAX_RETRIES 32
+#define TFTP_MIN_TIMEOUT_OPTION 1
+#define TFTP_MAX_TIMEOUT_OPTION 255
+#define TFTP_MIN_LINGER_MS 200
+#define TFTP_SESSION_IDLE_MS 60000
+#define TFTP_CLIENT_MAX_CONCURRENCY 64
+#define TFTP_CLIENT_MAX_STRIPES 16
+#define TFTP_JOURNAL_MAGIC "TFTPJRN1"
+#define TFTP_JOURNAL_SUFFIX ".tftpjournal"
+#define TFTP_JOURNAL_INTERVAL int64_t{8 * 1024 * 1024}
+#define TFTP_PARTIAL_SUFFIX ".tftp.partial"
+#define TFTP_TEMP_INFIX ".tftp"
+#define TFTP_TEMP_SUFFIX ".part"
+#define TFTP_PARTIAL_MAX_AGE_S 86400
+#define TFTP_PARTIAL_SWEEP_INTERVAL_S 3600
+#define TFTP_SYNC_DEFAULT_SESSIONS 16
+#define TFTP_MAX_MODIFIED_TIME int64_t{4102444800LL * 1000000000LL}
+
+#define ERR_CODE_NOT_DEFINED 0
+#define ERR_CODE_FILE_NOT_FOUND 1
+#define ERR_CODE_ACCESS_VIOLATION 2
+#define ERR_CODE_DISK_FULL 3
+#define ERR_CODE_ILLEGAL_OPERATION 4
+#define ERR_CODE_UNKNOWN_TID 5
+#define ERR_CODE_FILE_EXISTS 6
+#define ERR_CODE_NO_SUCH_USER 7
+#define ERR_CODE_OPTION_NEGOTIATION 8
+
+#define OPTION_BLOCK_SIZE 0x01
+#define OPTION_WINDOW_SIZE 0x02
+#define OPTION_TIMEOUT 0x04
+#define OPTION_TRANSFER_SIZE 0x08
+#define OPTION_CHECKSUM 0x10
+#define OPTION_ROLLOVER 0x20
+#define OPTION_OFFSET 0x40
+#define OPTION_LENGTH 0x80
+#define OPTION_MODIFIED_TIME 0x100
+
+#define OPTION_NAME_BLOCK_SIZE "blksize"
+#define OPTION_NAME_WINDOW_SIZE "windowsize"
+#define OPTION_NAME_TIMEOUT "timeout"
+#define OPTION_NAME_TRANSFER_SIZE "tsize"
+#define OPTION_NAME_CHECKSUM "crc32c"
+#define OPTION_NAME_ROLLOVER "rollover"
+#define OPTION_NAME_OFFSET "offset"
+#define OPTION_NAME_LENGTH "length"
+#define OPTION_NAME_MODIFIED_TIME "mtime"
+
+#define TRANSFER_MODE_NAME_OCTET "octet"
+#define TRANSFER_MODE_NAME_NETASCII "netascii"
+
+#define SYNC_DIRECTION_NAME_GET "get"
+#define SYNC_DIRECTION_NAME_PUT "put"
+
+    /// @brief Direction of a file transfer, seen from the server.
+    typedef enum transfer_type_e
+    {
+        TRANSFER_TYPE_RRQ, ///< Server sends the file to the client.
+        TRANSFER_TYPE_WRQ ///< Server receives the file from the client.
+    } transfer_type_t;
+
+    /// @brief Representation of the file on the wire (RFC 1350)
+    typedef enum transfer_mode_e
+    {
+        TRANSFER_MODE_OCTET, ///< Raw bytes, the file is sent as it is.
+        TRANSFER_MODE_NETASCII ///< Text, lines end with CR LF and a bare CR is sent as CR NUL.
+    } transfer_mode_t;
+
+    /// @brief Block number which follows 65535 on the wire, files above 65535 blocks need one
+    typedef enum rollover_policy_e
+    {
+        ROLLOVER_POLICY_ZERO = 0, ///< Wrap to 0, like most implementations.
+        ROLLOVER_POLICY_ONE = 1 ///< Wrap to 1, 0 is only ever used before the first block.
+    } rollover_policy_t;
+
+    /// @brief Implementation of the netascii translation, ordered from the slowest
+    typedef enum netascii_kernel_e
+    {
+        NETASCII_KERNEL_SCALAR, ///< One byte at a time, any processor.
+        NETASCII_KERNEL_SSE2, ///< 16 bytes at a time, x86 only.
+        NETASCII_KERNEL_AVX2 ///< 32 bytes at a time, x86 processors which support AVX2.
+    } netascii_kernel_t;
+
+    /// @brief Packet types, the first field of every packet (RFC 1350, RFC 2347)
+    enum class op_code : uint16_t
+    {
+        NONE = 0, ///< Not a packet, the datagram is shorter than the op code.
+        RRQ = 1, ///< Read request
+        WRQ = 2, ///< Write request
+        DATA = 3, ///< Data
+        ACK = 4, ///< Acknowledgment
+        ERR = 5, ///< Error
+        OACK = 6 ///< Option acknowledgment
+    };
+
+    /// @brief Fixed header every packet starts with, fields in network byte order (RFC 1350)
+    typedef struct op_header_s
+    {
+        uint16_t op_code; ///< One of the op_code values
+    } op_header_t;
+
+    /// @brief Fixed header of Data and ACK packets, fields in network byte order
+    typedef struct block_header_s
+    {
+        uint16_t op_code; ///< op_code::DATA or op_code::ACK
+        uint16_t block_number; ///< Block carried or acknowledged
+    } block_header_t;
+
+    /// @brief Offset of the payload in a Data packet, the size of its header
+    constexpr int data_begin = static_cast<int>(sizeof(block_header_t));
+
+    /// @brief Fixed header of Error packets, fields in network byte order
+    typedef struct error_header_s
+    {
+        uint16_t op_code; ///< op_code::ERR
+        uint16_t error_code; ///< One of the ERR_CODE_* values
+    } error_header_t;
+
+    /// @brief Parsed RRQ or WRQ, the views point into the received datagram
+    typedef struct request_view_s
+    {
+        transfer_type_t transfer_type; ///< TRANSFER_TYPE_RRQ or TRANSFER_TYPE_WRQ
+        std::string_view file_name; ///< Requested name, followed by its NUL in the datagram
+        std::string_view mode; ///< Mode as sent, followed by its NUL in the datagram
+        std::string_view options; ///< NUL terminated name/value pairs after the mode, may be empty
+    } request_view_t;
+
+    /// @brief Parsed Data packet, the payload points into the received datagram
+    typedef struct data_view_s
+    {
+        uint16_t block_number; ///< Block number in host byte order
+        std::string_view payload; ///< Bytes after the header, empty for the last block of a multiple of the block size
+    } data_view_t;
+
+    /// @brief Parsed ACK packet, the options point into the received datagram
+    typedef struct ack_view_s
+    {
+        uint16_t block_number; ///< Acknowledged block in host byte order
+        std::string_view options; ///< Name/value pairs after the header, only the final ACK carries any
+    } ack_view_t;
+
+    /// @brief Parsed Error packet, the message points into the received datagram
+    typedef struct error_view_s
+    {
+        uint16_t error_code; ///< One of the ERR_CODE_* values in host byte order
+        std::string_view message; ///< Message up to its NUL or the end of the datagram
+    } error_view_t;
+
+    /// @brief Parsed OACK packet, the options point into the received datagram
+    typedef struct oack_view_s
+    {
+        std::string_view options; ///< NUL terminated name/value pairs after the header
+    } oack_view_t;
 
     /// @brief Packet type for data transfer operations
     typedef struct packet_s
@@ -44,6 +219,150 @@ namespace YB
         int data_block_number; ///< Data buffer block number
     } packet_t;
 
+    /// @brief Non owning view of a packet encoded into a buffer kept elsewhere
+    typedef struct packet_view_s
+    {
+        const char* data; ///< First byte of the packet
+        int size; ///< Bytes at data
+        int64_t data_block_number; ///< Data block number counted from the start of the transfer, -1 for other packets
+        const char* payload = nullptr; ///< Payload sent right after data, nullptr if data holds the whole packet
+        int payload_size = 0; ///< Bytes at payload
+    } packet_view_t;
+
+    /// @brief Options negotiated for a single transfer (RFC 2347)
+    typedef struct transfer_options_s
+    {
+        int negotiated = 0; ///< OPTION_* flags of the options present in the request or OACK
+        int block_size = TFTP_DEFAULT_BLOCK_SIZE; ///< Payload bytes of a full data block (RFC 2348)
+        int window_size = TFTP_DEFAULT_WINDOW_SIZE; ///< Data blocks in flight before an ACK (RFC 7440)
+        int timeout = 0; ///< Retransmission timeout in seconds, 0 if estimated (RFC 2349)
+        int64_t transfer_size = 0; ///< File size in bytes, 0 in a RRQ asks the server for it (RFC 2349)
+        transfer_mode_t mode = TRANSFER_MODE_OCTET; ///< Mode of the request, not an option
+        uint32_t checksum = 0; ///< CRC32C of the payload, 0 in a request and OACK, carried by the final ACK (vendor option)
+        rollover_policy_t rollover = ROLLOVER_POLICY_ZERO; ///< Block number after 65535 (vendor option)
+        int64_t offset = 0; ///< File offset of the first byte transferred (vendor option)
+        int64_t length = 0; ///< Bytes transferred from offset, up to the end of the file without the option (vendor option)
+        int64_t modified_time = 0; ///< Modification time of the file in nanoseconds since the epoch, 0 in a RRQ asks the server for it (vendor option)
+    } transfer_options_t;
+
+    /// @brief What a receiver should do with an incoming data block
+    typedef enum data_verdict_e
+    {
+        DATA_VERDICT_STORE, ///< Next block in order, store it.
+        DATA_VERDICT_STORE_AND_ACK, ///< Next block in order which ends a window or the file, store and acknowledge it.
+        DATA_VERDICT_ACK, ///< Out of order block, acknowledge the last block received in order.
+        DATA_VERDICT_IGNORE ///< Out of order block which needs no answer.
+    } data_verdict_t;
+
+    /// @brief Outcome of resolving a requested file name in a storage backend
+    typedef enum storage_status_e
+    {
+        STORAGE_STATUS_FOUND, ///< The name resolved, the transfer can start.
+        STORAGE_STATUS_NOT_FOUND, ///< A RRQ names no readable file.
+        STORAGE_STATUS_OUTSIDE_ROOT, ///< The name resolves outside the served files.
+        STORAGE_STATUS_READ_ONLY, ///< A WRQ to a backend which takes no uploads.
+        STORAGE_STATUS_RESERVED, ///< The name is one the server gives to unfinished uploads.
+        STORAGE_STATUS_NOT_REGULAR ///< A WRQ names a directory or another object which is not a regular file.
+    } storage_status_t;
+
+    /// @brief How a finished WRQ upload is made durable before it is renamed into place
+    typedef enum sync_policy_e
+    {
+        SYNC_POLICY_NONE, ///< Rename right away, the page cache is flushed whenever the kernel likes.
+        SYNC_POLICY_FILE, ///< Flush every file and its directory on its own.
+        SYNC_POLICY_GROUP ///< Flush all uploads finishing together with one flush per file system.
+    } sync_policy_t;
+
+    /// @brief Part a side plays in a transfer, whatever the request was
+    typedef enum transfer_role_e
+    {
+        TRANSFER_ROLE_SENDER, ///< Sends Data blocks and receives ACKs.
+        TRANSFER_ROLE_RECEIVER ///< Receives Data blocks and sends ACKs.
+    } transfer_role_t;
+
+    /// @brief Outcome of waiting for a packet of a coroutine session
+    typedef enum receive_status_e
+    {
+        RECEIVE_STATUS_OK, ///< The expected packet arrived and was parsed.
+        RECEIVE_STATUS_UNEXPECTED, ///< Another packet arrived, the session keeps it for inspection.
+        RECEIVE_STATUS_PEER_ERROR, ///< The peer ended the transfer with an Error packet.
+        RECEIVE_STATUS_TIMED_OUT ///< The peer stopped answering and the retries ran out.
+    } receive_status_t;
+
+    /// @brief Outcome of a transfer run by the asynchronous client
+    typedef enum transfer_status_e
+    {
+        TRANSFER_STATUS_COMPLETE, ///< Every block arrived, and the checksum matched if it was negotiated.
+        TRANSFER_STATUS_SERVER_ERROR, ///< The server ended the transfer with an Error packet.
+        TRANSFER_STATUS_TIMED_OUT, ///< The server stopped answering and the retries ran out.
+        TRANSFER_STATUS_FILE_ERROR, ///< The local file could not be opened, read or written.
+        TRANSFER_STATUS_PROTOCOL_ERROR, ///< The server sent an unexpected packet or unacceptable options.
+        TRANSFER_STATUS_CHECKSUM_MISMATCH, ///< The server reported another CRC32C than the one of the payload sent.
+        TRANSFER_STATUS_SOCKET_ERROR, ///< The socket of the transfer could not be created.
+        TRANSFER_STATUS_CHECKPOINT_STALE, ///< The journal no longer matches the source or the server, it was dropped to start over.
+        TRANSFER_STATUS_SOURCE_CHANGED, ///< The file on the server changed between the stripes of one download.
+        TRANSFER_STATUS_SKIPPED ///< The destination already had the size and modification time of the source, nothing was sent.
+    } transfer_status_t;
+
+    /// @brief Progress of a transfer run by the asynchronous client
+    typedef struct transfer_progress_s
+    {
+        int64_t bytes = 0; ///< Payload bytes sent for the first time, or received in order
+        int64_t total_bytes = -1; ///< Size of the file, from the local file or the tsize option, -1 if unknown
+        int64_t blocks = 0; ///< Data blocks sent for the first time, or received in order
+        int retransmissions = 0; ///< Expired retransmission timers
+    } transfer_progress_t;
+
+    /// @brief Final report of a transfer run by the asynchronous client
+    typedef struct transfer_result_s
+    {
+        transfer_status_t status = TRANSFER_STATUS_COMPLETE; ///< How the transfer ended
+        std::string message; ///< Error message of the server or reason of the failure, empty on success
+        transfer_progress_t progress; ///< Counters when the transfer ended
+        uint32_t checksum = 0; ///< CRC32C of the payload sent or received
+        transfer_options_t options; ///< Options the transfer ran with
+        std::chrono::microseconds queue_time{0}; ///< Time between the submission and the request
+        std::chrono::microseconds transfer_time{0}; ///< Time between the request and the end
+        std::chrono::microseconds srtt{0}; ///< Smoothed round trip time to the server
+    } transfer_result_t;
+
+    /// @brief Verified progress of a transfer, kept in the journal of the client to resume it
+    typedef struct transfer_checkpoint_s
+    {
+        transfer_type_t transfer_type = TRANSFER_TYPE_RRQ; ///< Direction of the transfer
+        int64_t file_size = 0; ///< Size of the source file when the transfer started
+        int64_t modified_time = 0; ///< Modification time of the source file when the transfer started
+        int64_t offset = 0; ///< Bytes at the start of the file stored by the receiver
+        uint32_t digest = 0; ///< CRC32C of the bytes before offset
+    } transfer_checkpoint_t;
+
+    /// @brief One file of a sync manifest
+    typedef struct sync_entry_s
+    {
+        std::string remote_name; ///< Name of the file on the server
+        std::string local_path; ///< Path of the file on this host
+        transfer_type_t direction = TRANSFER_TYPE_RRQ; ///< TRANSFER_TYPE_RRQ to download, TRANSFER_TYPE_WRQ to upload
+    } sync_entry_t;
+
+    /// @brief Totals of a sync run
+    typedef struct sync_summary_s
+    {
+        size_t entries = 0; ///< Entries of the manifest
+        size_t transferred = 0; ///< Entries whose file was sent or received
+        size_t skipped = 0; ///< Entries whose destination was already up to date
+        size_t failed = 0; ///< Entries whose transfer failed
+        int64_t bytes = 0; ///< Payload bytes of the transferred entries
+        std::chrono::microseconds elapsed{0}; ///< Time from the first request to the last result
+    } sync_summary_t;
+
+    /// @brief Kind of an io_uring request of the server
+    typedef enum uring_op_e
+    {
+        URING_OP_RECEIVE = 1, ///< Multishot receive of a socket.
+        URING_OP_READ, ///< Read of RRQ file blocks.
+        URING_OP_WRITE ///< Write of a WRQ file block.
+    } uring_op_t;
+
 } // YB
 
 #endif //TFTP_SEVER_AND_CLIENT_TYPES_ENUMS_MACROS_HPP
@@ -0,0 +1,301 @@
+///
+/// @file main.cpp
+/// @author Yasin BASAR
+/// @brief Benchmarks the scalar, SSE2 and AVX2 netascii kernels and checks
+///        them against a byte by byte reference translation on random text
+///        split at random block boundaries.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <tftp_netascii.hpp>
+
+/// @brief Names of the kernels, in the order of netascii_kernel_t.
+static const char* const kernel_names[] = {"scalar", "sse2", "avx2"};
+
+/// @brief Encodes local text in one go, LF to CR LF and CR to CR NUL.
+static std::string reference_encode(const std::string& text)
+{
+    std::string encoded;
+
+    for (const char byte : text)
+    {
+        if (byte == '\n')
+        {
+            encoded += "\r\n";
+        }
+        else if (byte == '\r')
+        {
+            encoded += std::string("\r\0", 2);
+        }
+        else
+        {
+            encoded += byte;
+        }
+    }
+
+    return encoded;
+}
+
+/// @brief Decodes netascii in one go, a CR followed by anything else than LF
+///        or NUL is kept, as is a CR at the end.
+static std::string reference_decode(const std::string& encoded)
+{
+    std::string text;
+
+    for (size_t i = 0; i < encoded.size(); ++i)
+    {
+        if (encoded[i] == '\r' && i + 1 < encoded.size() && (encoded[i + 1] == '\n' || encoded[i + 1] == '\0'))
+        {
+            text += encoded[++i] == '\n' ? '\n' : '\r';
+        }
+        else
+        {
+            text += encoded[i];
+        }
+    }
+
+    return text;
+}
+
+/// @brief Returns random bytes, line ends, NULs and plain runs long enough
+///        for the vector loops.
+static std::string make_random_text(std::mt19937& random, size_t size)
+{
+    static const char special[] = {'\r', '\n', '\0'};
+    std::uniform_int_distribution<int> pick(0, 99);
+    std::uniform_int_distribution<int> plain(' ', '~');
+    const int density = pick(random) % 40;
+    std::string text(size, ' ');
+
+    for (char& byte : text)
+    {
+        byte = pick(random) < density ? special[pick(random) % 3] : static_cast<char>(plain(random));
+    }
+
+    return text;
+}
+
+/// @brief Byte the output is filled with past the room a call is given.
+static constexpr char guard_byte = 0x5A;
+
+/// @brief Returns true if a call wrote past the room it was given.
+static bool is_overrun(const std::vector<char>& output, size_t room)
+{
+    return std::any_of(output.begin() + static_cast<std::ptrdiff_t>(room), output.end(),
+                       [](char byte) { return byte != guard_byte; });
+}
+
+/// @brief Encodes text with random input and output sizes per call.
+/// @param overrun Set if a call wrote past its output.
+static std::string encode_split(YB::netascii_kernel_t kernel, std::mt19937& random, const std::string& text,
+                                bool& overrun)
+{
+    YB::TFTPNetascii netascii(kernel);
+    std::uniform_int_distribution<size_t> input_size(0, 100);
+    std::uniform_int_distribution<int> output_size(1, 100);
+    std::string encoded;
+    std::vector<char> output(164);
+    size_t offset = 0;
+
+    while (offset < text.size() || netascii.has_pending())
+    {
+        const size_t size = std::min(input_size(random), text.size() - offset);
+        const int room = output_size(random);
+        size_t consumed = 0;
+        std::fill(output.begin(), output.end(), guard_byte);
+        const int produced = netascii.encode(text.data() + offset, size, consumed, output.data(), room);
+
+        overrun |= is_overrun(output, static_cast<size_t>(room));
+        encoded.append(output.data(), static_cast<size_t>(produced));
+        offset += consumed;
+    }
+
+    return encoded;
+}
+
+/// @brief Encodes text through encode_block() with a random block size.
+static std::string encode_blocks(YB::netascii_kernel_t kernel, std::mt19937& random, const std::string& text)
+{
+    YB::TFTPNetascii netascii(kernel);
+    std::istringstream file(text);
+    const int block_size = std::uniform_int_distribution<int>(1, 1500)(random);
+    std::vector<char> block(static_cast<size_t>(block_size));
+    std::string encoded;
+
+    while (true)
+    {
+        const int produced = netascii.encode_block(file, block.data(), block_size);
+        encoded.append(block.data(), static_cast<size_t>(produced));
+
+        if (produced < block_size)
+        {
+            return encoded;
+        }
+    }
+}
+
+/// @brief Decodes netascii with a random input size per call.
+/// @param overrun Set if a call wrote past input size + 1 bytes.
+static std::string decode_split(YB::netascii_kernel_t kernel, std::mt19937& random, const std::string& encoded,
+                                bool& overrun)
+{
+    YB::TFTPNetascii netascii(kernel);
+    std::uniform_int_distribution<size_t> input_size(0, 100);
+    std::string text;
+    std::vector<char> output(165);
+    size_t offset = 0;
+
+    while (offset < encoded.size())
+    {
+        const size_t size = std::min(input_size(random), encoded.size() - offset);
+        std::fill(output.begin(), output.end(), guard_byte);
+        text.append(output.data(), static_cast<size_t>(netascii.decode(encoded.data() + offset, size, output.data())));
+        overrun |= is_overrun(output, size + 1);
+        offset += size;
+    }
+
+    text.append(output.data(), static_cast<size_t>(netascii.finish_decode(output.data())));
+
+    return text;
+}
+
+/// @brief Compares a kernel with the reference translation.
+/// @return Number of mismatches.
+static int check_kernel(YB::netascii_kernel_t kernel, int rounds)
+{
+    std::mt19937 random(static_cast<unsigned>(kernel) + 1);
+    std::uniform_int_distribution<size_t> text_size(0, 4096);
+    int failures = 0;
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        const std::string text = make_random_text(random, text_size(random));
+        const std::string encoded = reference_encode(text);
+        bool overrun = false;
+
+        // Random bytes are malformed netascii too, decoding must still match.
+        failures += encode_split(kernel, random, text, overrun) != encoded;
+        failures += encode_blocks(kernel, random, text) != encoded;
+        failures += decode_split(kernel, random, encoded, overrun) != text;
+        failures += decode_split(kernel, random, text, overrun) != reference_decode(text);
+        failures += overrun;
+    }
+
+    return failures;
+}
+
+/// @brief Prints the encode and decode throughput of a kernel.
+static void bench_kernel(YB::netascii_kernel_t kernel, const std::string& text)
+{
+    constexpr int block_size = 1428;
+    constexpr int passes = 16;
+    YB::TFTPNetascii netascii(kernel);
+    std::vector<char> output(block_size + 1);
+    std::string encoded;
+
+    const auto encode_begin = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        encoded.clear();
+        size_t offset = 0;
+
+        while (offset < text.size() || netascii.has_pending())
+        {
+            size_t consumed = 0;
+            const int produced = netascii.encode(text.data() + offset, text.size() - offset, consumed,
+                                                 output.data(), block_size);
+            encoded.append(output.data(), static_cast<size_t>(produced));
+            offset += consumed;
+        }
+    }
+
+    const auto decode_begin = std::chrono::steady_clock::now();
+    size_t decoded = 0;
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (size_t offset = 0; offset < encoded.size(); offset += block_size)
+        {
+            const size_t size = std::min<size_t>(block_size, encoded.size() - offset);
+            decoded += static_cast<size_t>(netascii.decode(encoded.data() + offset, size, output.data()));
+        }
+
+        decoded += static_cast<size_t>(netascii.finish_decode(output.data()));
+    }
+
+    const auto decode_end = std::chrono::steady_clock::now();
+    const double bytes = static_cast<double>(text.size()) * passes;
+    const double encode_s = std::chrono::duration<double>(decode_begin - encode_begin).count();
+    const double decode_s = std::chrono::duration<double>(decode_end - decode_begin).count();
+
+    std::cout << "  " << kernel_names[kernel] << ": encode " << bytes / encode_s / 1e6 << " MB/s, decode "
+              << bytes / decode_s / 1e6 << " MB/s" << (decoded == text.size() * passes ? "" : " (size mismatch)")
+              << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+    const bool check_only = argc > 1 && std::strcmp(argv[1], "check") == 0;
+    const YB::netascii_kernel_t kernels[] = {YB::NETASCII_KERNEL_SCALAR, YB::NETASCII_KERNEL_SSE2,
+                                             YB::NETASCII_KERNEL_AVX2};
+    int failures = 0;
+
+    for (const YB::netascii_kernel_t kernel : kernels)
+    {
+        // A kernel the processor lacks is lowered, the one below is checked already.
+        if (YB::TFTPNetascii(kernel).get_kernel() != kernel)
+        {
+            std::cout << kernel_names[kernel] << ": not supported, skipped.\n";
+            continue;
+        }
+
+        const int kernel_failures = check_kernel(kernel, 2000);
+        std::cout << kernel_names[kernel] << ": " << kernel_failures << " mismatches.\n";
+        failures += kernel_failures;
+    }
+
+    if (check_only || failures != 0)
+    {
+        return failures == 0 ? 0 : 1;
+    }
+
+    std::mt19937 random(42);
+    const double densities[] = {0.0, 0.01, 0.05};
+
+    for (const double density : densities)
+    {
+        std::string text(std::size_t{16} << 20, ' ');
+        std::uniform_real_distribution<double> line_end(0.0, 1.0);
+        std::uniform_int_distribution<int> plain(' ', '~');
+
+        for (char& byte : text)
+        {
+            byte = line_end(random) < density ? '\n' : static_cast<char>(plain(random));
+        }
+
+        std::cout << "16 MiB, " << density * 100 << "% line ends:\n";
+
+        for (const YB::netascii_kernel_t kernel : kernels)
+        {
+            if (YB::TFTPNetascii(kernel).get_kernel() == kernel)
+            {
+                bench_kernel(kernel, text);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* end of file */
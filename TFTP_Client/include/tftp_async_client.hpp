@@ -0,0 +1,217 @@
+///
+/// @file tftp_async_client.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPAsyncClient class,
+///        which runs many client transfers from a single event loop.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_ASYNC_CLIENT_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_ASYNC_CLIENT_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "tftp_client_transfer.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <socket_macros.hpp>
+#include <tftp_reactor.hpp>
+
+namespace YB
+{
+    /// @class TFTPAsyncClient
+    /// @brief Runs many file transfers, to any number of servers, from the
+    ///        thread which calls run() or poll(). Transfers are queued by
+    ///        receive_file() and send_file(), which return at once with a
+    ///        future of the result. At most the concurrency limit of them run
+    ///        at a time, each a coroutine on its own socket, resumed by one
+    ///        reactor which multiplexes the sockets with a poller and the
+    ///        retransmission deadlines with a timing wheel. Submitting and polling
+    ///        must happen on the same thread, the futures may be waited on
+    ///        by any other.
+    class TFTPAsyncClient
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPAsyncClient(TFTPAsyncClient &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPAsyncClient &operator=(TFTPAsyncClient &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPAsyncClient(const TFTPAsyncClient &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPAsyncClient &operator=(TFTPAsyncClient const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Called on the loop thread whenever a transfer moved forward.
+        typedef std::function<void(const transfer_progress_t&)> progress_callback_t;
+
+        /// @brief Called on the loop thread when a transfer ended, before its future is ready.
+        typedef std::function<void(const transfer_result_t&)> completion_callback_t;
+
+        /// @brief Constructor for TFTPAsyncClient.
+        TFTPAsyncClient();
+
+        /// @brief Destructor for TFTPAsyncClient. Transfers still queued or
+        ///        running are dropped and their futures report a broken promise.
+        ~TFTPAsyncClient();
+
+        /// @brief Sets how many transfers run at once, the others wait in
+        ///        the order they were submitted.
+        /// @param max_concurrency Running transfers, at least 1.
+        void set_max_concurrency(int max_concurrency);
+
+        /// @brief Sets the block size requested by the following transfers.
+        /// @param block_size Payload bytes per data block, 8 to 65464.
+        void set_block_size(int block_size);
+
+        /// @brief Sets the window size requested by the following transfers.
+        /// @param window_size Data blocks in flight before an ACK, 1 to 64.
+        void set_window_size(int window_size);
+
+        /// @brief Sets the retransmission timeout requested by the following transfers.
+        /// @param seconds Timeout in seconds, 1 to 255, 0 follows the round trip time.
+        void set_timeout(int seconds);
+
+        /// @brief Sets the mode of the following transfers.
+        /// @param mode TRANSFER_MODE_OCTET or TRANSFER_MODE_NETASCII.
+        void set_transfer_mode(transfer_mode_t mode);
+
+        /// @brief Enables the crc32c vendor option for the following transfers, on by default.
+        /// @param enabled False to leave the option out of the requests.
+        void set_checksum(bool enabled);
+
+        /// @brief Sets the block number which follows 65535 in the following transfers.
+        /// @param rollover ROLLOVER_POLICY_ZERO, the default, or ROLLOVER_POLICY_ONE.
+        void set_rollover_policy(rollover_policy_t rollover);
+
+        /// @brief Sets how many retransmissions in a row end a transfer.
+        /// @param max_retries Number of retransmissions before giving up, 0 to TFTP_MAX_RETRIES.
+        /// @throw std::runtime_error if the number is out of range.
+        void set_max_retries(int max_retries);
+
+        /// @brief Makes the following transfers skip a file whose destination
+        ///        already has the size and modification time of the source,
+        ///        they end with TRANSFER_STATUS_SKIPPED. Off by default.
+        /// @param enabled True to compare the files with the tsize and mtime options.
+        void set_sync(bool enabled);
+
+        /// @brief Queues the download of a file.
+        /// @param server_ip IPv4 address of the server.
+        /// @param port Port of the server.
+        /// @param remote_name Name of the file on the server.
+        /// @param local_path Path the file is saved to.
+        /// @param on_complete Called when the transfer ended, may be empty.
+        /// @param on_progress Called as blocks arrive, may be empty.
+        /// @return The result of the transfer once it ended.
+        std::future<transfer_result_t> receive_file(const char* server_ip, int port,
+                                                    const std::string& remote_name,
+                                                    const std::string& local_path,
+                                                    completion_callback_t on_complete = {},
+                                                    progress_callback_t on_progress = {});
+
+        /// @brief Queues the upload of a file.
+        /// @param server_ip IPv4 address of the server.
+        /// @param port Port of the server.
+        /// @param local_path Path of the file to send.
+        /// @param remote_name Name the file is stored under on the server.
+        /// @param on_complete Called when the transfer ended, may be empty.
+        /// @param on_progress Called as the window moves forward, may be empty.
+        /// @return The result of the transfer once it ended.
+        std::future<transfer_result_t> send_file(const char* server_ip, int port,
+                                                 const std::string& local_path,
+                                                 const std::string& remote_name,
+                                                 completion_callback_t on_complete = {},
+                                                 progress_callback_t on_progress = {});
+
+        /// @brief Starts queued transfers up to the concurrency limit, waits
+        ///        for socket events or deadlines and handles them once.
+        /// @param timeout_ms Maximum time to wait, -1 waits for the next event.
+        /// @return True while transfers are queued or running.
+        bool poll(int timeout_ms);
+
+        /// @brief Runs the event loop until every submitted transfer ended,
+        ///        including those submitted by the callbacks.
+        void run();
+
+        /// @brief Returns the number of transfers waiting for a free slot.
+        size_t get_queued_count() const;
+
+        /// @brief Returns the number of running transfers.
+        size_t get_running_count() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief A submitted transfer and what its submitter waits on.
+        typedef struct job_s
+        {
+            std::unique_ptr<TFTPClientTransfer> transfer; ///< The transfer.
+            std::promise<transfer_result_t> promise; ///< Fulfilled when the transfer ended.
+            completion_callback_t on_complete; ///< Called when the transfer ended.
+            progress_callback_t on_progress; ///< Called when the transfer moved forward.
+            int64_t reported_blocks = 0; ///< Blocks of the last progress report.
+        } job_t;
+
+        /// @brief Queues a transfer with the current options.
+        /// @return The result of the transfer once it ended.
+        std::future<transfer_result_t> submit(const char* server_ip, int port,
+                                              transfer_type_t transfer_type,
+                                              const std::string& remote_name,
+                                              const std::string& local_path,
+                                              completion_callback_t on_complete,
+                                              progress_callback_t on_progress);
+
+        /// @brief Starts queued transfers until the concurrency limit is reached.
+        void start_transfers();
+
+        /// @brief Reports the progress of a transfer the reactor resumed, or
+        ///        hands its result over once it ended.
+        /// @param transfer The transfer.
+        void on_resumed(TFTPClientTransfer* transfer);
+
+        /// @brief Hands the result of an ended transfer to its submitter.
+        /// @param job The job of the transfer.
+        static void fulfil(job_t& job);
+
+        std::unique_ptr<TFTPReactor> m_reactor; ///< Event loop resuming the transfers.
+        std::deque<std::unique_ptr<job_t>> m_queued; ///< Transfers waiting for a free slot, oldest first.
+        std::unordered_map<TFTPClientTransfer*, std::unique_ptr<job_t>> m_running; ///< Running transfers.
+        std::vector<void*> m_resumed; ///< Scratch list of the transfers the reactor resumed.
+        transfer_options_t m_requested_options; ///< Options requested by the following transfers.
+        int m_max_retries; ///< Retransmissions in a row which end a transfer.
+        int m_max_concurrency; ///< Transfers running at once.
+        bool m_sync; ///< Transfers skip an up to date destination.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_ASYNC_CLIENT_HPP
+
+/* End of File */
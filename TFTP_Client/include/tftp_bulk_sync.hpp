@@ -0,0 +1,123 @@
+///
+/// @file tftp_bulk_sync.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPBulkSync class,
+///        which brings the files of a manifest up to date with one server.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_BULK_SYNC_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_BULK_SYNC_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "tftp_async_client.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPBulkSync
+    /// @brief Downloads and uploads the entries of a manifest over one
+    ///        TFTPAsyncClient, so the socket layer is set up once for
+    ///        thousands of files. Only a bounded number of entries is in
+    ///        flight: each finished entry submits the next one. Every
+    ///        transfer runs in sync mode, an entry whose destination already
+    ///        has the size and modification time of its source costs one
+    ///        round trip and is counted as skipped.
+    class TFTPBulkSync
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPBulkSync(TFTPBulkSync &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPBulkSync &operator=(TFTPBulkSync &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPBulkSync(const TFTPBulkSync &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPBulkSync &operator=(TFTPBulkSync const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPBulkSync.
+        /// @param server_ip IPv4 address of the server.
+        /// @param port Port of the server.
+        TFTPBulkSync(std::string server_ip, int port);
+
+        /// @brief Destructor for TFTPBulkSync.
+        ~TFTPBulkSync() = default;
+
+        /// @brief Returns the client which runs the entries, its setters
+        ///        choose the options of the transfers.
+        TFTPAsyncClient& get_client();
+
+        /// @brief Sets how many entries are in flight at once.
+        /// @param max_sessions Concurrent sessions, 1 to TFTP_CLIENT_MAX_CONCURRENCY.
+        void set_max_sessions(int max_sessions);
+
+        /// @brief Reads a manifest. Every line holds one entry as
+        ///        "<remote> <local> <get|put>" separated by blanks; empty
+        ///        lines and lines starting with '#' are ignored.
+        /// @param manifest_path Path of the manifest.
+        /// @return The entries in the order of the manifest.
+        /// @throw std::runtime_error if the manifest cannot be read or a line is malformed.
+        static std::vector<sync_entry_t> load_manifest(const std::string& manifest_path);
+
+        /// @brief Runs every entry to its end. Failed entries are reported as
+        ///        they end and do not stop the others.
+        /// @param entries The entries to bring up to date.
+        /// @return The totals of the run.
+        sync_summary_t run(const std::vector<sync_entry_t>& entries);
+
+        /// @brief Prints the totals and the throughput of a run.
+        /// @param summary The totals of the run.
+        static void print_summary(const sync_summary_t& summary);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Submits the next entry of the manifest, if one is left.
+        void submit_next();
+
+        /// @brief Counts the result of an entry and submits the next one.
+        /// @param index Index of the entry in the manifest.
+        /// @param result Result of its transfer.
+        void on_complete(size_t index, const transfer_result_t& result);
+
+        TFTPAsyncClient m_client; ///< Client running the transfers of the entries.
+        std::string m_server_ip; ///< IPv4 address of the server.
+        int m_port; ///< Port of the server.
+        int m_max_sessions; ///< Entries in flight at once.
+        const std::vector<sync_entry_t>* m_entries; ///< Entries of the running sync, nullptr outside run().
+        size_t m_next; ///< Index of the next entry to submit.
+        sync_summary_t m_summary; ///< Totals of the running sync.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_BULK_SYNC_HPP
+
+/* End of File */
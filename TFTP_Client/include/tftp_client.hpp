@@ -15,52 +15,28 @@
 // Project Includes
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef _WIN32
-#include <WinSock2.h> /*Windows socket architecture*/
-
-typedef int socklen_t;
-
-#define GET_LAST_ERROR() std::to_string(WSAGetLastError())
-#define CLOSE_SOCKET(s) closesocket(s)
-#define CLEANUP() WSACleanup();
-#endif
-
-#ifdef __linux__
-#include <sys/socket.h> /*Linux socket architecture*/
-#include <netinet/in.h> /*Internet socket structures*/
-#include <arpa/inet.h> /*Contains inet_ functions*/
-#include <unistd.h> /*Contains close() function for linux file describers*/
-
-#include <algorithm> /*Contains std::replace()*/
-#include <cstring> /*Contains memset()*/
-
-typedef int SOCKET;
-typedef sockaddr SOCKADDR;
-typedef sockaddr_in SOCKADDR_IN;
-typedef sockaddr_storage SOCKADDR_STORAGE_LH;
-
-#define SOCKET_ERROR (-1)
-#define INVALID_SOCKET 0
-
-#define GET_LAST_ERROR() std::string(strerror(errno))
-#define CLOSE_SOCKET(s) close(s)
-#define CLEANUP()
-#endif
-
 #include <string>
 #include <memory>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Third Party Includes
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <socket_macros.hpp>
 #include <tftp.hpp>
+#include <tftp_reactor.hpp>
 
 namespace YB
 {
+    class TFTPClientTransfer;
+
     /// @class TFTPClient
     /// @brief The TFTPClient class provides methods for sending and receiving
-    ///        files using the TFTP protocol.
+    ///        files using the TFTP protocol. Every call runs the coroutine of
+    ///        a TFTPClientTransfer on a private reactor and returns once it
+    ///        ended, so the blocking and the asynchronous client share one
+    ///        implementation of the protocol.
     class TFTPClient
     {
     public:
@@ -83,9 +59,66 @@ namespace YB
         /// @brief Destructor for TFTPClient.
         ~TFTPClient();
 
-        /// @brief Creates a socket for TFTP communication.
+        /// @brief Sets the server of the following transfers. Every transfer
+        ///        creates a socket of its own, its transfer identifier.
+        /// @param server_ip IPv4 address of the server.
+        /// @param port Port of the server.
         void create_socket(const char* server_ip, int port);
 
+        /// @brief Sets the block size requested with the blksize option (RFC 2348).
+        ///        The server may answer with a smaller one, 512 disables the option.
+        /// @param block_size Payload bytes per data block, 8 to 65464.
+        void set_block_size(int block_size);
+
+        /// @brief Sets the window size requested with the windowsize option (RFC 7440).
+        ///        The server may answer with a smaller one, 1 disables the option.
+        /// @param window_size Data blocks in flight before an ACK, 1 to 64.
+        void set_window_size(int window_size);
+
+        /// @brief Sets the retransmission timeout requested with the timeout
+        ///        option (RFC 2349). Without it the timeout follows the measured
+        ///        round trip time.
+        /// @param seconds Timeout in seconds, 1 to 255, 0 disables the option.
+        void set_timeout(int seconds);
+
+        /// @brief Sets the mode of the following transfers. Netascii sends
+        ///        text with CR LF line ends and stores it with LF ones.
+        /// @param mode TRANSFER_MODE_OCTET or TRANSFER_MODE_NETASCII.
+        void set_transfer_mode(transfer_mode_t mode);
+
+        /// @brief Enables the crc32c vendor option, on by default. The
+        ///        receiver of a transfer reports the CRC32C of the payload it
+        ///        got in its final ACK and the sender compares it with the
+        ///        payload it sent, so send_file() fails if the server stored
+        ///        anything else. Servers which ignore the option are served
+        ///        without it.
+        /// @param enabled False to leave the option out of the requests.
+        void set_checksum(bool enabled);
+
+        /// @brief Returns the CRC32C of the payload of the last transfer, 0
+        ///        after a striped download whose stripes are verified one by one.
+        uint32_t get_checksum() const;
+
+        /// @brief Sets the block number which follows 65535, needed by files
+        ///        of more than 65535 blocks. ROLLOVER_POLICY_ONE is requested
+        ///        with the rollover option and a value the server acknowledges
+        ///        wins; servers which ignore the option must wrap the same way.
+        /// @param rollover ROLLOVER_POLICY_ZERO, the default, or ROLLOVER_POLICY_ONE.
+        void set_rollover_policy(rollover_policy_t rollover);
+
+        /// @brief Sets how many retransmissions in a row end a transfer.
+        /// @param max_retries Number of retransmissions before giving up, 0 to TFTP_MAX_RETRIES.
+        /// @throw std::runtime_error if the number is out of range.
+        void set_max_retries(int max_retries);
+
+        /// @brief Makes the following octet transfers resumable. Progress is
+        ///        recorded in a journal next to the local file, and a
+        ///        transfer of the same file after a failure goes on from the
+        ///        last checkpoint with the offset vendor option. A source
+        ///        file whose size or time changed since is sent again whole.
+        /// @param enabled True to keep a journal, off by default.
+        void set_resume(bool enabled);
+
         /// @brief Sends a file to the TFTP server.
         /// @param file_path The path to the file to be sent.
         void send_file(const std::string& file_path);
@@ -94,44 +127,74 @@ namespace YB
         /// @param file_path The path to save the received file.
         void receive_file(const std::string& file_path);
 
+        /// @brief Receives a large file over several concurrent sessions. An
+        ///        empty range asks the server for the size of the file, the
+        ///        output is preallocated and every session then fetches its
+        ///        own byte range with the offset and length vendor options,
+        ///        written in place with positional writes. Every stripe must
+        ///        report the size and modification time the first request saw.
+        ///        A failed download removes the output file. Needs the octet
+        ///        mode and a server which serves byte ranges.
+        /// @param file_path The path to save the received file.
+        /// @param stripe_count Number of concurrent sessions, 1 to 16, fewer
+        ///                     for files of less blocks.
+        void receive_file_striped(const std::string& file_path, int stripe_count);
+
     ////////////////////////////////////////////////////////////////////////////
     // Private Members
     ////////////////////////////////////////////////////////////////////////////
     private:
 
-        /// @brief Sends an acknowledgment packet to the server.
-        void send_ack_packet();
-
-        /// @brief Sends a data packet to the server.
-        /// @param number_of_bytes_from_last_read Number of bytes read from the file.
-        void send_data_packet(int number_of_bytes_from_last_read);
-
-        /// @brief Sends a read request (RRQ) packet to the server.
-        /// @param file_name The name of the file to be requested.
-        void send_rrq_packet(const std::string& file_name);
-
-        /// @brief Sends a write request (WRQ) packet to the server.
-        /// @param file_name The name of the file to be written.
-        void send_wrq_packet(const std::string& file_name);
-
-        /// @brief Receives data from the server.
-        /// @return The number of bytes received.
-        int receive_data_from_server();
-
-        /// @brief Sends a signal indicating that the transmission is done.
-        void send_transmission_done_signal();
-
-        /// @brief Closes the socket and cleans up the Windows Socket Architecture.
-        void close_socket_architecture() const;
-
-        std::unique_ptr<char[]> m_incoming_buffer; ///< Buffer for incoming data.
-        std::unique_ptr<char[]> m_outgoing_buffer; ///< Buffer for outgoing data.
-
-        SOCKET m_client_socket; ///< Client socket descriptor.
+        /// @brief Runs a transfer to its end and throws if it failed.
+        /// @param transfer_type TRANSFER_TYPE_RRQ to download, TRANSFER_TYPE_WRQ to upload.
+        /// @param file_path Path of the file on this host, its name is the one on the server.
+        void run_transfer(transfer_type_t transfer_type, const std::string& file_path);
+
+        /// @brief Fetches the size of the file and downloads its stripes
+        ///        into the open output file.
+        /// @param fd The output file.
+        /// @param file_name Name of the file on the server.
+        /// @param local_path Path of the output file.
+        /// @param stripe_count Most concurrent sessions.
+        /// @return The reason of the first failure, empty on success.
+        std::string receive_stripes(int fd, const std::string& file_name,
+                                    const std::string& local_path, int stripe_count);
+
+        /// @brief Runs the reactor until a started transfer ended, the other
+        ///        started transfers run along.
+        /// @param transfer A started transfer.
+        void wait_for(TFTPClientTransfer& transfer);
+
+        /// @brief Turns a local path into its canonical form.
+        /// @param file_path Path of the file on this host.
+        /// @param file_name Filled with the name of the file, the one on the server.
+        /// @return The canonical path.
+        static std::string resolve_path(const std::string& file_path, std::string& file_name);
+
+        /// @brief Creates or truncates the output file of a striped download.
+        /// @param local_path Path of the file.
+        /// @return The descriptor of the file, negative on failure.
+        static int open_output_file(const std::string& local_path);
+
+        /// @brief Reserves the disk space of the whole file and sets its size,
+        ///        the stripes then write into place.
+        /// @param fd The output file.
+        /// @param size Size of the file in bytes.
+        /// @return False if the disk has no room for the file.
+        static bool preallocate_output_file(int fd, int64_t size);
+
+        /// @brief Closes the output file of a striped download.
+        /// @param fd The output file.
+        /// @return False if the last writes failed.
+        static bool close_output_file(int fd);
+
+        std::unique_ptr<TFTPReactor> m_reactor; ///< Event loop of the running transfer.
+        std::vector<void*> m_resumed; ///< Scratch list of the reactor.
+        transfer_options_t m_requested_options; ///< Options sent with RRQ and WRQ.
+        int m_max_retries; ///< Retransmissions in a row which end a transfer.
+        uint32_t m_checksum; ///< CRC32C of the payload of the last transfer.
+        bool m_resume; ///< Transfers keep a checkpoint journal.
         SOCKADDR_IN m_server_info; ///< Server socket address information.
-        SOCKADDR_IN m_peer; ///< Peer socket address information.
-
-        socklen_t m_addr_size; ///< Size of the socket address structure.
 
     ////////////////////////////////////////////////////////////////////////////
     // Protected Members
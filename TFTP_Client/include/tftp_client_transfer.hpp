@@ -0,0 +1,271 @@
+///
+/// @file tftp_client_transfer.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPClientTransfer class,
+///        which runs a single client transfer as a coroutine.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_CLIENT_TRANSFER_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_CLIENT_TRANSFER_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <socket_macros.hpp>
+#include <tftp.hpp>
+#include <tftp_checksum.hpp>
+#include <tftp_co_session.hpp>
+#include <tftp_netascii.hpp>
+#include <tftp_packet.hpp>
+#include <tftp_reactor.hpp>
+#include <tftp_retransmitter.hpp>
+#include <tftp_task.hpp>
+#include "tftp_journal.hpp"
+
+namespace YB
+{
+    /// @class TFTPClientTransfer
+    /// @brief One file transfer between the client and a server, written as
+    ///        a coroutine over a TFTPCoSession: the download and the upload
+    ///        read as the sequence of packets they exchange, while the
+    ///        reactor which resumes them never blocks. Every transfer owns a
+    ///        non-blocking UDP socket, which is its transfer identifier
+    ///        (TID), together with its own protocol state, buffers and file,
+    ///        so any number of them run side by side on one reactor.
+    class TFTPClientTransfer
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPClientTransfer(TFTPClientTransfer &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPClientTransfer &operator=(TFTPClientTransfer &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPClientTransfer(const TFTPClientTransfer &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPClientTransfer &operator=(TFTPClientTransfer const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPClientTransfer. Nothing is opened or
+        ///        sent before start().
+        /// @param server_info Address the request is sent to.
+        /// @param transfer_type TRANSFER_TYPE_RRQ to download, TRANSFER_TYPE_WRQ to upload.
+        /// @param remote_name Name of the file on the server.
+        /// @param local_path Path of the file on this host.
+        /// @param options Mode and options to request.
+        /// @param max_retries Retransmissions in a row which end the transfer.
+        TFTPClientTransfer(const SOCKADDR_IN& server_info,
+                           transfer_type_t transfer_type,
+                           std::string remote_name,
+                           std::string local_path,
+                           const transfer_options_t& options,
+                           int max_retries);
+
+        /// @brief Destructor for TFTPClientTransfer. A running coroutine is
+        ///        dropped, then the socket is closed.
+        ~TFTPClientTransfer();
+
+        /// @brief Opens the local file, creates the socket and runs the
+        ///        coroutine of the transfer until it waits for the server.
+        /// @param reactor The reactor resuming the transfer, it outlives the transfer.
+        /// @return True if the transfer is running, false if it already ended.
+        bool start(TFTPReactor& reactor);
+
+        /// @brief Downloads only a byte range of the file with the offset and
+        ///        length vendor options, written at the same offset of a
+        ///        descriptor shared by the stripes of one file. Called before
+        ///        start(), the transfer fails if the server ignores the range.
+        /// @param fd Destination opened for writing, kept open by the caller until the transfer ended.
+        /// @param offset File offset of the first byte of the range.
+        /// @param length Number of bytes of the range.
+        void set_range(int fd, int64_t offset, int64_t length);
+
+        /// @brief Ties a ranged download to the file an earlier request of the
+        ///        same striped download saw: the OACK must report the same
+        ///        size and modification time, or the transfer fails with
+        ///        TRANSFER_STATUS_SOURCE_CHANGED. Called before start().
+        /// @param source Options of the earlier OACK, with the tsize and mtime it reported.
+        void set_source(const transfer_options_t& source);
+
+        /// @brief Keeps a checkpoint journal next to the local file of an
+        ///        octet transfer. A transfer which failed resumes from the
+        ///        checkpoint with the offset vendor option the next time,
+        ///        unless the source file changed in between. Called before start().
+        void enable_journal();
+
+        /// @brief Skips the transfer if the destination already has the size
+        ///        and modification time of the source. A download is only
+        ///        written once the OACK showed the file changed, and gets the
+        ///        time of the file on the server; an upload hands its time to
+        ///        the server with the mtime vendor option. Called before start().
+        void enable_sync();
+
+        /// @brief Returns true once the transfer ended, get_result() is then complete.
+        bool is_done() const;
+
+        /// @brief Returns the counters of the transfer so far.
+        const transfer_progress_t& get_progress() const;
+
+        /// @brief Returns the outcome of the transfer, complete once it ended.
+        const transfer_result_t& get_result() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Opens the local file for reading or writing.
+        /// @return False if the file could not be opened.
+        bool open_file();
+
+        /// @brief Downloads the file: sends the RRQ, acknowledges the OACK
+        ///        and stores the blocks until the last one.
+        /// @return False, once the transfer ended.
+        TFTPTask<bool> receive_file();
+
+        /// @brief Uploads the file: sends the WRQ and keeps the window full
+        ///        until the last block is acknowledged.
+        /// @return False, once the transfer ended.
+        TFTPTask<bool> send_file();
+
+        /// @brief Reads the next blocks of the file into the free slots of the window.
+        void send_data_packets();
+
+        /// @brief Applies the options of the OACK the session received last.
+        /// @return False if the options are not acceptable.
+        bool accept_oack_packet();
+
+        /// @brief Compares the size and modification time in the OACK with the
+        ///        ones set_source() expects, if any.
+        /// @return False if the file on the server is not the one of the other stripes.
+        bool accept_source() const;
+
+        /// @brief Opens the destination of a synced download once the server
+        ///        answered, unless the OACK describes the local file.
+        /// @return False if the transfer ended, up to date or on a file error.
+        bool accept_sync();
+
+        /// @brief Continues from the checkpoint of an earlier attempt: the
+        ///        request asks for the offset and the digest goes on from it.
+        /// @param checkpoint The checkpoint loaded from the journal.
+        void resume_from(const transfer_checkpoint_t& checkpoint);
+
+        /// @brief Checks the answer to the request against the checkpoint.
+        ///        A server which ignored the offset sends the file from its
+        ///        start, a resumed download must come from the same file.
+        /// @return False if the file on the server changed since the checkpoint.
+        bool accept_checkpoint();
+
+        /// @brief Returns true if the server refused the offset a resumed request asked for.
+        /// @param status The outcome of the wait for the first answer.
+        bool is_resume_refused(receive_status_t status) const;
+
+        /// @brief Goes back to the start of the local file, the server
+        ///        ignored the offset of a resumed request.
+        void restart_file();
+
+        /// @brief Moves the checkpoint to the bytes the receiver holds so
+        ///        far, and writes it once TFTP_JOURNAL_INTERVAL bytes passed
+        ///        since the last one.
+        void advance_checkpoint();
+
+        /// @brief Writes the checkpoint to the journal, after the bytes it
+        ///        covers reached the file.
+        void save_checkpoint();
+
+        /// @brief Writes the payload of the next block to the file.
+        /// @param payload First payload byte.
+        /// @param payload_size Number of payload bytes.
+        /// @return False if the write failed.
+        bool store_block(const char* payload, int payload_size);
+
+        /// @brief Writes the payload of the next block of a ranged download
+        ///        at its offset in the shared destination.
+        /// @param payload First payload byte.
+        /// @param payload_size Number of payload bytes.
+        /// @return False if the write failed.
+        bool write_range(const char* payload, int payload_size);
+
+        /// @brief Compares the checksum the server reported in the final ACK
+        ///        of an upload with the one of the blocks sent, and ends the
+        ///        transfer if they differ or the server sent none.
+        /// @param ack The final ACK.
+        /// @return False if the transfer ended.
+        bool verify_checksum(const ack_view_t& ack);
+
+        /// @brief Ends the transfer after a wait which brought no usable packet.
+        /// @param status The outcome of the wait.
+        /// @param message Reason recorded if another packet than the expected one arrived.
+        /// @return False, for the coroutines to return.
+        bool fail(receive_status_t status, const std::string& message);
+
+        /// @brief Ends the transfer and records its outcome.
+        /// @param status How the transfer ended.
+        /// @param message Reason of a failure, empty on success.
+        /// @return False, for the coroutines to return.
+        bool finish(transfer_status_t status, const std::string& message);
+
+        std::ifstream m_in_file; ///< Source file of an upload.
+        std::ofstream m_out_file; ///< Destination file of a download.
+        int m_range_fd; ///< Shared destination of a ranged download, -1 for a whole file.
+        int64_t m_range_offset; ///< File offset the next block of a ranged download is written at.
+        transfer_options_t m_source; ///< Size and time the other stripes saw, nothing negotiated if unchecked.
+        TFTPNetascii m_netascii; ///< Line end translation of a netascii transfer.
+        std::vector<char> m_decoded_block; ///< Payload of a netascii block in local form.
+        TFTPChecksum m_checksum; ///< CRC32C of the payload sent or received so far.
+        std::unique_ptr<TFTPJournal> m_journal; ///< Checkpoint journal of a resumable transfer, nullptr without one.
+        transfer_checkpoint_t m_checkpoint; ///< Progress the receiver holds, written to the journal from time to time.
+        TFTPChecksum m_digest; ///< CRC32C of the local file up to the transferred offset, continued from the journal.
+        int64_t m_resume_offset; ///< File offset the request resumed at, 0 from the start.
+        int64_t m_saved_offset; ///< Offset of the checkpoint written last.
+        bool m_sync; ///< An up to date destination skips the transfer.
+        int64_t m_local_size; ///< Size of the destination of a synced download, -1 if it is missing.
+        int64_t m_local_time; ///< Modification time of the destination of a synced download.
+        std::string m_remote_name; ///< Name of the file on the server.
+        std::string m_local_path; ///< Path of the file on this host.
+
+        SOCKET m_socket; ///< Socket of the transfer.
+        SOCKADDR_IN m_server_info; ///< Address the request is sent to.
+        std::unique_ptr<TFTPCoSession> m_session; ///< Awaitable session, once started.
+        TFTPTask<bool> m_task; ///< Coroutine of the transfer, once started.
+
+        transfer_options_t m_requested_options; ///< Options sent with the request.
+        int m_max_retries; ///< Retransmissions in a row which end the transfer.
+        transfer_type_t m_transfer_type; ///< Direction of the transfer, seen from the server.
+        bool m_file_exhausted; ///< The last block of an upload has been read.
+        bool m_ended; ///< The outcome is recorded.
+
+        TFTPRetransmitter::steady_clock_t::time_point m_created; ///< Time of the submission.
+        TFTPRetransmitter::steady_clock_t::time_point m_started; ///< Time of the first request.
+        transfer_progress_t m_progress; ///< Counters of the transfer so far.
+        transfer_result_t m_result; ///< Outcome of the transfer, complete once it ended.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_CLIENT_TRANSFER_HPP
+
+/* End of File */
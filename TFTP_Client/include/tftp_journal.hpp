@@ -0,0 +1,101 @@
+///
+/// @file tftp_journal.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPJournal class,
+///        which keeps the checkpoint a client transfer resumes from.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_JOURNAL_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_JOURNAL_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPJournal
+    /// @brief Small file next to the local file of a transfer which records
+    ///        how far the transfer got: the offset up to which the receiver
+    ///        stored the file in order, the CRC32C of those bytes, and the
+    ///        size and modification time of the source when it started. A
+    ///        transfer which dies resumes from the checkpoint instead of
+    ///        from the first block. The journal is replaced as a whole, so a
+    ///        crash while saving leaves the previous checkpoint.
+    class TFTPJournal
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPJournal(TFTPJournal &&) noexcept = default; ///< Default move constructor.
+        TFTPJournal &operator=(TFTPJournal &&) noexcept = default; ///< Default move assignment operator.
+        TFTPJournal(const TFTPJournal &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPJournal &operator=(TFTPJournal const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPJournal. Nothing is read or written yet.
+        /// @param local_path Path of the local file of the transfer.
+        explicit TFTPJournal(const std::string& local_path);
+
+        /// @brief Destructor for TFTPJournal.
+        ~TFTPJournal() = default;
+
+        /// @brief Reads the checkpoint of an earlier attempt.
+        /// @param checkpoint Filled with the checkpoint.
+        /// @return False if there is no journal or it is malformed.
+        bool load(transfer_checkpoint_t& checkpoint) const;
+
+        /// @brief Replaces the journal with a new checkpoint.
+        /// @param checkpoint The checkpoint.
+        /// @return False if the journal could not be written.
+        bool save(const transfer_checkpoint_t& checkpoint) const;
+
+        /// @brief Removes the journal once the transfer completed or the
+        ///        checkpoint turned out stale.
+        void remove() const;
+
+        /// @brief Checks that the first bytes of a local file still hash to
+        ///        the digest of a checkpoint.
+        /// @param file_path Path of the local file.
+        /// @param checkpoint The checkpoint.
+        /// @return False if the file is shorter or its bytes changed.
+        static bool verify(const std::string& file_path, const transfer_checkpoint_t& checkpoint);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        std::string m_path; ///< Path of the journal.
+        std::string m_temp_path; ///< Path a new checkpoint is written under before it replaces the journal.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_JOURNAL_HPP
+
+/* End of File */
@@ -7,11 +7,70 @@
 /// @copyright (c) 2024 All rights reserved.
 ///
 
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
 #include <tftp.hpp>
 #include "tftp_client.hpp"
+#include "tftp_async_client.hpp"
+#include "tftp_bulk_sync.hpp"
 
-int main()
+/// @brief Parses a decimal command line argument.
+/// @param text The argument.
+/// @param min Smallest accepted value.
+/// @param max Largest accepted value.
+/// @param value Filled with the value.
+/// @return False if the argument is not a number between min and max.
+static bool parse_argument(const char* text, long min, long max, int& value)
 {
+    char* end = nullptr;
+    errno = 0;
+    const long parsed = strtol(text, &end, 10);
+
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < min || parsed > max)
+    {
+        return false;
+    }
+
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // Brings the entries of a manifest up to date:
+    // TFTP_Client --sync <manifest> <server_ip> <port> [sessions]
+    if (argc >= 2 && std::string(argv[1]) == "--sync")
+    {
+        int port = 0;
+        int sessions = TFTP_SYNC_DEFAULT_SESSIONS;
+
+        if (argc < 5 || argc > 6 ||
+            !parse_argument(argv[4], 1, UINT16_MAX, port) ||
+            (argc == 6 && !parse_argument(argv[5], 1, TFTP_CLIENT_MAX_CONCURRENCY, sessions)))
+        {
+            std::cerr << "Usage: " << argv[0] << " --sync <manifest> <server_ip> <port 1-65535> [sessions 1-"
+                      << TFTP_CLIENT_MAX_CONCURRENCY << "]\n";
+            return 1;
+        }
+
+        try
+        {
+            YB::TFTPBulkSync sync(argv[3], port);
+            sync.set_max_sessions(sessions);
+
+            const YB::sync_summary_t summary = sync.run(YB::TFTPBulkSync::load_manifest(argv[2]));
+            YB::TFTPBulkSync::print_summary(summary);
+
+            return summary.failed == 0 ? 0 : 1;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
     const std::unique_ptr<YB::TFTPClient> client{new YB::TFTPClient()};
 
     client->create_socket("127.0.0.1", 1234);
@@ -25,6 +84,18 @@ int main()
     // If you want to pull a file from Server use below.
     //client->receive_file(directory + file_name);
 
+    // If you want to pull a large file over several sessions at once use below.
+    //client->receive_file_striped(directory + file_name, 4);
+
+    // If you want a failed transfer to continue where it stopped when it is run again use below.
+    //client->set_resume(true);
+
+    // If you want to pull many files at once, from one thread, use below.
+    //YB::TFTPAsyncClient async_client;
+    //auto result = async_client.receive_file("127.0.0.1", 1234, file_name, directory + file_name);
+    //async_client.run();
+    //std::cout << result.get().message << std::endl;
+
     return 0;
 }
 
@@ -0,0 +1,361 @@
+///
+/// @file tftp_async_client.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPAsyncClient class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include "tftp_async_client.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPAsyncClient::TFTPAsyncClient()
+        : m_reactor(new TFTPReactor()),
+          m_queued{},
+          m_running{},
+          m_resumed{},
+          m_requested_options{},
+          m_max_retries{TFTP_DEFAULT_MAX_RETRIES},
+          m_max_concurrency{TFTP_CLIENT_MAX_CONCURRENCY},
+          m_sync{false}
+    {
+#ifdef _WIN32
+        WSADATA wsa_data;
+        constexpr WORD version = MAKEWORD(2, 2);
+        const int status = WSAStartup(version, &wsa_data);
+
+        if (status != NO_ERROR)
+        {
+            const std::string error_str
+                = "Error at Windows Socket Architecture initialization. Error code: " +
+                  std::to_string(WSAGetLastError());
+
+            throw std::runtime_error(error_str);
+        }
+#endif
+        this->set_block_size(TFTP_PREFERRED_BLOCK_SIZE);
+        this->set_window_size(TFTP_PREFERRED_WINDOW_SIZE);
+        this->set_checksum(true);
+
+        std::cout << "Socket Architecture initialized.\n";
+    }
+
+    TFTPAsyncClient::~TFTPAsyncClient()
+    {
+        // The transfers close their sockets before the architecture goes.
+        this->m_running.clear();
+        this->m_queued.clear();
+
+        CLEANUP();
+    }
+
+    void TFTPAsyncClient::set_max_concurrency(int max_concurrency)
+    {
+        if (max_concurrency < 1)
+        {
+            throw std::runtime_error("At least one transfer has to run at a time");
+        }
+
+        this->m_max_concurrency = max_concurrency;
+    }
+
+    void TFTPAsyncClient::set_block_size(int block_size)
+    {
+        if (block_size < TFTP_MIN_BLOCK_SIZE || block_size > TFTP_MAX_BLOCK_SIZE)
+        {
+            throw std::runtime_error("Block size must be between " +
+                                     std::to_string(TFTP_MIN_BLOCK_SIZE) + " and " +
+                                     std::to_string(TFTP_MAX_BLOCK_SIZE));
+        }
+
+        this->m_requested_options.block_size = block_size;
+
+        if (block_size == TFTP_DEFAULT_BLOCK_SIZE)
+        {
+            this->m_requested_options.negotiated &= ~OPTION_BLOCK_SIZE;
+        }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_BLOCK_SIZE;
+        }
+    }
+
+    void TFTPAsyncClient::set_window_size(int window_size)
+    {
+        if (window_size < 1 || window_size > TFTP_MAX_WINDOW_SIZE)
+        {
+            throw std::runtime_error("Window size must be between 1 and " +
+                                     std::to_string(TFTP_MAX_WINDOW_SIZE));
+        }
+
+        this->m_requested_options.window_size = window_size;
+
+        if (window_size == TFTP_DEFAULT_WINDOW_SIZE)
+        {
+            this->m_requested_options.negotiated &= ~OPTION_WINDOW_SIZE;
+        }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_WINDOW_SIZE;
+        }
+    }
+
+    void TFTPAsyncClient::set_timeout(int seconds)
+    {
+        if (seconds != 0 &&
+            (seconds < TFTP_MIN_TIMEOUT_OPTION || seconds > TFTP_MAX_TIMEOUT_OPTION))
+        {
+            throw std::runtime_error("Timeout must be between " +
+                                     std::to_string(TFTP_MIN_TIMEOUT_OPTION) + " and " +
+                                     std::to_string(TFTP_MAX_TIMEOUT_OPTION) + " seconds");
+        }
+
+        this->m_requested_options.timeout = seconds;
+
+        if (seconds == 0)
+        {
+            this->m_requested_options.negotiated &= ~OPTION_TIMEOUT;
+        }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_TIMEOUT;
+        }
+    }
+
+    void TFTPAsyncClient::set_transfer_mode(transfer_mode_t mode)
+    {
+        this->m_requested_options.mode = mode;
+    }
+
+    void TFTPAsyncClient::set_checksum(bool enabled)
+    {
+        if (enabled)
+        {
+            this->m_requested_options.negotiated |= OPTION_CHECKSUM;
+        }
+        else
+        {
+            this->m_requested_options.negotiated &= ~OPTION_CHECKSUM;
+        }
+    }
+
+    void TFTPAsyncClient::set_rollover_policy(rollover_policy_t rollover)
+    {
+        this->m_requested_options.rollover = rollover;
+
+        if (rollover == ROLLOVER_POLICY_ZERO)
+        {
+            this->m_requested_options.negotiated &= ~OPTION_ROLLOVER;
+        }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_ROLLOVER;
+        }
+    }
+
+    void TFTPAsyncClient::set_max_retries(int max_retries)
+    {
+        if (max_retries < 0 || max_retries > TFTP_MAX_RETRIES)
+        {
+            throw std::runtime_error("Retries must be between 0 and " +
+                                     std::to_string(TFTP_MAX_RETRIES));
+        }
+
+        this->m_max_retries = max_retries;
+    }
+
+    void TFTPAsyncClient::set_sync(bool enabled)
+    {
+        this->m_sync = enabled;
+    }
+
+    std::future<transfer_result_t> TFTPAsyncClient::receive_file(const char* server_ip, int port,
+                                                                 const std::string& remote_name,
+                                                                 const std::string& local_path,
+                                                                 completion_callback_t on_complete,
+                                                                 progress_callback_t on_progress)
+    {
+        return this->submit(server_ip, port, TRANSFER_TYPE_RRQ, remote_name, local_path,
+                            std::move(on_complete), std::move(on_progress));
+    }
+
+    std::future<transfer_result_t> TFTPAsyncClient::send_file(const char* server_ip, int port,
+                                                              const std::string& local_path,
+                                                              const std::string& remote_name,
+                                                              completion_callback_t on_complete,
+                                                              progress_callback_t on_progress)
+    {
+        return this->submit(server_ip, port, TRANSFER_TYPE_WRQ, remote_name, local_path,
+                            std::move(on_complete), std::move(on_progress));
+    }
+
+    bool TFTPAsyncClient::poll(int timeout_ms)
+    {
+        this->start_transfers();
+
+        if (this->m_running.empty())
+        {
+            return false;
+        }
+
+        (void)this->m_reactor->poll(timeout_ms, this->m_resumed);
+
+        for (void* owner : this->m_resumed)
+        {
+            this->on_resumed(static_cast<TFTPClientTransfer*>(owner));
+        }
+
+        this->start_transfers();
+
+        return !this->m_running.empty() || !this->m_queued.empty();
+    }
+
+    void TFTPAsyncClient::run()
+    {
+        while (this->poll(-1))
+        {
+        }
+    }
+
+    size_t TFTPAsyncClient::get_queued_count() const
+    {
+        return this->m_queued.size();
+    }
+
+    size_t TFTPAsyncClient::get_running_count() const
+    {
+        return this->m_running.size();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    std::future<transfer_result_t> TFTPAsyncClient::submit(const char* server_ip, int port,
+                                                           transfer_type_t transfer_type,
+                                                           const std::string& remote_name,
+                                                           const std::string& local_path,
+                                                           completion_callback_t on_complete,
+                                                           progress_callback_t on_progress)
+    {
+        SOCKADDR_IN server_info{};
+        server_info.sin_family = AF_INET;
+        server_info.sin_port = htons(port);
+#ifdef _WIN32
+        server_info.sin_addr.S_un.S_addr = inet_addr(server_ip);
+#endif
+#ifdef __linux__
+        server_info.sin_addr.s_addr = inet_addr(server_ip);
+#endif
+
+        auto job = std::make_unique<job_t>();
+
+        job->transfer = std::make_unique<TFTPClientTransfer>(server_info, transfer_type,
+                                                             remote_name, local_path,
+                                                             this->m_requested_options,
+                                                             this->m_max_retries);
+        if (this->m_sync)
+        {
+            job->transfer->enable_sync();
+        }
+
+        job->on_complete = std::move(on_complete);
+        job->on_progress = std::move(on_progress);
+
+        std::future<transfer_result_t> result = job->promise.get_future();
+
+        this->m_queued.push_back(std::move(job));
+
+        return result;
+    }
+
+    void TFTPAsyncClient::start_transfers()
+    {
+        while (!this->m_queued.empty() &&
+               this->m_running.size() < static_cast<size_t>(this->m_max_concurrency))
+        {
+            std::unique_ptr<job_t> job = std::move(this->m_queued.front());
+            this->m_queued.pop_front();
+
+            TFTPClientTransfer* transfer = job->transfer.get();
+
+            if (!transfer->start(*this->m_reactor))
+            {
+                // Refused before anything was sent, the slot stays free.
+                fulfil(*job);
+                continue;
+            }
+
+            this->m_running[transfer] = std::move(job);
+        }
+    }
+
+    void TFTPAsyncClient::on_resumed(TFTPClientTransfer* transfer)
+    {
+        const auto found = this->m_running.find(transfer);
+
+        if (found == this->m_running.end())
+        {
+            // Resumed twice in one poll and already handed over.
+            return;
+        }
+
+        if (transfer->is_done())
+        {
+            std::unique_ptr<job_t> job = std::move(found->second);
+
+            this->m_running.erase(found);
+            fulfil(*job);
+            return;
+        }
+
+        job_t& job = *found->second;
+        const transfer_progress_t& progress = transfer->get_progress();
+
+        if (job.on_progress && progress.blocks != job.reported_blocks)
+        {
+            job.reported_blocks = progress.blocks;
+            job.on_progress(progress);
+        }
+    }
+
+    void TFTPAsyncClient::fulfil(job_t& job)
+    {
+        const transfer_result_t& result = job.transfer->get_result();
+
+        if (job.on_progress && result.progress.blocks != job.reported_blocks)
+        {
+            job.on_progress(result.progress);
+        }
+
+        if (job.on_complete)
+        {
+            job.on_complete(result);
+        }
+
+        job.promise.set_value(result);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
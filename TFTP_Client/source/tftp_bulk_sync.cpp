@@ -0,0 +1,224 @@
+///
+/// @file tftp_bulk_sync.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPBulkSync class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "tftp_bulk_sync.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPBulkSync::TFTPBulkSync(std::string server_ip, int port)
+        : m_client{},
+          m_server_ip{std::move(server_ip)},
+          m_port{port},
+          m_max_sessions{TFTP_SYNC_DEFAULT_SESSIONS},
+          m_entries{nullptr},
+          m_next{0},
+          m_summary{}
+    {
+        this->m_client.set_sync(true);
+        this->m_client.set_max_concurrency(this->m_max_sessions);
+    }
+
+    TFTPAsyncClient& TFTPBulkSync::get_client()
+    {
+        return this->m_client;
+    }
+
+    void TFTPBulkSync::set_max_sessions(int max_sessions)
+    {
+        if (max_sessions < 1 || max_sessions > TFTP_CLIENT_MAX_CONCURRENCY)
+        {
+            throw std::runtime_error("Sessions must be between 1 and " +
+                                     std::to_string(TFTP_CLIENT_MAX_CONCURRENCY));
+        }
+
+        this->m_max_sessions = max_sessions;
+        this->m_client.set_max_concurrency(max_sessions);
+    }
+
+    std::vector<sync_entry_t> TFTPBulkSync::load_manifest(const std::string& manifest_path)
+    {
+        std::ifstream manifest(manifest_path);
+
+        if (!manifest.is_open())
+        {
+            throw std::runtime_error("Manifest " + manifest_path + " could not be opened");
+        }
+
+        std::vector<sync_entry_t> entries;
+        std::string line{};
+        int line_number = 0;
+
+        while (std::getline(manifest, line))
+        {
+            ++line_number;
+
+            const size_t first = line.find_first_not_of(" \t\r");
+
+            if (first == std::string::npos || line[first] == '#')
+            {
+                continue;
+            }
+
+            std::istringstream fields(line);
+            sync_entry_t entry{};
+            std::string direction{};
+            std::string extra{};
+
+            if (!(fields >> entry.remote_name >> entry.local_path >> direction) || (fields >> extra))
+            {
+                throw std::runtime_error("Manifest line " + std::to_string(line_number) +
+                                         ": expected <remote> <local> <get|put>");
+            }
+
+            if (direction == SYNC_DIRECTION_NAME_GET)
+            {
+                entry.direction = TRANSFER_TYPE_RRQ;
+            }
+            else if (direction == SYNC_DIRECTION_NAME_PUT)
+            {
+                entry.direction = TRANSFER_TYPE_WRQ;
+            }
+            else
+            {
+                throw std::runtime_error("Manifest line " + std::to_string(line_number) +
+                                         ": unknown direction " + direction);
+            }
+
+            entries.push_back(std::move(entry));
+        }
+
+        return entries;
+    }
+
+    sync_summary_t TFTPBulkSync::run(const std::vector<sync_entry_t>& entries)
+    {
+        const auto started = std::chrono::steady_clock::now();
+
+        this->m_entries = &entries;
+        this->m_next = 0;
+        this->m_summary = sync_summary_t{};
+        this->m_summary.entries = entries.size();
+
+        // Every finished entry submits the next, the queue never grows past the sessions.
+        for (int session = 0; session < this->m_max_sessions; ++session)
+        {
+            this->submit_next();
+        }
+
+        this->m_client.run();
+
+        this->m_entries = nullptr;
+        this->m_summary.elapsed
+            = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+
+        return this->m_summary;
+    }
+
+    void TFTPBulkSync::print_summary(const sync_summary_t& summary)
+    {
+        const double seconds = static_cast<double>(summary.elapsed.count()) / 1e6;
+        const double megabytes = static_cast<double>(summary.bytes) / (1024.0 * 1024.0);
+
+        std::cout << "Synced " << summary.entries << " entries: "
+                  << summary.transferred << " transferred, "
+                  << summary.skipped << " up to date, "
+                  << summary.failed << " failed\n"
+                  << std::fixed << std::setprecision(2)
+                  << megabytes << " MiB in " << seconds << " s, "
+                  << (seconds > 0 ? megabytes / seconds : 0.0) << " MiB/s\n";
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPBulkSync::submit_next()
+    {
+        if (this->m_next >= this->m_entries->size())
+        {
+            return;
+        }
+
+        const size_t index = this->m_next++;
+        const sync_entry_t& entry = (*this->m_entries)[index];
+        auto on_complete = [this, index](const transfer_result_t& result)
+        {
+            this->on_complete(index, result);
+        };
+
+        if (entry.direction == TRANSFER_TYPE_RRQ)
+        {
+            // Downloads may go into directories which do not exist yet.
+            const std::filesystem::path directory = std::filesystem::path(entry.local_path).parent_path();
+            std::error_code error;
+
+            if (!directory.empty())
+            {
+                std::filesystem::create_directories(directory, error);
+            }
+
+            (void)this->m_client.receive_file(this->m_server_ip.c_str(), this->m_port,
+                                              entry.remote_name, entry.local_path, on_complete);
+        }
+        else
+        {
+            (void)this->m_client.send_file(this->m_server_ip.c_str(), this->m_port,
+                                           entry.local_path, entry.remote_name, on_complete);
+        }
+    }
+
+    void TFTPBulkSync::on_complete(size_t index, const transfer_result_t& result)
+    {
+        const sync_entry_t& entry = (*this->m_entries)[index];
+
+        if (result.status == TRANSFER_STATUS_COMPLETE)
+        {
+            ++this->m_summary.transferred;
+            this->m_summary.bytes += result.progress.bytes;
+        }
+        else if (result.status == TRANSFER_STATUS_SKIPPED)
+        {
+            ++this->m_summary.skipped;
+        }
+        else
+        {
+            ++this->m_summary.failed;
+            std::cout << "Sync of " << entry.remote_name << " ("
+                      << (entry.direction == TRANSFER_TYPE_RRQ ? SYNC_DIRECTION_NAME_GET : SYNC_DIRECTION_NAME_PUT)
+                      << ") failed: " << result.message << "\n";
+        }
+
+        this->submit_next();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
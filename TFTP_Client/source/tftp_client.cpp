@@ -11,10 +11,23 @@
 // Project Includes
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
 #include <filesystem>
 #include "tftp_client.hpp"
+#include "tftp_client_transfer.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 // Third Party Includes
@@ -27,12 +40,13 @@ namespace YB
 ////////////////////////////////////////////////////////////////////////////////
 
     TFTPClient::TFTPClient()
-        : m_incoming_buffer(new char[TFTP_INCOMING_DATA_BUFFER_LEN]),
-          m_outgoing_buffer(new char[TFTP_OUTGOING_DATA_BUFFER_LEN]),
-          m_client_socket{INVALID_SOCKET},
-          m_server_info{},
-          m_peer{},
-          m_addr_size{sizeof(SOCKADDR_IN)}
+        : m_reactor(new TFTPReactor()),
+          m_resumed{},
+          m_requested_options{},
+          m_max_retries{TFTP_DEFAULT_MAX_RETRIES},
+          m_checksum{0},
+          m_resume{false},
+          m_server_info{}
     {
 #ifdef _WIN32
         WSADATA wsa_data;
@@ -48,28 +62,22 @@ namespace YB
             throw std::runtime_error(error_str);
         }
 #endif
+        this->set_block_size(TFTP_PREFERRED_BLOCK_SIZE);
+        this->set_window_size(TFTP_PREFERRED_WINDOW_SIZE);
+        this->set_checksum(true);
+
         std::cout << "Socket Architecture initialized.\n";
     }
 
     TFTPClient::~TFTPClient()
     {
-        this->close_socket_architecture();
+        CLEANUP();
+
+        std::cout << "Socket Architecture is closed." << std::endl;
     }
 
     void TFTPClient::create_socket(const char* server_ip, int port)
     {
-        this->m_client_socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_IP);
-
-        if (this->m_client_socket == SOCKET_ERROR ||
-            this->m_client_socket == INVALID_SOCKET)
-        {
-            const std::string error_str = "Error at socket creation. Error code: " +
-                                          GET_LAST_ERROR();
-            this->close_socket_architecture();
-
-            throw std::runtime_error(error_str);
-        }
-
         this->m_server_info.sin_family = AF_INET;
         this->m_server_info.sin_port = htons(port);
 #ifdef _WIN32
@@ -78,200 +86,352 @@ namespace YB
 #ifdef __linux__
         this->m_server_info.sin_addr.s_addr = inet_addr(server_ip);
 #endif
-        memset(this->m_server_info.sin_zero, 0, this->m_addr_size);
+        memset(this->m_server_info.sin_zero, 0, sizeof(this->m_server_info.sin_zero));
     }
 
-    void TFTPClient::send_file(const std::string& file_path)
+    void TFTPClient::set_block_size(int block_size)
     {
-        memset(&this->m_peer, 0, this->m_addr_size);
+        if (block_size < TFTP_MIN_BLOCK_SIZE || block_size > TFTP_MAX_BLOCK_SIZE)
+        {
+            throw std::runtime_error("Block size must be between " +
+                                     std::to_string(TFTP_MIN_BLOCK_SIZE) + " and " +
+                                     std::to_string(TFTP_MAX_BLOCK_SIZE));
+        }
 
-        std::string file_path_ = file_path;
-        std::replace(file_path_.begin(), file_path_.end(), '\\', '/');
+        this->m_requested_options.block_size = block_size;
 
-        const std::filesystem::path path(file_path_);
-        std::filesystem::path canonical_path = std::filesystem::weakly_canonical(path);
+        if (block_size == TFTP_DEFAULT_BLOCK_SIZE)
+        {
+            this->m_requested_options.negotiated &= ~OPTION_BLOCK_SIZE;
+        }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_BLOCK_SIZE;
+        }
+    }
 
-        file_path_ = canonical_path.make_preferred().string();
-        const std::string file_name = canonical_path.filename().string();
+    void TFTPClient::set_window_size(int window_size)
+    {
+        if (window_size < 1 || window_size > TFTP_MAX_WINDOW_SIZE)
+        {
+            throw std::runtime_error("Window size must be between 1 and " +
+                                     std::to_string(TFTP_MAX_WINDOW_SIZE));
+        }
 
-        std::ifstream file(file_path_, std::ios::binary);
+        this->m_requested_options.window_size = window_size;
 
-        if (!file.is_open())
+        if (window_size == TFTP_DEFAULT_WINDOW_SIZE)
         {
-            this->close_socket_architecture();
-            file.close();
-            throw std::runtime_error("File could not be created for WRQ");
+            this->m_requested_options.negotiated &= ~OPTION_WINDOW_SIZE;
         }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_WINDOW_SIZE;
+        }
+    }
 
-        //send WRQ
-        this->send_wrq_packet(file_name);
+    void TFTPClient::set_timeout(int seconds)
+    {
+        if (seconds != 0 &&
+            (seconds < TFTP_MIN_TIMEOUT_OPTION || seconds > TFTP_MAX_TIMEOUT_OPTION))
+        {
+            throw std::runtime_error("Timeout must be between " +
+                                     std::to_string(TFTP_MIN_TIMEOUT_OPTION) + " and " +
+                                     std::to_string(TFTP_MAX_TIMEOUT_OPTION) + " seconds");
+        }
 
-        //first ACK
-        this->receive_data_from_server();
+        this->m_requested_options.timeout = seconds;
 
-        if (this->m_incoming_buffer[1] != OP_CODE_ACK)
+        if (seconds == 0)
         {
-            this->close_socket_architecture();
-            this->send_transmission_done_signal();
-            throw std::runtime_error("ACK Packet of data is missing");
+            this->m_requested_options.negotiated &= ~OPTION_TIMEOUT;
         }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_TIMEOUT;
+        }
+    }
+
+    void TFTPClient::set_transfer_mode(transfer_mode_t mode)
+    {
+        this->m_requested_options.mode = mode;
+    }
 
-        while (!file.eof())
+    void TFTPClient::set_checksum(bool enabled)
+    {
+        if (enabled)
+        {
+            this->m_requested_options.negotiated |= OPTION_CHECKSUM;
+        }
+        else
         {
-            memset(this->m_outgoing_buffer.get(), 0, TFTP_OUTGOING_DATA_BUFFER_LEN);
-            file.read(this->m_outgoing_buffer.get(), TFTP_OUTGOING_DATA_BUFFER_LEN);
-            int number_of_bytes_from_last_read = static_cast<int>(file.gcount());
+            this->m_requested_options.negotiated &= ~OPTION_CHECKSUM;
+        }
+    }
 
-            this->send_data_packet(number_of_bytes_from_last_read);
+    uint32_t TFTPClient::get_checksum() const
+    {
+        return this->m_checksum;
+    }
 
-            memset(this->m_incoming_buffer.get(), 0, TFTP_INCOMING_DATA_BUFFER_LEN);
+    void TFTPClient::set_rollover_policy(rollover_policy_t rollover)
+    {
+        this->m_requested_options.rollover = rollover;
 
-            this->receive_data_from_server();
+        if (rollover == ROLLOVER_POLICY_ZERO)
+        {
+            this->m_requested_options.negotiated &= ~OPTION_ROLLOVER;
+        }
+        else
+        {
+            this->m_requested_options.negotiated |= OPTION_ROLLOVER;
+        }
+    }
 
-            if (this->m_incoming_buffer[1] != OP_CODE_ACK)
-            {
-                this->close_socket_architecture();
-                this->send_transmission_done_signal();
-                throw std::runtime_error("ACK Packet of data is missing");
-            }
+    void TFTPClient::set_max_retries(int max_retries)
+    {
+        if (max_retries < 0 || max_retries > TFTP_MAX_RETRIES)
+        {
+            throw std::runtime_error("Retries must be between 0 and " +
+                                     std::to_string(TFTP_MAX_RETRIES));
         }
 
-        file.close();
+        this->m_max_retries = max_retries;
     }
 
-    void TFTPClient::receive_file(const std::string& file_path)
+    void TFTPClient::set_resume(bool enabled)
     {
-        memset(&this->m_peer, 0, this->m_addr_size);
-
-        std::string file_path_ = file_path;
-        std::replace(file_path_.begin(), file_path_.end(), '\\', '/');
+        this->m_resume = enabled;
+    }
 
-        const std::filesystem::path path(file_path_);
-        std::filesystem::path canonical_path = std::filesystem::weakly_canonical(path);
+    void TFTPClient::send_file(const std::string& file_path)
+    {
+        this->run_transfer(TRANSFER_TYPE_WRQ, file_path);
+    }
 
-        file_path_ = canonical_path.make_preferred().string();
-        std::string file_name = canonical_path.filename().string();
+    void TFTPClient::receive_file(const std::string& file_path)
+    {
+        this->run_transfer(TRANSFER_TYPE_RRQ, file_path);
+    }
 
-        std::ofstream file(file_path_, std::ios::binary);
+    void TFTPClient::receive_file_striped(const std::string& file_path, int stripe_count)
+    {
+        if (stripe_count < 1 || stripe_count > TFTP_CLIENT_MAX_STRIPES)
+        {
+            throw std::runtime_error("Stripe count must be between 1 and " +
+                                     std::to_string(TFTP_CLIENT_MAX_STRIPES));
+        }
 
-        //send RRQ
-        this->send_rrq_packet(file_name);
+        if (this->m_requested_options.mode == TRANSFER_MODE_NETASCII)
+        {
+            throw std::runtime_error("Striped downloads need the octet mode");
+        }
 
-        //Get first data block
-        int bytes = this->receive_data_from_server();
+        std::string file_name{};
+        const std::string local_path = resolve_path(file_path, file_name);
+        const int fd = open_output_file(local_path);
 
-        if (this->m_incoming_buffer[1] != OP_CODE_DATA)
+        if (fd < 0)
         {
-            this->close_socket_architecture();
-            file.close();
-            this->send_transmission_done_signal();
-            throw std::runtime_error("Data transfer could not start");
+            throw std::runtime_error("File " + local_path + " could not be opened");
         }
 
-        file.write(&this->m_incoming_buffer[DATA_BEGIN], bytes - DATA_BEGIN);
+        std::string error = this->receive_stripes(fd, file_name, local_path, stripe_count);
 
-        //send first ack packet
-        this->send_ack_packet();
-
-        while (bytes >= TFTP_OUTGOING_DATA_BUFFER_LEN)
+        if (!close_output_file(fd) && error.empty())
         {
-            memset(this->m_incoming_buffer.get(), 0, TFTP_OUTGOING_DATA_BUFFER_LEN);
+            error = "File " + local_path + " could not be written";
+        }
 
-            bytes = this->receive_data_from_server();
+        this->m_checksum = 0;
 
-            file.write(&this->m_incoming_buffer[DATA_BEGIN], bytes - DATA_BEGIN);
+        if (!error.empty())
+        {
+            // A half written file would look like a complete one of the same size.
+            std::error_code remove_error;
+            (void)std::filesystem::remove(local_path, remove_error);
 
-            this->send_ack_packet();
+            throw std::runtime_error(error);
         }
-
-        file.close();
     }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Private Functions
 ////////////////////////////////////////////////////////////////////////////////
 
-    void TFTPClient::send_ack_packet()
+    void TFTPClient::run_transfer(transfer_type_t transfer_type, const std::string& file_path)
     {
-        packet_t ack_packet = TFTP::make_ack_packet();
-
-        (void)sendto(this->m_client_socket,
-                     ack_packet.data_ptr.get(),
-                     ack_packet.size,
-                     0,
-                     reinterpret_cast<SOCKADDR*>(&this->m_peer),
-                     this->m_addr_size);
+        std::string file_name{};
+        const std::string local_path = resolve_path(file_path, file_name);
+
+        for (int attempt = 0; ; ++attempt)
+        {
+            TFTPClientTransfer transfer(this->m_server_info, transfer_type, file_name, local_path,
+                                        this->m_requested_options, this->m_max_retries);
+
+            if (this->m_resume)
+            {
+                transfer.enable_journal();
+            }
+
+            (void)transfer.start(*this->m_reactor);
+            this->wait_for(transfer);
+
+            const transfer_result_t& result = transfer.get_result();
+
+            // The stale checkpoint is gone, the second attempt starts from zero.
+            if (result.status == TRANSFER_STATUS_CHECKPOINT_STALE && attempt == 0)
+            {
+                continue;
+            }
+
+            this->m_checksum = result.checksum;
+
+            if (result.status != TRANSFER_STATUS_COMPLETE)
+            {
+                throw std::runtime_error(result.message);
+            }
+
+            return;
+        }
     }
 
-    void TFTPClient::send_data_packet(int number_of_bytes_from_last_read)
+    std::string TFTPClient::receive_stripes(int fd, const std::string& file_name,
+                                            const std::string& local_path, int stripe_count)
     {
-        packet_t data_packet
-            = TFTP::make_data_packet(this->m_outgoing_buffer.get());
-
-        (void)sendto(this->m_client_socket,
-                     data_packet.data_ptr.get(),
-                     number_of_bytes_from_last_read + DATA_BEGIN,
-                     0,
-                     reinterpret_cast<SOCKADDR*>(&this->m_peer),
-                     this->m_addr_size);
+        // An empty range costs one round trip and brings the size with tsize.
+        TFTPClientTransfer probe(this->m_server_info, TRANSFER_TYPE_RRQ, file_name, local_path,
+                                 this->m_requested_options, this->m_max_retries);
+        probe.set_range(fd, 0, 0);
+        (void)probe.start(*this->m_reactor);
+        this->wait_for(probe);
+
+        const transfer_result_t& probed = probe.get_result();
+
+        if (probed.status != TRANSFER_STATUS_COMPLETE)
+        {
+            return probed.message;
+        }
+
+        if ((probed.options.negotiated & OPTION_TRANSFER_SIZE) == 0)
+        {
+            return "Server did not report the size of the file";
+        }
+
+        const int64_t file_size = probed.options.transfer_size;
+
+        if (!preallocate_output_file(fd, file_size))
+        {
+            return "File " + local_path + " could not be preallocated";
+        }
+
+        // Stripes start on block boundaries and hold at least one block.
+        const int64_t block_size = probed.options.block_size;
+        const int64_t block_count = (file_size + block_size - 1) / block_size;
+        const int64_t stripes = std::clamp<int64_t>(block_count, 1, stripe_count);
+
+        std::vector<std::unique_ptr<TFTPClientTransfer>> transfers;
+
+        for (int64_t i = 0; i < stripes; ++i)
+        {
+            const int64_t begin = std::min(block_count * i / stripes * block_size, file_size);
+            const int64_t end = std::min(block_count * (i + 1) / stripes * block_size, file_size);
+
+            transfers.push_back(std::make_unique<TFTPClientTransfer>(this->m_server_info, TRANSFER_TYPE_RRQ,
+                                                                     file_name, local_path,
+                                                                     this->m_requested_options,
+                                                                     this->m_max_retries));
+            transfers.back()->set_range(fd, begin, end - begin);
+            transfers.back()->set_source(probed.options);
+            (void)transfers.back()->start(*this->m_reactor);
+        }
+
+        while (true)
+        {
+            bool running = false;
+
+            for (size_t i = 0; i < transfers.size(); ++i)
+            {
+                if (!transfers[i]->is_done())
+                {
+                    running = true;
+                }
+                else if (transfers[i]->get_result().status != TRANSFER_STATUS_COMPLETE)
+                {
+                    // The other stripes are dropped with the vector, the file is of no use anymore.
+                    return "Stripe " + std::to_string(i) + ": " + transfers[i]->get_result().message;
+                }
+            }
+
+            if (!running)
+            {
+                return "";
+            }
+
+            (void)this->m_reactor->poll(-1, this->m_resumed);
+        }
     }
 
-    void TFTPClient::send_rrq_packet(const std::string& file_name)
+    void TFTPClient::wait_for(TFTPClientTransfer& transfer)
     {
-        packet_t rrq_packet = TFTP::make_rrq_packet(file_name);
-
-        (void)sendto(this->m_client_socket,
-                     rrq_packet.data_ptr.get(),
-                     rrq_packet.size,
-                     0,
-                     reinterpret_cast<SOCKADDR*>(&this->m_server_info),
-                     this->m_addr_size);
+        while (!transfer.is_done())
+        {
+            (void)this->m_reactor->poll(-1, this->m_resumed);
+        }
     }
 
-    void TFTPClient::send_wrq_packet(const std::string& file_name)
+    std::string TFTPClient::resolve_path(const std::string& file_path, std::string& file_name)
     {
-        packet_t wrq_packet = TFTP::make_wrq_packet(file_name);
-
-        (void)sendto(this->m_client_socket,
-                     wrq_packet.data_ptr.get(),
-                     wrq_packet.size,
-                     0,
-                     reinterpret_cast<SOCKADDR*>(&this->m_server_info),
-                     this->m_addr_size);
+        std::string file_path_ = file_path;
+        std::replace(file_path_.begin(), file_path_.end(), '\\', '/');
+
+        const std::filesystem::path path(file_path_);
+        std::filesystem::path canonical_path = std::filesystem::weakly_canonical(path);
+
+        file_name = canonical_path.filename().string();
+
+        return canonical_path.make_preferred().string();
     }
 
-    int TFTPClient::receive_data_from_server()
+    int TFTPClient::open_output_file(const std::string& local_path)
     {
-        return recvfrom(this->m_client_socket,
-                        this->m_incoming_buffer.get(),
-                        TFTP_INCOMING_DATA_BUFFER_LEN,
-                        0,
-                        reinterpret_cast<SOCKADDR*>(&this->m_peer),
-                        &this->m_addr_size);
+#ifdef __linux__
+        return ::open(local_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+#ifdef _WIN32
+        return _open(local_path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#endif
     }
 
-    void TFTPClient::close_socket_architecture() const
+    bool TFTPClient::preallocate_output_file(int fd, int64_t size)
     {
-        if (this->m_client_socket != INVALID_SOCKET)
+#ifdef __linux__
+        // Reserved in one go, the stripes do not fragment the file as they grow it.
+        if (size > 0 && fallocate(fd, 0, 0, static_cast<off_t>(size)) == 0)
         {
-            CLOSE_SOCKET(this->m_client_socket);
+            return true;
         }
 
-        CLEANUP();
+        if (size > 0 && (errno == ENOSPC || errno == EFBIG))
+        {
+            return false;
+        }
 
-        std::cout << "Socket Architecture is closed." << std::endl;
+        return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+#ifdef _WIN32
+        return _chsize_s(fd, size) == 0;
+#endif
     }
 
-    void TFTPClient::send_transmission_done_signal()
+    bool TFTPClient::close_output_file(int fd)
     {
-        const std::string done_str = "done";
-        //tell the server the transmission is done.
-        (void)sendto(this->m_client_socket,
-                     done_str.c_str(),
-                     done_str.length(),
-                     0,
-                     reinterpret_cast<SOCKADDR*>(&this->m_peer),
-                     this->m_addr_size);
+#ifdef __linux__
+        return close(fd) == 0;
+#endif
+#ifdef _WIN32
+        return _close(fd) == 0;
+#endif
     }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,956 @@
+///
+/// @file tftp_client_transfer.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPClientTransfer class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include "tftp_client_transfer.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <tftp_poller.hpp>
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPClientTransfer::TFTPClientTransfer(const SOCKADDR_IN& server_info,
+                                           transfer_type_t transfer_type,
+                                           std::string remote_name,
+                                           std::string local_path,
+                                           const transfer_options_t& options,
+                                           int max_retries)
+        : m_in_file{},
+          m_out_file{},
+          m_range_fd{-1},
+          m_range_offset{0},
+          m_source{},
+          m_netascii{},
+          m_decoded_block{},
+          m_checksum{},
+          m_journal{},
+          m_checkpoint{},
+          m_digest{},
+          m_resume_offset{0},
+          m_saved_offset{0},
+          m_sync{false},
+          m_local_size{-1},
+          m_local_time{0},
+          m_remote_name{std::move(remote_name)},
+          m_local_path{std::move(local_path)},
+          m_socket{INVALID_SOCKET},
+          m_server_info{server_info},
+          m_session{},
+          m_task{},
+          m_requested_options{options},
+          m_max_retries{max_retries},
+          m_transfer_type{transfer_type},
+          m_file_exhausted{false},
+          m_ended{false},
+          m_created{TFTPRetransmitter::steady_clock_t::now()},
+          m_started{m_created},
+          m_progress{},
+          m_result{}
+    {
+    }
+
+    TFTPClientTransfer::~TFTPClientTransfer()
+    {
+        // The frame refers to the session, which the reactor forgets
+        // before the socket goes.
+        this->m_task = TFTPTask<bool>();
+        this->m_session.reset();
+
+        if (this->m_socket != INVALID_SOCKET &&
+            this->m_socket != SOCKET_ERROR)
+        {
+            CLOSE_SOCKET(this->m_socket);
+        }
+    }
+
+    bool TFTPClientTransfer::start(TFTPReactor& reactor)
+    {
+        this->m_started = TFTPRetransmitter::steady_clock_t::now();
+
+        if (!this->open_file())
+        {
+            return this->finish(TRANSFER_STATUS_FILE_ERROR,
+                                "File " + this->m_local_path + " could not be opened");
+        }
+
+        this->m_socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_IP);
+
+        if (this->m_socket == SOCKET_ERROR ||
+            this->m_socket == INVALID_SOCKET)
+        {
+            return this->finish(TRANSFER_STATUS_SOCKET_ERROR,
+                                "Error at socket creation. Error code: " + GET_LAST_ERROR());
+        }
+
+        TFTPPoller::set_non_blocking(this->m_socket);
+
+        // Until an OACK says otherwise the server ignored every option.
+        transfer_options_t assumed{};
+        assumed.mode = this->m_requested_options.mode;
+        assumed.rollover = this->m_requested_options.rollover;
+
+        // A download takes up to a window of Data packets with one call.
+
+        const bool download = this->m_transfer_type == TRANSFER_TYPE_RRQ;
+        const int buffer_len = download
+                               ? std::max(std::max(this->m_requested_options.block_size, TFTP_DEFAULT_BLOCK_SIZE) + data_begin,
+                                          TFTP_REQUEST_BUFFER_LEN)
+                               : TFTP_REQUEST_BUFFER_LEN;
+        const int buffer_count = std::min(this->m_requested_options.window_size, TFTP_BATCH_SIZE);
+
+        this->m_session = std::make_unique<TFTPCoSession>(reactor, this->m_socket, this->m_server_info, false,
+                                                          download ? TRANSFER_ROLE_RECEIVER : TRANSFER_ROLE_SENDER,
+                                                          buffer_len, buffer_count, assumed,
+                                                          this->m_max_retries, this);
+
+        this->m_task = download ? this->receive_file() : this->send_file();
+        this->m_task.start();
+
+        return !this->m_ended;
+    }
+
+    void TFTPClientTransfer::set_range(int fd, int64_t offset, int64_t length)
+    {
+        this->m_range_fd = fd;
+        this->m_range_offset = offset;
+        this->m_requested_options.offset = offset;
+        this->m_requested_options.length = length;
+        this->m_requested_options.negotiated |= OPTION_OFFSET | OPTION_LENGTH;
+        this->m_progress.total_bytes = length;
+    }
+
+    void TFTPClientTransfer::set_source(const transfer_options_t& source)
+    {
+        this->m_source = source;
+    }
+
+    void TFTPClientTransfer::enable_journal()
+    {
+        // Offsets of a netascii file differ from the ones on the wire.
+        if (this->m_requested_options.mode == TRANSFER_MODE_OCTET && this->m_range_fd < 0)
+        {
+            this->m_journal = std::make_unique<TFTPJournal>(this->m_local_path);
+        }
+    }
+
+    void TFTPClientTransfer::enable_sync()
+    {
+        this->m_sync = true;
+    }
+
+    bool TFTPClientTransfer::is_done() const
+    {
+        return this->m_ended;
+    }
+
+    const transfer_progress_t& TFTPClientTransfer::get_progress() const
+    {
+        return this->m_progress;
+    }
+
+    const transfer_result_t& TFTPClientTransfer::get_result() const
+    {
+        return this->m_result;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPClientTransfer::open_file()
+    {
+        if (this->m_transfer_type == TRANSFER_TYPE_RRQ)
+        {
+            // The server answers with the size of the file, the total of the progress.
+            this->m_requested_options.transfer_size = 0;
+            this->m_requested_options.negotiated |= OPTION_TRANSFER_SIZE;
+
+            if (this->m_range_fd >= 0)
+            {
+                // Every stripe reports the time of the file too, accept_source() compares them.
+                this->m_requested_options.modified_time = 0;
+                this->m_requested_options.negotiated |= OPTION_MODIFIED_TIME;
+
+                return true;
+            }
+
+            if (this->m_journal != nullptr)
+            {
+                // The server reports the time of its file, a later resume is checked against it.
+                this->m_requested_options.modified_time = 0;
+                this->m_requested_options.negotiated |= OPTION_MODIFIED_TIME;
+                this->m_checkpoint.transfer_type = TRANSFER_TYPE_RRQ;
+
+                transfer_checkpoint_t saved{};
+                std::error_code resize_error;
+
+                if (this->m_journal->load(saved) && saved.transfer_type == TRANSFER_TYPE_RRQ && saved.offset > 0 &&
+                    TFTPJournal::verify(this->m_local_path, saved))
+                {
+                    // Bytes past the checkpoint may be torn, they are fetched again.
+                    std::filesystem::resize_file(this->m_local_path, static_cast<uintmax_t>(saved.offset),
+                                                 resize_error);
+
+                    if (!resize_error)
+                    {
+                        this->m_out_file.open(this->m_local_path, std::ios::binary | std::ios::in | std::ios::out);
+                        this->m_out_file.seekp(saved.offset);
+                        this->resume_from(saved);
+
+                        return this->m_out_file.is_open() && !this->m_out_file.fail();
+                    }
+                }
+            }
+
+            if (this->m_sync)
+            {
+                // Opened by accept_sync(), an unchanged file is left as it is.
+                this->m_requested_options.modified_time = 0;
+                this->m_requested_options.negotiated |= OPTION_MODIFIED_TIME;
+
+                std::error_code local_error;
+                const auto local_size = std::filesystem::file_size(this->m_local_path, local_error);
+
+                if (!local_error && TFTP::read_modified_time(this->m_local_path, this->m_local_time))
+                {
+                    this->m_local_size = static_cast<int64_t>(local_size);
+                }
+
+                return true;
+            }
+
+            this->m_out_file.open(this->m_local_path, std::ios::binary | std::ios::trunc);
+
+            return this->m_out_file.is_open();
+        }
+
+        this->m_in_file.open(this->m_local_path, std::ios::binary);
+
+        if (!this->m_in_file.is_open())
+        {
+            return false;
+        }
+
+        std::error_code size_error;
+        const auto file_size = static_cast<int64_t>(std::filesystem::file_size(this->m_local_path, size_error));
+
+        if (!size_error)
+        {
+            // The server can preallocate the file from its size.
+            this->m_requested_options.transfer_size = file_size;
+            this->m_requested_options.negotiated |= OPTION_TRANSFER_SIZE;
+            this->m_progress.total_bytes = file_size;
+        }
+
+        if (this->m_sync && !size_error &&
+            TFTP::read_modified_time(this->m_local_path, this->m_requested_options.modified_time))
+        {
+            // The server skips a file it holds with the same size and time, or stores it with this time.
+            this->m_requested_options.negotiated |= OPTION_MODIFIED_TIME;
+        }
+
+        if (this->m_journal != nullptr && size_error)
+        {
+            // A later attempt could not tell whether the file changed.
+            this->m_journal.reset();
+        }
+
+        if (this->m_journal != nullptr)
+        {
+            this->m_checkpoint.transfer_type = TRANSFER_TYPE_WRQ;
+            this->m_checkpoint.file_size = file_size;
+            (void)TFTP::read_modified_time(this->m_local_path, this->m_checkpoint.modified_time);
+
+            // Even from the start, the offset option asks the server to keep an aborted upload.
+            this->m_requested_options.offset = 0;
+            this->m_requested_options.negotiated |= OPTION_OFFSET;
+
+            transfer_checkpoint_t saved{};
+
+            // A local file which changed since the checkpoint is sent from its start.
+            if (this->m_journal->load(saved) && saved.transfer_type == TRANSFER_TYPE_WRQ &&
+                saved.file_size == file_size && saved.modified_time == this->m_checkpoint.modified_time &&
+                saved.offset > 0 && saved.offset <= file_size)
+            {
+                this->m_in_file.seekg(saved.offset);
+                this->resume_from(saved);
+            }
+        }
+
+        return true;
+    }
+
+    TFTPTask<bool> TFTPClientTransfer::receive_file()
+    {
+        TFTPCoSession& session = *this->m_session;
+        data_view_t data{};
+
+        co_await session.send_request(TFTP::make_rrq_packet(this->m_remote_name, this->m_requested_options));
+
+        receive_status_t status = co_await session.recv_block(data);
+
+        if (this->is_resume_refused(status))
+        {
+            // The file on the server no longer reaches the checkpoint.
+            this->m_journal->remove();
+            co_return this->finish(TRANSFER_STATUS_CHECKPOINT_STALE,
+                                   "Server refused to resume: " + std::string(session.get_error().message));
+        }
+
+        if (status == RECEIVE_STATUS_UNEXPECTED && session.get_op_code() == op_code::OACK)
+        {
+            session.on_answer();
+
+            if (!this->accept_oack_packet())
+            {
+                session.send_error(ERR_CODE_OPTION_NEGOTIATION, "Unacceptable OACK");
+                co_return this->finish(TRANSFER_STATUS_PROTOCOL_ERROR,
+                                       "Server acknowledged options which were not requested");
+            }
+
+            if (!this->accept_source())
+            {
+                session.send_error(ERR_CODE_OPTION_NEGOTIATION, "File changed during the download");
+                co_return this->finish(TRANSFER_STATUS_SOURCE_CHANGED,
+                                       "File changed on the server between the stripes");
+            }
+
+            if (!this->accept_sync())
+            {
+                co_return false;
+            }
+
+            if (this->m_journal != nullptr && !this->accept_checkpoint())
+            {
+                session.send_error(ERR_CODE_OPTION_NEGOTIATION, "File changed since the checkpoint");
+                this->m_journal->remove();
+                co_return this->finish(TRANSFER_STATUS_CHECKPOINT_STALE, "File changed since the checkpoint");
+            }
+
+            //ACK 0 starts the data transfer
+            co_await session.send_ack();
+            status = co_await session.recv_block(data);
+        }
+        else if (status == RECEIVE_STATUS_OK)
+        {
+            // Without an OACK the server sends the whole file and describes nothing.
+            if (!this->accept_sync())
+            {
+                co_return false;
+            }
+
+            if (this->m_journal != nullptr)
+            {
+                (void)this->accept_checkpoint();
+            }
+        }
+
+        if (status == RECEIVE_STATUS_OK && this->m_range_fd >= 0 &&
+            (session.get_session().get_options().negotiated & OPTION_OFFSET) == 0)
+        {
+            // Blocks of the whole file would land at the offset of the range.
+            session.send_error(ERR_CODE_OPTION_NEGOTIATION, "Byte range was not served");
+            co_return this->finish(TRANSFER_STATUS_PROTOCOL_ERROR, "Server does not serve byte ranges");
+        }
+
+        while (true)
+        {
+            if (status == RECEIVE_STATUS_UNEXPECTED && session.get_op_code() == op_code::OACK &&
+                this->m_progress.blocks == 0)
+            {
+                // The OACK was repeated because our ACK 0 got lost.
+                co_await session.send_ack();
+                status = co_await session.recv_block(data);
+                continue;
+            }
+
+            if (status != RECEIVE_STATUS_OK)
+            {
+                co_return this->fail(status, "Data transfer could not start");
+            }
+
+            const int payload_size = static_cast<int>(data.payload.size());
+            const data_verdict_t verdict = session.accept_data(data);
+
+            if (verdict == DATA_VERDICT_STORE || verdict == DATA_VERDICT_STORE_AND_ACK)
+            {
+                if (!this->store_block(data.payload.data(), payload_size))
+                {
+                    session.send_error(ERR_CODE_DISK_FULL, "File could not be written");
+                    co_return this->finish(TRANSFER_STATUS_FILE_ERROR,
+                                           "File " + this->m_local_path + " could not be written");
+                }
+
+                // The final ACK tells the server what arrived.
+                if ((session.get_session().get_options().negotiated & OPTION_CHECKSUM) != 0 &&
+                    session.get_session().is_last_block(payload_size))
+                {
+                    session.get_session().set_final_checksum(this->m_checksum.get_value());
+                }
+            }
+
+            if (verdict == DATA_VERDICT_STORE_AND_ACK || verdict == DATA_VERDICT_ACK)
+            {
+                co_await session.send_ack();
+            }
+
+            if (verdict == DATA_VERDICT_STORE_AND_ACK && session.get_session().is_last_block(payload_size))
+            {
+                break;
+            }
+
+            status = co_await session.recv_block(data);
+            this->m_progress.retransmissions = session.get_retransmissions();
+        }
+
+        // The final ACK leaves before the coroutine ends.
+        session.flush_packets();
+
+        if (this->m_range_fd < 0)
+        {
+            // A CR ending the file has no pair to decode it with.
+            this->m_out_file.write(this->m_decoded_block.data(),
+                                   this->m_netascii.finish_decode(this->m_decoded_block.data()));
+            this->m_out_file.close();
+
+            if (this->m_out_file.fail())
+            {
+                co_return this->finish(TRANSFER_STATUS_FILE_ERROR,
+                                       "File " + this->m_local_path + " could not be written");
+            }
+
+            const transfer_options_t& options = session.get_session().get_options();
+
+            if (this->m_sync && (options.negotiated & OPTION_MODIFIED_TIME) != 0)
+            {
+                // The next sync finds the file up to date.
+                (void)TFTP::write_modified_time(this->m_local_path, options.modified_time);
+            }
+        }
+
+        co_return this->finish(TRANSFER_STATUS_COMPLETE, "");
+    }
+
+    TFTPTask<bool> TFTPClientTransfer::send_file()
+    {
+        TFTPCoSession& session = *this->m_session;
+        ack_view_t ack{};
+
+        co_await session.send_request(TFTP::make_wrq_packet(this->m_remote_name, this->m_requested_options));
+
+        receive_status_t status = co_await session.recv_ack(ack);
+
+        if (status == RECEIVE_STATUS_PEER_ERROR && this->m_sync &&
+            session.get_error().error_code == ERR_CODE_FILE_EXISTS)
+        {
+            // The server holds the file with the same size and time.
+            co_return this->finish(TRANSFER_STATUS_SKIPPED, "");
+        }
+
+        if (this->is_resume_refused(status))
+        {
+            // The server no longer holds the partial upload, the next attempt starts over.
+            this->m_journal->remove();
+            co_return this->finish(TRANSFER_STATUS_CHECKPOINT_STALE,
+                                   "Server refused to resume: " + std::string(session.get_error().message));
+        }
+
+        if (status == RECEIVE_STATUS_UNEXPECTED && session.get_op_code() == op_code::OACK)
+        {
+            session.on_answer();
+
+            if (!this->accept_oack_packet())
+            {
+                session.send_error(ERR_CODE_OPTION_NEGOTIATION, "Unacceptable OACK");
+                co_return this->finish(TRANSFER_STATUS_PROTOCOL_ERROR,
+                                       "Server acknowledged options which were not requested");
+            }
+        }
+        else if (status != RECEIVE_STATUS_OK || ack.block_number != 0)
+        {
+            co_return this->fail(status == RECEIVE_STATUS_OK ? RECEIVE_STATUS_UNEXPECTED : status,
+                                 "Server did not acknowledge the WRQ");
+        }
+        else
+        {
+            session.on_answer();
+        }
+
+        if (this->m_journal != nullptr)
+        {
+            (void)this->accept_checkpoint();
+        }
+
+        while (true)
+        {
+            // Blocks of a rewound window go first, then new ones from the file.
+            co_await session.send_unsent_blocks();
+            this->send_data_packets();
+
+            status = co_await session.recv_ack(ack);
+            this->m_progress.retransmissions = session.get_retransmissions();
+
+            if (status == RECEIVE_STATUS_UNEXPECTED && session.get_op_code() == op_code::OACK)
+            {
+                // The OACK was repeated, blocks sent since are resent by the timer.
+                continue;
+            }
+
+            if (status != RECEIVE_STATUS_OK)
+            {
+                co_return this->fail(status, "ACK Packet of data is missing");
+            }
+
+            if (!session.accept_ack(ack))
+            {
+                continue;
+            }
+
+            if (this->m_journal != nullptr && session.get_session().is_window_acked())
+            {
+                this->advance_checkpoint();
+            }
+
+            if (this->m_file_exhausted && session.get_session().is_window_acked())
+            {
+                if (!this->verify_checksum(ack))
+                {
+                    co_return false;
+                }
+
+                co_return this->finish(TRANSFER_STATUS_COMPLETE, "");
+            }
+        }
+    }
+
+    void TFTPClientTransfer::send_data_packets()
+    {
+        TFTPSession& session = this->m_session->get_session();
+
+        while (!this->m_file_exhausted && session.is_window_open() && !session.has_unsent_packet())
+        {
+            // The file is read straight into the window slot of the block.
+            char* block = session.next_block_buffer();
+            int read_size = 0;
+
+            if (this->m_requested_options.mode == TRANSFER_MODE_NETASCII)
+            {
+                read_size = this->m_netascii.encode_block(this->m_in_file, block,
+                                                          session.get_options().block_size);
+            }
+            else
+            {
+                this->m_in_file.read(block, session.get_options().block_size);
+                read_size = static_cast<int>(this->m_in_file.gcount());
+            }
+
+            this->m_checksum.update(block, static_cast<size_t>(read_size));
+
+            if (this->m_journal != nullptr)
+            {
+                this->m_digest.update(block, static_cast<size_t>(read_size));
+            }
+
+            this->m_file_exhausted = session.is_last_block(read_size);
+            this->m_progress.bytes += read_size;
+            ++this->m_progress.blocks;
+
+            (void)this->m_session->send_block(read_size);
+        }
+    }
+
+    bool TFTPClientTransfer::accept_oack_packet()
+    {
+        transfer_options_t options{};
+
+        if (!TFTP::parse_oack_packet(this->m_session->get_packet(), this->m_session->get_packet_size(), options) ||
+            options.block_size > this->m_requested_options.block_size ||
+            options.window_size > this->m_requested_options.window_size ||
+            ((options.negotiated & OPTION_TIMEOUT) != 0 &&
+             options.timeout != this->m_requested_options.timeout) ||
+            ((options.negotiated & OPTION_OFFSET) != 0 &&
+             options.offset != this->m_requested_options.offset) ||
+            ((options.negotiated & OPTION_LENGTH) != 0 &&
+             options.length > this->m_requested_options.length))
+        {
+            return false;
+        }
+
+        options.mode = this->m_requested_options.mode;
+
+        if ((options.negotiated & OPTION_ROLLOVER) == 0)
+        {
+            options.rollover = this->m_requested_options.rollover;
+        }
+
+        if (this->m_transfer_type == TRANSFER_TYPE_RRQ &&
+            (options.negotiated & OPTION_TRANSFER_SIZE) != 0)
+        {
+            this->m_progress.total_bytes = options.transfer_size;
+        }
+
+        if ((options.negotiated & OPTION_LENGTH) != 0)
+        {
+            // A range cut at the end of the file comes back shorter.
+            this->m_progress.total_bytes = options.length;
+        }
+
+        this->m_session->set_options(options);
+
+        return true;
+    }
+
+    bool TFTPClientTransfer::accept_source() const
+    {
+        constexpr int described = OPTION_TRANSFER_SIZE | OPTION_MODIFIED_TIME;
+        const int expected = this->m_source.negotiated & described;
+
+        if (expected == 0)
+        {
+            return true;
+        }
+
+        // A file without a time of its own reports none on every stripe.
+        const transfer_options_t& options = this->m_session->get_session().get_options();
+
+        return (options.negotiated & described) == expected &&
+               ((expected & OPTION_TRANSFER_SIZE) == 0 || options.transfer_size == this->m_source.transfer_size) &&
+               ((expected & OPTION_MODIFIED_TIME) == 0 || options.modified_time == this->m_source.modified_time);
+    }
+
+    bool TFTPClientTransfer::accept_sync()
+    {
+        // A resumed download goes on in the file it opened.
+        if (!this->m_sync || this->m_range_fd >= 0 || this->m_out_file.is_open())
+        {
+            return true;
+        }
+
+        const transfer_options_t& options = this->m_session->get_session().get_options();
+        constexpr int described = OPTION_TRANSFER_SIZE | OPTION_MODIFIED_TIME;
+
+        if ((options.negotiated & described) == described &&
+            options.transfer_size == this->m_local_size &&
+            options.modified_time == this->m_local_time)
+        {
+            this->m_session->send_error(ERR_CODE_OPTION_NEGOTIATION, "File is up to date");
+            return this->finish(TRANSFER_STATUS_SKIPPED, "");
+        }
+
+        this->m_out_file.open(this->m_local_path, std::ios::binary | std::ios::trunc);
+
+        if (!this->m_out_file.is_open())
+        {
+            this->m_session->send_error(ERR_CODE_ACCESS_VIOLATION, "File could not be created");
+            return this->finish(TRANSFER_STATUS_FILE_ERROR, "File " + this->m_local_path + " could not be opened");
+        }
+
+        return true;
+    }
+
+    void TFTPClientTransfer::resume_from(const transfer_checkpoint_t& checkpoint)
+    {
+        this->m_checkpoint = checkpoint;
+        this->m_digest.resume(checkpoint.digest);
+        this->m_resume_offset = checkpoint.offset;
+        this->m_saved_offset = checkpoint.offset;
+        this->m_requested_options.offset = checkpoint.offset;
+        this->m_requested_options.negotiated |= OPTION_OFFSET;
+    }
+
+    bool TFTPClientTransfer::accept_checkpoint()
+    {
+        const transfer_options_t& options = this->m_session->get_session().get_options();
+
+        if (this->m_resume_offset > 0 && (options.negotiated & OPTION_OFFSET) == 0)
+        {
+            this->restart_file();
+        }
+
+        if (this->m_transfer_type == TRANSFER_TYPE_WRQ)
+        {
+            // The local file is the source, open_file() compared it with the checkpoint.
+            this->m_progress.total_bytes = this->m_checkpoint.file_size - this->m_resume_offset;
+
+            return true;
+        }
+
+        const bool described = (options.negotiated & OPTION_TRANSFER_SIZE) != 0 &&
+                               (options.negotiated & OPTION_MODIFIED_TIME) != 0;
+
+        if (this->m_resume_offset > 0)
+        {
+            if (!described ||
+                options.transfer_size != this->m_checkpoint.file_size ||
+                options.modified_time != this->m_checkpoint.modified_time)
+            {
+                return false;
+            }
+
+            this->m_progress.total_bytes = options.transfer_size - this->m_resume_offset;
+
+            return true;
+        }
+
+        if (!described)
+        {
+            // Without its size and time a later attempt could not tell whether the file changed.
+            this->m_journal->remove();
+            this->m_journal.reset();
+
+            return true;
+        }
+
+        this->m_checkpoint.file_size = options.transfer_size;
+        this->m_checkpoint.modified_time = options.modified_time;
+
+        return true;
+    }
+
+    bool TFTPClientTransfer::is_resume_refused(receive_status_t status) const
+    {
+        return status == RECEIVE_STATUS_PEER_ERROR &&
+               this->m_resume_offset > 0 &&
+               this->m_session->get_error().error_code == ERR_CODE_OPTION_NEGOTIATION;
+    }
+
+    void TFTPClientTransfer::restart_file()
+    {
+        if (this->m_transfer_type == TRANSFER_TYPE_RRQ)
+        {
+            this->m_out_file.close();
+            this->m_out_file.open(this->m_local_path, std::ios::binary | std::ios::trunc);
+        }
+        else
+        {
+            this->m_in_file.clear();
+            this->m_in_file.seekg(0);
+        }
+
+        this->m_digest.reset();
+        this->m_resume_offset = 0;
+        this->m_saved_offset = 0;
+        this->m_checkpoint.offset = 0;
+        this->m_checkpoint.digest = 0;
+    }
+
+    void TFTPClientTransfer::advance_checkpoint()
+    {
+        // Every byte before the offset is held by the receiver.
+        this->m_checkpoint.offset = this->m_resume_offset + this->m_progress.bytes;
+        this->m_checkpoint.digest = this->m_digest.get_value();
+
+        if (this->m_checkpoint.offset - this->m_saved_offset >= TFTP_JOURNAL_INTERVAL)
+        {
+            this->save_checkpoint();
+        }
+    }
+
+    void TFTPClientTransfer::save_checkpoint()
+    {
+        if (this->m_out_file.is_open())
+        {
+            this->m_out_file.flush();
+        }
+
+        if (this->m_journal->save(this->m_checkpoint))
+        {
+            this->m_saved_offset = this->m_checkpoint.offset;
+        }
+    }
+
+    bool TFTPClientTransfer::store_block(const char* payload, int payload_size)
+    {
+        // Taken over the payload as it travelled, before any translation.
+        this->m_checksum.update(payload, static_cast<size_t>(payload_size));
+        this->m_progress.bytes += payload_size;
+        ++this->m_progress.blocks;
+
+        if (this->m_range_fd >= 0)
+        {
+            return this->write_range(payload, payload_size);
+        }
+
+        if (this->m_requested_options.mode == TRANSFER_MODE_NETASCII)
+        {
+            // Decoding shrinks a block, only a CR held back by the last one adds a byte.
+            this->m_decoded_block.resize(this->m_session->get_session().get_options().block_size + 1);
+
+            const int decoded_size = this->m_netascii.decode(payload, payload_size, this->m_decoded_block.data());
+            this->m_out_file.write(this->m_decoded_block.data(), decoded_size);
+        }
+        else
+        {
+            this->m_out_file.write(payload, payload_size);
+
+            if (this->m_journal != nullptr)
+            {
+                this->m_digest.update(payload, static_cast<size_t>(payload_size));
+                this->advance_checkpoint();
+            }
+        }
+
+        return !this->m_out_file.fail();
+    }
+
+    bool TFTPClientTransfer::write_range(const char* payload, int payload_size)
+    {
+        while (payload_size > 0)
+        {
+#ifdef __linux__
+            const ssize_t written = pwrite(this->m_range_fd, payload, static_cast<size_t>(payload_size),
+                                           static_cast<off_t>(this->m_range_offset));
+#endif
+#ifdef _WIN32
+            // The stripes of a file share the descriptor, but all run on the thread of the reactor.
+            const long long written = _lseeki64(this->m_range_fd, this->m_range_offset, SEEK_SET) < 0
+                                      ? -1
+                                      : _write(this->m_range_fd, payload, static_cast<unsigned>(payload_size));
+#endif
+
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (written <= 0)
+            {
+                return false;
+            }
+
+            payload += written;
+            payload_size -= static_cast<int>(written);
+            this->m_range_offset += written;
+        }
+
+        return true;
+    }
+
+    bool TFTPClientTransfer::verify_checksum(const ack_view_t& ack)
+    {
+        if ((this->m_session->get_session().get_options().negotiated & OPTION_CHECKSUM) == 0)
+        {
+            return true;
+        }
+
+        uint32_t reported = 0;
+
+        if (!TFTP::parse_ack_checksum(ack, reported))
+        {
+            return this->finish(TRANSFER_STATUS_PROTOCOL_ERROR,
+                                "Server acknowledged the checksum option but reported no checksum");
+        }
+
+        if (reported != this->m_checksum.get_value())
+        {
+            char digests[64];
+            snprintf(digests, sizeof(digests), "sent %08x, server stored %08x",
+                     this->m_checksum.get_value(), reported);
+
+            return this->finish(TRANSFER_STATUS_CHECKSUM_MISMATCH, std::string("Checksum mismatch, ") + digests);
+        }
+
+        return true;
+    }
+
+    bool TFTPClientTransfer::fail(receive_status_t status, const std::string& message)
+    {
+        if (status == RECEIVE_STATUS_TIMED_OUT)
+        {
+            return this->finish(TRANSFER_STATUS_TIMED_OUT, "Server did not answer, transfer timed out");
+        }
+
+        if (status == RECEIVE_STATUS_PEER_ERROR)
+        {
+            return this->finish(TRANSFER_STATUS_SERVER_ERROR,
+                                "Server error: " + std::string(this->m_session->get_error().message));
+        }
+
+        this->m_session->send_error(ERR_CODE_ILLEGAL_OPERATION, message);
+
+        return this->finish(TRANSFER_STATUS_PROTOCOL_ERROR, message);
+    }
+
+    bool TFTPClientTransfer::finish(transfer_status_t status, const std::string& message)
+    {
+        const auto now = TFTPRetransmitter::steady_clock_t::now();
+
+        if (this->m_journal != nullptr)
+        {
+            if (status == TRANSFER_STATUS_COMPLETE)
+            {
+                this->m_journal->remove();
+            }
+            else if (status != TRANSFER_STATUS_CHECKPOINT_STALE &&
+                     this->m_checkpoint.offset > this->m_saved_offset)
+            {
+                // The next attempt resumes from the last bytes the receiver holds.
+                this->save_checkpoint();
+            }
+        }
+
+        this->m_in_file.close();
+
+        if (this->m_out_file.is_open())
+        {
+            this->m_out_file.close();
+        }
+
+        this->m_result.status = status;
+        this->m_result.message = message;
+        this->m_result.progress = this->m_progress;
+        // A resumed transfer reports the digest of the whole file.
+        this->m_result.checksum = this->m_journal != nullptr ? this->m_digest.get_value() : this->m_checksum.get_value();
+        this->m_result.queue_time
+            = std::chrono::duration_cast<std::chrono::microseconds>(this->m_started - this->m_created);
+        this->m_result.transfer_time
+            = std::chrono::duration_cast<std::chrono::microseconds>(now - this->m_started);
+
+        if (this->m_session)
+        {
+            this->m_progress.retransmissions = this->m_session->get_retransmissions();
+            this->m_result.progress = this->m_progress;
+            this->m_result.options = this->m_session->get_session().get_options();
+            this->m_result.srtt = this->m_session->get_retransmitter().get_srtt();
+        }
+
+        this->m_ended = true;
+
+        return false;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
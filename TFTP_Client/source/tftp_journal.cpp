@@ -0,0 +1,139 @@
+///
+/// @file tftp_journal.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPJournal class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "tftp_journal.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <tftp_checksum.hpp>
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPJournal::TFTPJournal(const std::string& local_path)
+        : m_path{local_path + TFTP_JOURNAL_SUFFIX},
+          m_temp_path{local_path + TFTP_JOURNAL_SUFFIX + ".tmp"}
+    {
+    }
+
+    bool TFTPJournal::load(transfer_checkpoint_t& checkpoint) const
+    {
+        std::ifstream journal(this->m_path);
+        std::string line{};
+
+        if (!journal.is_open() || !std::getline(journal, line))
+        {
+            return false;
+        }
+
+        // One line: magic, direction, source size, source time, offset, digest.
+        char magic[16] = {};
+        int transfer_type = 0;
+        unsigned long digest = 0;
+
+        if (sscanf(line.c_str(), "%15s %d %" SCNd64 " %" SCNd64 " %" SCNd64 " %lx",
+                   magic, &transfer_type, &checkpoint.file_size, &checkpoint.modified_time,
+                   &checkpoint.offset, &digest) != 6 ||
+            std::string(magic) != TFTP_JOURNAL_MAGIC ||
+            (transfer_type != TRANSFER_TYPE_RRQ && transfer_type != TRANSFER_TYPE_WRQ) ||
+            checkpoint.offset < 0)
+        {
+            return false;
+        }
+
+        checkpoint.transfer_type = static_cast<transfer_type_t>(transfer_type);
+        checkpoint.digest = static_cast<uint32_t>(digest);
+
+        return true;
+    }
+
+    bool TFTPJournal::save(const transfer_checkpoint_t& checkpoint) const
+    {
+        char line[128];
+        const int line_len = snprintf(line, sizeof(line), "%s %d %" PRId64 " %" PRId64 " %" PRId64 " %08lx\n",
+                                      TFTP_JOURNAL_MAGIC, static_cast<int>(checkpoint.transfer_type),
+                                      checkpoint.file_size, checkpoint.modified_time, checkpoint.offset,
+                                      static_cast<unsigned long>(checkpoint.digest));
+
+        std::ofstream journal(this->m_temp_path, std::ios::binary | std::ios::trunc);
+        journal.write(line, line_len);
+        journal.close();
+
+        if (journal.fail())
+        {
+            return false;
+        }
+
+        // Renamed over the old one, a reader sees either checkpoint whole.
+        std::error_code error;
+        std::filesystem::rename(this->m_temp_path, this->m_path, error);
+
+        return !error;
+    }
+
+    void TFTPJournal::remove() const
+    {
+        (void)std::remove(this->m_path.c_str());
+    }
+
+    bool TFTPJournal::verify(const std::string& file_path, const transfer_checkpoint_t& checkpoint)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        std::vector<char> buffer(TFTP_WRITE_BEHIND_BUFFER_SIZE);
+        TFTPChecksum checksum{};
+        int64_t remaining = checkpoint.offset;
+
+        while (remaining > 0)
+        {
+            const auto chunk = static_cast<std::streamsize>(std::min<int64_t>(remaining, static_cast<int64_t>(buffer.size())));
+
+            if (!file.read(buffer.data(), chunk))
+            {
+                return false;
+            }
+
+            checksum.update(buffer.data(), static_cast<size_t>(chunk));
+            remaining -= chunk;
+        }
+
+        return checksum.get_value() == checkpoint.digest;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,41 @@
+///
+/// @file main.cpp
+/// @author Yasin BASAR
+/// @brief Builds a pack file for TFTPPackStorage out of a directory.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#include <iostream>
+#include <tftp_pack_storage.hpp>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <directory> <pack file>\n";
+        return 1;
+    }
+
+    if (!YB::TFTPPackStorage::build(argv[1], argv[2]))
+    {
+        std::cout << "Pack " << argv[2] << " could not be built from " << argv[1] << ".\n";
+        return 1;
+    }
+
+    // Opening the result checks the index the server is going to trust.
+    YB::TFTPPackStorage pack;
+
+    if (!pack.open(argv[2]))
+    {
+        std::cout << "Pack " << argv[2] << " is malformed.\n";
+        return 1;
+    }
+
+    std::cout << "Packed " << pack.get_file_count() << " files into " << argv[2] << ".\n";
+
+    return 0;
+}
+
+/* end of file */
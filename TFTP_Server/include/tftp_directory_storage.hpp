@@ -0,0 +1,98 @@
+///
+/// @file tftp_directory_storage.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPDirectoryStorage class,
+///        which serves the files of a directory.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_DIRECTORY_STORAGE_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_DIRECTORY_STORAGE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include "tftp_file_cache.hpp"
+#include "tftp_root_index.hpp"
+#include "tftp_storage.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPDirectoryStorage
+    /// @brief Default backend of the server, the files of the directory given
+    ///        to run(). Names are resolved through a TFTPRootIndex and RRQ
+    ///        files are mapped through the file cache. Not thread safe, every
+    ///        shard has its own.
+    class TFTPDirectoryStorage : public TFTPStorage
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPDirectoryStorage(TFTPDirectoryStorage &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPDirectoryStorage &operator=(TFTPDirectoryStorage &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPDirectoryStorage(const TFTPDirectoryStorage &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPDirectoryStorage &operator=(TFTPDirectoryStorage const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPDirectoryStorage.
+        /// @param file_cache Cache to map RRQ files through, nullptr maps every request on its own.
+        /// @throw std::runtime_error if the root index cannot be created.
+        explicit TFTPDirectoryStorage(std::shared_ptr<TFTPFileCache> file_cache);
+
+        /// @brief Destructor for TFTPDirectoryStorage.
+        ~TFTPDirectoryStorage() override = default;
+
+        /// @brief Replaces the file cache.
+        /// @param file_cache The cache to map RRQ files through.
+        void set_file_cache(std::shared_ptr<TFTPFileCache> file_cache);
+
+        void set_root(const std::string& root_directory) override;
+
+        storage_status_t resolve(const std::string& file_name, transfer_type_t transfer_type,
+                                 resolved_file_t& file) override;
+
+        std::shared_ptr<const TFTPMappedFile> open_read(const resolved_file_t& file) override;
+
+        SOCKET get_notify_socket() const override;
+
+        void refresh() override;
+
+        void expire_uploads() override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        std::shared_ptr<TFTPFileCache> m_file_cache; ///< Mappings of hot RRQ files.
+        TFTPRootIndex m_root_index; ///< Resolved names of the serving directory.
+        std::string m_root_directory; ///< The serving directory.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_DIRECTORY_STORAGE_HPP
+
+/* End of File */
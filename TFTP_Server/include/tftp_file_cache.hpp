@@ -0,0 +1,134 @@
+///
+/// @file tftp_file_cache.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPFileCache class,
+///        which shares the mapped views of hot files between RRQ sessions.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_FILE_CACHE_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_FILE_CACHE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <tftp_mapped_file.hpp>
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPFileCache
+    /// @brief Server wide, size bounded cache of mapped RRQ files. Entries are
+    ///        keyed by the resolved path and checked against the modification
+    ///        time and size the root index holds for the file on every
+    ///        lookup, so an updated file is mapped again without the cache
+    ///        asking the file system. The least recently used files are evicted first;
+    ///        sessions hold their mapping, so eviction never pulls a file away
+    ///        from a running transfer. Safe to share between threads.
+    class TFTPFileCache
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPFileCache(TFTPFileCache &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPFileCache &operator=(TFTPFileCache &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPFileCache(const TFTPFileCache &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPFileCache &operator=(TFTPFileCache const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Counters of the cache.
+        typedef struct stats_s
+        {
+            uint64_t hits; ///< Lookups served by a cached mapping.
+            uint64_t misses; ///< Lookups which had to map the file.
+            uint64_t evictions; ///< Files dropped to stay within the capacity.
+            uint64_t invalidations; ///< Files dropped because they changed on disk.
+            size_t files; ///< Files cached now.
+            size_t bytes; ///< Bytes cached now.
+        } stats_t;
+
+        /// @brief Constructor for TFTPFileCache.
+        /// @param capacity Bytes of file contents kept mapped at most.
+        explicit TFTPFileCache(size_t capacity = TFTP_FILE_CACHE_CAPACITY);
+
+        /// @brief Destructor for TFTPFileCache.
+        ~TFTPFileCache() = default;
+
+        /// @brief Returns the mapping of a file, from the cache if it is
+        ///        still current. Files larger than the capacity are mapped
+        ///        without being cached.
+        /// @param file_path Resolved path of the file.
+        /// @param size Current size of the file.
+        /// @param modified Current modification time of the file.
+        /// @return The mapping, nullptr if the file could not be mapped.
+        std::shared_ptr<const TFTPMappedFile> open(const std::string& file_path, uintmax_t size,
+                                                   std::filesystem::file_time_type modified);
+
+        /// @brief Sets the capacity, evicting files which no longer fit.
+        /// @param capacity Bytes of file contents kept mapped at most, 0 disables the cache.
+        void set_capacity(size_t capacity);
+
+        /// @brief Returns the counters of the cache.
+        stats_t get_stats() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief One cached file.
+        typedef struct entry_s
+        {
+            std::string file_path; ///< Resolved path of the file.
+            std::filesystem::file_time_type modified; ///< Modification time when mapped.
+            uintmax_t size; ///< File size when mapped.
+            std::shared_ptr<const TFTPMappedFile> file; ///< The mapping.
+        } entry_t;
+
+        /// @brief Drops the least recently used files until the cache fits its capacity.
+        void evict();
+
+        /// @brief Drops one file.
+        /// @param entry Position of the file in the recency list.
+        void erase(std::list<entry_t>::iterator entry);
+
+        mutable std::mutex m_mutex; ///< Guards every member below.
+        std::list<entry_t> m_entries; ///< Cached files, most recently used first.
+        std::unordered_map<std::string, std::list<entry_t>::iterator> m_index; ///< Cached files by path.
+        size_t m_capacity; ///< Bytes of file contents kept mapped at most.
+        stats_t m_stats; ///< Counters of the cache.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_FILE_CACHE_HPP
+
+/* End of File */
@@ -0,0 +1,139 @@
+///
+/// @file tftp_pack_storage.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPPackStorage class,
+///        which serves many small files out of one memory mapped pack file.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_PACK_STORAGE_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_PACK_STORAGE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "tftp_storage.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPPackStorage
+    /// @brief Read-only backend serving the files of a pack built offline by
+    ///        build(). The pack holds a header, an index sorted by name, the
+    ///        names and the file contents, and is mapped once; a lookup is a
+    ///        binary search over the index and a RRQ gets a slice of the
+    ///        mapping, so no file is opened per request. WRQs are refused.
+    ///        Immutable once opened, so the shards of a pool can share one.
+    class TFTPPackStorage : public TFTPStorage
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPPackStorage(TFTPPackStorage &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPPackStorage &operator=(TFTPPackStorage &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPPackStorage(const TFTPPackStorage &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPPackStorage &operator=(TFTPPackStorage const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Header at the start of a pack, in host byte order.
+        typedef struct pack_header_s
+        {
+            char magic[8]; ///< TFTP_PACK_MAGIC without its terminator.
+            uint32_t version; ///< TFTP_PACK_VERSION.
+            uint32_t file_count; ///< Number of index entries.
+            uint64_t index_offset; ///< File offset of the index.
+            uint64_t names_offset; ///< File offset of the names.
+            uint64_t names_size; ///< Bytes of all names.
+        } pack_header_t;
+
+        /// @brief Index entry of one file, entries are sorted by name.
+        typedef struct pack_entry_s
+        {
+            uint64_t name_offset; ///< Offset of the name from the start of the names.
+            uint32_t name_size; ///< Bytes of the name, which is not terminated.
+            uint32_t reserved; ///< Zero.
+            uint64_t data_offset; ///< File offset of the contents, TFTP_PACK_ALIGNMENT aligned.
+            uint64_t data_size; ///< Bytes of the contents.
+        } pack_entry_t;
+
+        /// @brief Constructor for TFTPPackStorage.
+        TFTPPackStorage();
+
+        /// @brief Destructor for TFTPPackStorage.
+        ~TFTPPackStorage() override = default;
+
+        /// @brief Maps a pack and checks its header and index.
+        /// @param pack_path Path of the pack.
+        /// @return False if the pack could not be mapped or is malformed.
+        bool open(const std::string& pack_path);
+
+        /// @brief Returns the number of files in the pack.
+        size_t get_file_count() const;
+
+        /// @brief Packs the regular files below a directory. Names are the
+        ///        paths relative to the directory with forward slashes. The
+        ///        pack is written next to its path and renamed into place.
+        /// @param directory The directory.
+        /// @param pack_path Path of the pack.
+        /// @return False if a file could not be read or the pack written.
+        static bool build(const std::string& directory, const std::string& pack_path);
+
+        /// @brief The pack is chosen by open(), the directory is ignored.
+        void set_root(const std::string& root_directory) override;
+
+        storage_status_t resolve(const std::string& file_name, transfer_type_t transfer_type,
+                                 resolved_file_t& file) override;
+
+        std::shared_ptr<const TFTPMappedFile> open_read(const resolved_file_t& file) override;
+
+        bool has_file_paths() const override;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Turns a requested name into the form names are packed in.
+        /// @param file_name Name as sent by the client.
+        /// @param name Receives the packed form.
+        /// @return False if the name leaves the packed directory.
+        static bool normalize(const std::string& file_name, std::string& name);
+
+        /// @brief Finds the index entry of a packed name.
+        /// @param name Name in packed form.
+        /// @return The entry, nullptr if the pack has no such file.
+        const pack_entry_t* find(const std::string& name) const;
+
+        std::shared_ptr<const TFTPMappedFile> m_pack; ///< Mapping of the whole pack.
+        const pack_entry_t* m_entries; ///< First index entry inside the mapping.
+        const char* m_names; ///< First name byte inside the mapping.
+        size_t m_file_count; ///< Number of index entries.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_PACK_STORAGE_HPP
+
+/* End of File */
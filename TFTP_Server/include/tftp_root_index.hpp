@@ -0,0 +1,135 @@
+///
+/// @file tftp_root_index.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPRootIndex class,
+///        which resolves requested file names inside the serving directory.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_ROOT_INDEX_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_ROOT_INDEX_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <socket_macros.hpp>
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPRootIndex
+    /// @brief Index of the serving directory of a server. Requested names are
+    ///        resolved once and kept with the metadata of their file, so a
+    ///        repeated request costs a hash lookup instead of a canonical path
+    ///        walk. On Linux an inotify watch on the directory of every entry
+    ///        drops the entries of files which are created, written, renamed or
+    ///        removed; other platforms resolve every request. Names which
+    ///        resolve outside the root or to an unfinished upload are refused.
+    class TFTPRootIndex
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPRootIndex(TFTPRootIndex &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPRootIndex &operator=(TFTPRootIndex &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPRootIndex(const TFTPRootIndex &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPRootIndex &operator=(TFTPRootIndex const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief A resolved file name.
+        typedef struct entry_s
+        {
+            std::string path; ///< Resolved path with the OS preferred separator.
+            bool exists = false; ///< The path names an existing file system object.
+            bool regular = false; ///< The path names a regular file.
+            uint64_t size = 0; ///< Size of a regular file in bytes.
+            std::filesystem::file_time_type modified{}; ///< Last modification time of an existing file.
+        } entry_t;
+
+        /// @brief Constructor for TFTPRootIndex.
+        /// @throw std::runtime_error if the inotify descriptor cannot be created.
+        TFTPRootIndex();
+
+        /// @brief Destructor for TFTPRootIndex.
+        ~TFTPRootIndex();
+
+        /// @brief Sets the directory requests are resolved in, dropping the
+        ///        entries of the previous one.
+        /// @param root_directory The serving directory.
+        void set_root(const std::string& root_directory);
+
+        /// @brief Resolves a requested file name.
+        /// @param file_name Name as sent by the client.
+        /// @param entry Receives the resolved path and its metadata.
+        /// @return False if the name resolves outside the root, to the root
+        ///         itself or to an unfinished upload.
+        bool resolve(const std::string& file_name, entry_t& entry);
+
+        /// @brief Drops the entries the pending change notifications refer to.
+        void refresh();
+
+        /// @brief Returns the descriptor which becomes readable when a watched
+        ///        directory changes, INVALID_SOCKET where the platform has none.
+        SOCKET get_notify_socket() const;
+
+        /// @brief Returns the number of cached names.
+        size_t get_size() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Resolves a file name without the index.
+        /// @param file_name Name as sent by the client.
+        /// @param entry Receives the resolved path and its metadata.
+        /// @return False if the name resolves outside the root.
+        bool resolve_uncached(const std::string& file_name, entry_t& entry) const;
+
+        /// @brief Caches an entry if its directory can be watched.
+        /// @param file_name Name as sent by the client.
+        /// @param entry The resolved entry.
+        void insert(const std::string& file_name, const entry_t& entry);
+
+        /// @brief Drops every entry and watch.
+        void clear();
+
+        std::filesystem::path m_root; ///< Canonical serving directory.
+        std::unordered_map<std::string, entry_t> m_entries; ///< Resolved entries by requested name.
+        std::unordered_map<std::string, std::vector<std::string>> m_names_by_path; ///< Requested names of every resolved path.
+        std::unordered_map<std::string, int> m_watches; ///< Watch descriptor of every watched directory.
+        std::unordered_map<int, std::string> m_watched_directories; ///< Watched directory of every watch descriptor.
+        int m_notify_fd; ///< inotify descriptor, -1 if none.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_ROOT_INDEX_HPP
+
+/* End of File */
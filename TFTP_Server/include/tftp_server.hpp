@@ -15,45 +15,25 @@
 // Project Includes
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef _WIN32
-#include <WinSock2.h> /*Windows socket architecture*/
-
-typedef int socklen_t;
-
-#define GET_LAST_ERROR() std::to_string(WSAGetLastError())
-#define CLOSE_SOCKET(s) closesocket(s)
-#define CLEANUP() WSACleanup();
-#endif
-
-#ifdef __linux__
-#include <sys/socket.h> /*Linux socket architecture*/
-#include <netinet/in.h> /*Internet socket structures*/
-#include <arpa/inet.h> /*Contains inet_ functions*/
-#include <unistd.h> /*Contains close() function for linux file describers*/
-
-#include <algorithm> /*Contains std::replace()*/
-#include <cstring> /*Contains memset()*/
-
-typedef int SOCKET;
-typedef sockaddr SOCKADDR;
-typedef sockaddr_in SOCKADDR_IN;
-typedef sockaddr_storage SOCKADDR_STORAGE_LH;
-
-#define SOCKET_ERROR (-1)
-#define INVALID_SOCKET 0
-
-#define GET_LAST_ERROR() std::string(strerror(errno))
-#define CLOSE_SOCKET(s) close(s)
-#define CLEANUP()
-#endif
-
 #include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Third Party Includes
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <socket_macros.hpp>
 #include <tftp.hpp>
+#include <tftp_packet.hpp>
+#include <tftp_poller.hpp>
+#include <tftp_reactor.hpp>
+#include <tftp_receive_batch.hpp>
+#include <tftp_timing_wheel.hpp>
+#include "tftp_directory_storage.hpp"
+#include "tftp_server_session.hpp"
+#include "tftp_write_behind.hpp"
 
 namespace YB
 {
@@ -83,7 +63,9 @@ namespace YB
         ~TFTPServer();
 
         /// @brief Creates a socket for TFTP communication.
-        void create_socket();
+        /// @param reuse_port Let other sockets bind the same address, the
+        ///        kernel then spreads the requests across them (Linux only).
+        void create_socket(bool reuse_port = false);
 
         /// @brief Binds the socket to a specific IP address and port.
         void bind_socket(const char* server_ip, int port);
@@ -92,36 +74,145 @@ namespace YB
         /// @param save_directory The directory where received files will be saved.
         void wait_for_a_request(const std::string& save_directory);
 
+        /// @brief Sets how many retransmissions in a row end a session.
+        /// @param max_retries Number of retransmissions before giving up, 0 to TFTP_MAX_RETRIES.
+        /// @throw std::runtime_error if the number is out of range.
+        void set_max_retries(int max_retries);
+
+        /// @brief Sets how many bytes of hot RRQ files stay mapped between
+        ///        transfers, 0 disables the file cache.
+        /// @param capacity Capacity of the file cache in bytes.
+        void set_file_cache_capacity(size_t capacity);
+
+        /// @brief Replaces the file cache, so several servers can share one.
+        /// @param file_cache The cache to map RRQ files through.
+        void set_file_cache(std::shared_ptr<TFTPFileCache> file_cache);
+
+        /// @brief Returns the hit, miss and eviction counters of the file cache.
+        TFTPFileCache::stats_t get_file_cache_stats() const;
+
+        /// @brief Replaces the storage backend, by default the directory given
+        ///        to run() through a TFTPDirectoryStorage.
+        /// @param storage The backend, shared only if it is thread safe.
+        void set_storage(std::shared_ptr<TFTPStorage> storage);
+
+        /// @brief Sets how finished uploads are flushed before they are renamed
+        ///        into place, SYNC_POLICY_GROUP by default.
+        /// @param sync_policy The policy.
+        void set_sync_policy(sync_policy_t sync_policy);
+
+        /// @brief Sets the block number which follows 65535 for clients which
+        ///        do not send the rollover option, ROLLOVER_POLICY_ZERO by
+        ///        default. Clients which send it get what they ask for.
+        /// @param rollover The policy.
+        void set_rollover_policy(rollover_policy_t rollover);
+
+        /// @brief Serves RRQ and WRQ requests until the process ends.
+        ///        Every transfer runs on its own ephemeral socket and all of
+        ///        them are multiplexed by a single event loop.
+        /// @param save_directory The directory where files are served from and saved to.
+        void run(const std::string& save_directory);
+
     ////////////////////////////////////////////////////////////////////////////
     // Private Members
     ////////////////////////////////////////////////////////////////////////////
     private:
 
-        /// @brief Sends an acknowledgment packet to the client.
-        void send_ack_packet();
-
-        /// @brief Sends a data packet to the client.
-        /// @param number_of_bytes_from_last_read Number of bytes read from the file.
-        void send_data_packet(int number_of_bytes_from_last_read);
-
-        /// @brief Receives data from the client.
-        /// @return The number of bytes received.
-        int receive_data_from_client();
+        /// @brief Runs the event loop of the server.
+        /// @param save_directory The directory where files are served from and saved to.
+        /// @param single_transfer Stop after the first transfer has ended.
+        void serve(const std::string& save_directory, bool single_transfer);
+
+        /// @brief Takes every request waiting on the listening socket and
+        ///        starts their sessions.
+        /// @param single_transfer Stop after the first session has been started.
+        /// @return True if single_transfer is set and a session has been started.
+        bool accept_requests(bool single_transfer);
+
+        /// @brief Starts the session of one request.
+        /// @param packet The request, m_server_storage holds its sender.
+        /// @param bytes Number of bytes received.
+        /// @return True if a new session has been started.
+        bool accept_request(const char* packet, int bytes);
+
+        /// @brief Returns the milliseconds until the reactor has to resume a
+        ///        session, -1 if no session has a deadline.
+        int next_timeout_ms() const;
+
+        /// @brief Releases the sessions the reactor resumed whose transfer has ended.
+        void close_ended_sessions();
+
+        /// @brief Hands the finished background writes to their sessions.
+        void complete_uploads();
+
+        /// @brief Lets the storage remove stale unfinished uploads, at most
+        ///        once every TFTP_PARTIAL_SWEEP_INTERVAL_S.
+        void expire_uploads();
+
+        /// @brief Stops watching a session and releases it.
+        /// @param session The session which has ended.
+        void close_session(TFTPServerSession* session);
+
+        /// @brief Sends an error packet from the listening socket.
+        /// @param error_code One of the ERR_CODE_* values.
+        /// @param error_message Human readable error message.
+        void send_error_packet(int error_code, const std::string& error_message);
+
+        /// @brief Returns a key which identifies a client address and port.
+        static uint64_t peer_key(const SOCKADDR_STORAGE_LH& peer);
+
+#ifdef TFTP_IO_URING
+        /// @brief Runs the event loop of the server on the io_uring.
+        /// @param single_transfer Stop after the first transfer has ended.
+        void serve_ring(bool single_transfer);
+
+        /// @brief Handles a completion of the listening socket receive.
+        /// @param completion The completion.
+        /// @param accepting New requests are accepted.
+        /// @return True if a new session has been started.
+        bool on_request_completion(const TFTPUring::completion_t& completion, bool accepting);
+
+        /// @brief Hands a completion to the session which submitted the request.
+        /// @param completion The completion.
+        void on_session_completion(const TFTPUring::completion_t& completion);
+
+        /// @brief Queues the multishot receive of a socket.
+        /// @param socket Socket to receive from.
+        /// @param ring_id Id of the owner, 0 for the listening socket.
+        void arm_receive(SOCKET socket, uint64_t ring_id);
+#endif
 
         /// @brief Closes the socket and cleans up the Windows Socket Architecture.
         void close_socket_architecture() const;
 
-        /// @brief Returns a path with the OS preferred separator.
-        ///        In Linux forward slash, In Windows backward slash.
-        std::string preferred_file_path(const std::string& save_directory,
-                                        const std::string& file_name) const;
 
-        std::unique_ptr<char[]> m_incoming_buffer; ///< Buffer for incoming data.
-        std::unique_ptr<char[]> m_outgoing_buffer; ///< Buffer for outgoing data.
+        TFTPReceiveBatch m_request_batch; ///< Requests taken from the listening socket at once.
+
+        std::unique_ptr<TFTPReactor> m_reactor; ///< Resumes the sessions for packets and deadlines.
+        std::unique_ptr<TFTPWriteBehind> m_write_behind; ///< Background writer of the uploaded files.
+        std::vector<void*> m_written_uploads; ///< Scratch list of sessions with finished writes.
+        std::unordered_map<TFTPServerSession*, std::unique_ptr<TFTPServerSession>> m_sessions; ///< Running sessions.
+        std::unordered_map<uint64_t, TFTPServerSession*> m_sessions_by_peer; ///< Running sessions by client.
+        std::vector<void*> m_ready_contexts; ///< Scratch list of readable sockets of no session.
+        std::vector<void*> m_resumed; ///< Scratch list of sessions the reactor resumed.
+        int m_max_retries; ///< Retransmissions in a row which end a session.
+        rollover_policy_t m_rollover; ///< Rollover of the requests without the rollover option.
+        std::shared_ptr<TFTPFileCache> m_file_cache; ///< Mapped RRQ files shared by the sessions.
+        std::shared_ptr<TFTPStorage> m_storage; ///< Backend requested files are resolved and read through.
+        TFTPTimingWheel::steady_clock_t::time_point m_next_upload_sweep; ///< Earliest time of the next sweep of unfinished uploads.
+
+#ifdef TFTP_IO_URING
+        std::unique_ptr<TFTPUring> m_ring; ///< Ring of the server, nullptr if the kernel lacks support.
+        std::vector<TFTPUring::completion_t> m_completions; ///< Scratch list of completions.
+        std::unordered_map<uint64_t, TFTPServerSession*> m_sessions_by_ring_id; ///< Running sessions by ring id.
+        std::unordered_map<uint64_t, std::unique_ptr<TFTPServerSession>> m_draining_sessions; ///< Ended sessions whose file I/O still runs.
+        uint64_t m_next_ring_id; ///< Ring id of the next session.
+        bool m_request_receive_armed; ///< The multishot receive of the listening socket is running.
+#endif
 
         SOCKET m_server_socket; ///< Server socket descriptor.
         SOCKADDR_IN m_server_info; ///< Server socket address information.
-        SOCKADDR_STORAGE_LH m_server_storage; ///< Storage for server socket address.
+        SOCKADDR_STORAGE_LH m_server_storage; ///< Sender of the request being handled.
 
         socklen_t m_addr_storage_size; ///< Size of the socket address structure.
 
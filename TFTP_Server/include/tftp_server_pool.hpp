@@ -0,0 +1,136 @@
+///
+/// @file tftp_server_pool.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPServerPool class,
+///        which shards the server across worker threads.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_SERVER_POOL_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_SERVER_POOL_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tftp_file_cache.hpp"
+#include "tftp_server.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+    /// @class TFTPServerPool
+    /// @brief Runs one TFTPServer shard per worker thread. Every shard has its
+    ///        own listening socket bound with SO_REUSEPORT, its own event loop
+    ///        and its own sessions, so the kernel spreads the requests across
+    ///        the cores. Shards only share the file cache and the settings.
+    ///        Windows does not balance a shared port, a single shard runs there.
+    class TFTPServerPool
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPServerPool(TFTPServerPool &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPServerPool &operator=(TFTPServerPool &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPServerPool(const TFTPServerPool &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPServerPool &operator=(TFTPServerPool const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPServerPool. Creates the shards.
+        /// @param worker_count Number of shards, 0 for one per hardware thread.
+        explicit TFTPServerPool(unsigned worker_count = 0);
+
+        /// @brief Destructor for TFTPServerPool. Waits for the workers.
+        ~TFTPServerPool();
+
+        /// @brief Creates the listening socket of every shard and binds them
+        ///        to the same IP address and port.
+        /// @throw std::runtime_error if a socket cannot be created or bound.
+        void bind_socket(const char* server_ip, int port);
+
+        /// @brief Sets how many retransmissions in a row end a session.
+        /// @param max_retries Number of retransmissions before giving up, 0 to TFTP_MAX_RETRIES.
+        /// @throw std::runtime_error if the number is out of range.
+        void set_max_retries(int max_retries);
+
+        /// @brief Sets the capacity of the file cache shared by the shards.
+        /// @param capacity Capacity of the file cache in bytes.
+        void set_file_cache_capacity(size_t capacity);
+
+        /// @brief Serves every shard from one backend instead of the directory
+        ///        given to run(), the backend has to be thread safe.
+        /// @param storage The backend, e.g. a TFTPPackStorage.
+        void set_storage(const std::shared_ptr<TFTPStorage>& storage);
+
+        /// @brief Sets how every shard flushes finished uploads.
+        /// @param sync_policy The policy.
+        void set_sync_policy(sync_policy_t sync_policy);
+
+        /// @brief Sets the rollover of every shard for clients which do not
+        ///        send the rollover option.
+        /// @param rollover The policy.
+        void set_rollover_policy(rollover_policy_t rollover);
+
+        /// @brief Pins the shard workers round-robin across the CPUs the process
+        ///        may run on, must be called before run().
+        /// @param pin_workers Whether the workers are pinned.
+        void set_cpu_affinity(bool pin_workers);
+
+        /// @brief Returns the hit, miss and eviction counters of the file cache.
+        TFTPFileCache::stats_t get_file_cache_stats() const;
+
+        /// @brief Returns the number of shards.
+        size_t get_worker_count() const;
+
+        /// @brief Serves RRQ and WRQ requests on every shard until the process ends.
+        /// @param save_directory The directory where files are served from and saved to.
+        void run(const std::string& save_directory);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Returns the CPUs in the affinity mask of the process, or the
+        ///        first hardware threads if the mask cannot be read.
+        static std::vector<unsigned> get_allowed_cpus();
+
+        /// @brief Binds a worker thread to one CPU.
+        /// @param worker The worker thread.
+        /// @param cpu Number of the CPU.
+        /// @return False if the affinity could not be set.
+        static bool pin_worker(std::thread& worker, unsigned cpu);
+
+        std::shared_ptr<TFTPFileCache> m_file_cache; ///< File cache shared by the shards.
+        std::vector<std::unique_ptr<TFTPServer>> m_servers; ///< One server per shard.
+        std::vector<std::thread> m_workers; ///< Running worker threads.
+        bool m_pin_workers; ///< Workers are pinned to a CPU each.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_SERVER_POOL_HPP
+
+/* End of File */
@@ -0,0 +1,328 @@
+///
+/// @file tftp_server_session.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPServerSession class,
+///        which runs a single RRQ or WRQ transfer on its own ephemeral socket.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_SERVER_SESSION_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_SERVER_SESSION_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <socket_macros.hpp>
+#include <tftp.hpp>
+#include <tftp_checksum.hpp>
+#include <tftp_co_session.hpp>
+#include <tftp_mapped_file.hpp>
+#include <tftp_netascii.hpp>
+#include <tftp_packet.hpp>
+#include "tftp_storage.hpp"
+#include "tftp_upload_file.hpp"
+#include <tftp_reactor.hpp>
+#include <tftp_retransmitter.hpp>
+#include <tftp_task.hpp>
+
+#ifdef TFTP_IO_URING
+#include <tftp_uring.hpp>
+#endif
+
+namespace YB
+{
+    /// @class TFTPServerSession
+    /// @brief One file transfer between the server and a client.
+    ///        Every session owns an ephemeral UDP socket, which is its transfer
+    ///        identifier (TID) as described in RFC 1350, together with its own
+    ///        protocol state and buffers. The transfer runs as a coroutine
+    ///        over a TFTPCoSession, resumed by the reactor of the server for
+    ///        packets and deadlines, and by the server for the completions of
+    ///        io_uring file requests and background writes it waits for.
+    class TFTPServerSession
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPServerSession(TFTPServerSession &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPServerSession &operator=(TFTPServerSession &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPServerSession(const TFTPServerSession &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPServerSession &operator=(TFTPServerSession const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPServerSession. Creates the ephemeral socket.
+        /// @param local_info Address of the listening socket, the ephemeral
+        ///        socket is bound to the same IP with a system chosen port.
+        /// @param peer Address of the client which sent the request.
+        /// @param peer_size Size of the client address.
+        /// @param transfer_type Whether the client reads or writes the file.
+        /// @param file The file on the server, as the storage resolved it.
+        /// @param options Options requested by the client.
+        TFTPServerSession(const SOCKADDR_IN& local_info,
+                          const SOCKADDR_STORAGE_LH& peer,
+                          socklen_t peer_size,
+                          transfer_type_t transfer_type,
+                          TFTPStorage::resolved_file_t file,
+                          const transfer_options_t& options);
+
+        /// @brief Destructor for TFTPServerSession. Frees the coroutine and
+        ///        closes the ephemeral socket.
+        ~TFTPServerSession();
+
+        /// @brief Starts the coroutine of the transfer, which opens the file
+        ///        and sends the first packet, an OACK if the client requested
+        ///        any known option, before it waits for the client.
+        /// @param reactor The reactor resuming the session, it is handed
+        ///        back as the owner by TFTPReactor::poll().
+        /// @return True if the session is running, false if it already ended.
+        bool start(TFTPReactor& reactor);
+
+        /// @brief Returns true once the coroutine of the transfer returned.
+        bool is_done() const;
+
+#ifdef TFTP_IO_URING
+        /// @brief Moves the file I/O of the session onto an io_uring, must be
+        ///        called before start(). Datagrams then come in through
+        ///        on_datagram() instead of the reactor.
+        /// @param ring The ring of the server.
+        /// @param ring_id Id of the session in the user data of its requests.
+        void attach_ring(TFTPUring* ring, uint64_t ring_id);
+
+        /// @brief Handles a datagram delivered by a multishot receive.
+        /// @param datagram The datagram, inside a provided buffer.
+        /// @param buffer_id Id of the provided buffer.
+        /// @param buffer_claimed Set if a file write still uses the buffer,
+        ///        the write completion recycles it then.
+        /// @return True if the session is still running, false if it ended.
+        bool on_datagram(const TFTPUring::datagram_t& datagram, int buffer_id, bool& buffer_claimed);
+
+        /// @brief Handles the completion of a block read, the coroutine
+        ///        waiting for it sends the blocks.
+        /// @param result Bytes read or -errno.
+        /// @return True if the session is still running, false if it ended.
+        bool on_read_complete(int result);
+
+        /// @brief Handles the completion of a block write, a failed one
+        ///        fails the next block or the commit.
+        /// @param result Bytes written or -errno.
+        /// @return True if the session is still running, false if it ended.
+        bool on_write_complete(int result);
+
+        /// @brief Records the completion of a file request of a session which
+        ///        has already ended.
+        /// @param op URING_OP_READ or URING_OP_WRITE.
+        void release_file_io(uring_op_t op);
+
+        /// @brief Returns true while the kernel still uses the buffers of the session.
+        bool has_file_io_in_flight() const;
+
+        /// @brief Returns the id of the session in the user data of its requests.
+        uint64_t get_ring_id() const;
+#endif
+
+        /// @brief Returns the retransmission timer of a started session.
+        const TFTPRetransmitter& get_retransmitter() const;
+
+        /// @brief Sets how many timeouts in a row end the session.
+        /// @param max_retries Number of retransmissions before giving up.
+        void set_max_retries(int max_retries);
+
+        /// @brief Sets the storage backend RRQ files are read through, must be
+        ///        called before start().
+        /// @param storage Backend of the server.
+        void set_storage(TFTPStorage* storage);
+
+        /// @brief Sets the background writer WRQ blocks are staged for, must
+        ///        be called before start().
+        /// @param write_behind Background writer of the server.
+        void set_write_behind(TFTPWriteBehind* write_behind);
+
+        /// @brief Handles a finished background write or commit of the
+        ///        uploaded file, a failed write fails the next block or the commit.
+        /// @return True if the session is still running, false if it ended.
+        bool on_upload_written();
+
+        /// @brief Returns the ephemeral socket of the session.
+        SOCKET get_socket() const;
+
+        /// @brief Returns the client address of the session.
+        const SOCKADDR_STORAGE_LH& get_peer() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Runs a RRQ transfer: sends the file window by window and
+        ///        ends once the client acknowledged the last block.
+        /// @return True if the client received the whole file.
+        TFTPTask<bool> serve_rrq();
+
+        /// @brief Runs a WRQ transfer: stores the blocks of the client,
+        ///        commits the file, sends the final ACK and lingers.
+        /// @return True if the file was stored.
+        TFTPTask<bool> serve_wrq();
+
+        /// @brief Waits until every write of the uploaded file completed.
+        /// @return False if the writes took longer than the idle time.
+        TFTPTask<bool> wait_for_upload();
+
+        /// @brief Fills the send window, first with the blocks of a rewound
+        ///        window and then with new blocks read from the file.
+        /// @return True if a read on the ring fills the free window slots,
+        ///         the blocks are sent once it completed.
+        bool send_data_packets();
+
+        /// @brief Logs why a wait ended the transfer, and answers a packet of
+        ///        the wrong type with an error.
+        /// @param status Status of the wait, other than RECEIVE_STATUS_OK.
+        /// @param missing Error message for a packet of the wrong type.
+        void end_transfer(receive_status_t status, const std::string& missing);
+
+        /// @brief Sends an error packet to the client.
+        /// @param error_code One of the ERR_CODE_* values.
+        /// @param error_message Human readable error message.
+        void send_error_packet(int error_code, const std::string& error_message);
+
+        /// @brief Opens the transferred file for reading or writing.
+        /// @return False if the file could not be opened.
+        bool open_file();
+
+        /// @brief Creates the destination of a WRQ, or continues the partial
+        ///        upload a WRQ with an offset resumes.
+        /// @return False if the file could not be created or there is nothing to resume.
+        bool open_upload();
+
+        /// @brief Returns true if a WRQ announces, with tsize and mtime, the
+        ///        size and time of the file the server already holds.
+        bool is_upload_current() const;
+
+        /// @brief Reserves disk space for the size a WRQ announced with tsize.
+        /// @return False if the disk has no room for the file.
+        bool preallocate_file();
+
+        /// @brief Answers the tsize and mtime options of a RRQ with the size
+        ///        and the modification time of the file, and positions the
+        ///        reads at the byte range it asked for.
+        /// @return False if the range does not start inside the file.
+        bool select_range();
+
+        /// @brief Fills a window slot with the netascii encoding of the next
+        ///        part of the file.
+        /// @param block The window slot.
+        /// @return Number of bytes written, less than a block only at the end of the file.
+        int read_netascii_block(char* block);
+
+        /// @brief Adds the payload of a new block to the checksum of a
+        ///        transfer which negotiated it.
+        /// @param payload First payload byte.
+        /// @param payload_size Number of payload bytes.
+        void add_to_checksum(const char* payload, int payload_size);
+
+        /// @brief Compares the checksum the client reported in its final ACK
+        ///        with the one of the blocks sent and logs the outcome.
+        /// @param ack The final ACK.
+        void verify_checksum(const ack_view_t& ack);
+
+        /// @brief Appends the payload of the next block to the file.
+        /// @param payload First payload byte.
+        /// @param payload_size Number of payload bytes.
+        /// @return False if an earlier write failed.
+        bool store_block(const char* payload, int payload_size);
+
+        /// @brief Writes the tail a netascii upload held back and hands the
+        ///        staged blocks to the writer once the last block has arrived.
+        /// @return False if the file could not be written.
+        bool finish_wrq();
+
+        /// @brief Hands the uploaded file to the writer to be made durable and
+        ///        renamed into place once every write of a WRQ transfer completed.
+        /// @return False if the file could not be written.
+        bool commit_wrq();
+
+        /// @brief Closes the file once the upload is committed, the final ACK
+        ///        carries the checksum of a transfer which negotiated it.
+        /// @return False if the file could not be written.
+        bool complete_wrq();
+
+        /// @brief Returns true once no write of the uploaded file runs.
+        bool is_upload_idle();
+
+#ifdef TFTP_IO_URING
+        /// @brief Submits one vectored read which fills every free window slot.
+        void submit_block_reads();
+
+        /// @brief Sends the blocks the completed read filled the window slots with.
+        /// @return False if the file could not be read.
+        bool send_read_blocks();
+#endif
+
+        TFTPStorage* m_storage; ///< Backend of the server, nullptr to map RRQ files privately.
+        std::shared_ptr<const TFTPMappedFile> m_mapped_file; ///< Source file of a RRQ transfer, Data blocks point into it.
+        size_t m_mapped_offset; ///< Offset of the next new block in the mapped file.
+        uint64_t m_range_left; ///< Bytes of the requested range not read yet, unlimited without a range.
+        std::ifstream m_in_file; ///< Source file of a RRQ transfer which could not be mapped.
+        TFTPWriteBehind* m_write_behind; ///< Background writer of the server.
+        std::unique_ptr<TFTPUploadFile> m_upload; ///< Destination file of a WRQ transfer.
+        TFTPNetascii m_netascii; ///< Line end translation of a netascii transfer.
+        std::vector<char> m_decoded_block; ///< Payload of a netascii WRQ block in local form.
+        TFTPChecksum m_checksum; ///< CRC32C of the payload sent or received so far.
+        TFTPStorage::resolved_file_t m_file; ///< The transferred file, as the storage resolved it.
+
+        SOCKET m_session_socket; ///< Ephemeral socket of the session.
+        SOCKADDR_STORAGE_LH m_peer; ///< Client address of the session.
+        socklen_t m_peer_size; ///< Size of the client address.
+
+        std::unique_ptr<TFTPCoSession> m_session; ///< Awaitable session, once started.
+        TFTPTask<bool> m_task; ///< Coroutine of the transfer, once started.
+        transfer_options_t m_requested_options; ///< Options requested by the client.
+        int m_max_retries; ///< Retransmissions in a row before giving up.
+        transfer_type_t m_transfer_type; ///< Direction of the transfer.
+        bool m_file_exhausted; ///< The last block of the file has been read.
+
+#ifdef TFTP_IO_URING
+        TFTPUring* m_ring; ///< Ring of the server, nullptr for stream based file I/O.
+        uint64_t m_ring_id; ///< Id of the session in the user data of its requests.
+        int m_file_fd; ///< Descriptor of the transferred file on the ring.
+        uint64_t m_file_offset; ///< File offset of the next block read or written.
+        std::vector<iovec> m_read_vectors; ///< Window slots of the running read.
+        bool m_read_in_flight; ///< A block read is running.
+        int m_read_result; ///< Bytes the last block read returned, or -errno.
+        int m_writes_in_flight; ///< Block writes still running.
+        bool m_write_failed; ///< A block write failed.
+        uint64_t m_bytes_written; ///< Bytes the completed writes stored.
+        int m_receive_buffer_id; ///< Provided buffer of the datagram being handled.
+        bool m_buffer_claimed; ///< A write uses the provided buffer of the datagram.
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_SERVER_SESSION_HPP
+
+/* End of File */
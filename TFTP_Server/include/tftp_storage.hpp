@@ -0,0 +1,120 @@
+///
+/// @file tftp_storage.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPStorage interface,
+///        which the server resolves and reads requested files through.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_STORAGE_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_STORAGE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <socket_macros.hpp>
+#include <tftp_mapped_file.hpp>
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPStorage
+    /// @brief Backend the server keeps its files in. A backend turns the name
+    ///        of a request into a path and hands out read-only views of RRQ
+    ///        files; uploads are written to the resolved path by the sessions
+    ///        of backends which take them.
+    class TFTPStorage
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPStorage(TFTPStorage &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPStorage &operator=(TFTPStorage &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPStorage(const TFTPStorage &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPStorage &operator=(TFTPStorage const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief A resolved file name.
+        typedef struct resolved_file_s
+        {
+            std::string path; ///< Path the session opens.
+            uint64_t size = 0; ///< Size of an existing file in bytes, as the backend last saw it.
+            std::filesystem::file_time_type modified{}; ///< Modification time of an existing file, as the backend last saw it.
+        } resolved_file_t;
+
+        /// @brief Constructor for TFTPStorage.
+        TFTPStorage() = default;
+
+        /// @brief Destructor for TFTPStorage.
+        virtual ~TFTPStorage() = default;
+
+        /// @brief Sets the directory given to the server's run().
+        /// @param root_directory The serving directory.
+        virtual void set_root(const std::string& root_directory) = 0;
+
+        /// @brief Resolves the file name of a request.
+        /// @param file_name Name as sent by the client.
+        /// @param transfer_type Whether the file is read or written.
+        /// @param file Receives the path the session opens and what the backend knows of the file.
+        /// @return STORAGE_STATUS_FOUND if the transfer can start.
+        virtual storage_status_t resolve(const std::string& file_name, transfer_type_t transfer_type,
+                                         resolved_file_t& file) = 0;
+
+        /// @brief Returns a read-only view of a resolved RRQ file.
+        /// @param file The file returned by resolve().
+        /// @return The view, nullptr if the file has to be read through its path.
+        virtual std::shared_ptr<const TFTPMappedFile> open_read(const resolved_file_t& file) = 0;
+
+        /// @brief Returns true if resolved paths name files which can be
+        ///        opened directly, false if the backend only hands out views.
+        virtual bool has_file_paths() const;
+
+        /// @brief Returns the descriptor which becomes readable when the
+        ///        backend has to catch up with changes, INVALID_SOCKET if none.
+        virtual SOCKET get_notify_socket() const;
+
+        /// @brief Catches up with the changes the notify descriptor reported.
+        virtual void refresh();
+
+        /// @brief Removes what aborted uploads left behind longer than
+        ///        TFTP_PARTIAL_MAX_AGE_S ago, backends without uploads keep nothing.
+        virtual void expire_uploads();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        // Data
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_STORAGE_HPP
+
+/* End of File */
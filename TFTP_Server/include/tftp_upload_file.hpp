@@ -0,0 +1,185 @@
+///
+/// @file tftp_upload_file.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPUploadFile class,
+///        which stages the blocks of a WRQ transfer for the background writer.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_UPLOAD_FILE_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_UPLOAD_FILE_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "tftp_write_behind.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPUploadFile
+    /// @brief Destination file of a WRQ transfer. Blocks are copied into large
+    ///        page aligned buffers which the background writer flushes, so a
+    ///        block is acknowledged as soon as it is buffered and the disk sees
+    ///        few large writes. A block only waits for the disk when every
+    ///        buffer is still being written. The file is written under a
+    ///        temporary name and only renamed to its final path by commit(),
+    ///        so readers never see a partial upload. An aborted upload can be
+    ///        kept under the partial name of its final path, which a WRQ with
+    ///        the offset option later continues.
+    class TFTPUploadFile
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPUploadFile(TFTPUploadFile &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPUploadFile &operator=(TFTPUploadFile &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPUploadFile(const TFTPUploadFile &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPUploadFile &operator=(TFTPUploadFile const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief Constructor for TFTPUploadFile.
+        /// @param writer Background writer of the server.
+        /// @param owner Pointer the writer reports finished writes with.
+        TFTPUploadFile(TFTPWriteBehind& writer, void* owner);
+
+        /// @brief Destructor for TFTPUploadFile. Waits for the running writes,
+        ///        closes the file and removes it unless it was committed or
+        ///        is kept as a partial upload.
+        ~TFTPUploadFile();
+
+        /// @brief Creates a temporary file next to the final path.
+        /// @param file_path Final path of the file.
+        /// @return False if the file could not be created.
+        bool open(const std::string& file_path);
+
+        /// @brief Continues the partial upload an aborted transfer of the same
+        ///        path left behind, cut to the bytes the client resumes after.
+        /// @param file_path Final path of the file.
+        /// @param offset Bytes of the partial upload the client has seen acknowledged.
+        /// @return False if there is no partial upload or it is shorter than offset.
+        bool resume(const std::string& file_path, int64_t offset);
+
+        /// @brief Returns true if a name is one an unfinished upload is kept
+        ///        under, the temporary name of a running upload or the
+        ///        partial name of an aborted one. Requests never reach them.
+        /// @param file_name Requested name or path of a file.
+        static bool is_temporary_name(const std::string& file_name);
+
+        /// @brief Removes the unfinished uploads below a directory which were
+        ///        last written longer ago than the given age.
+        /// @param root_directory Directory searched with its subdirectories.
+        /// @param max_age Age after which an unfinished upload is given up.
+        static void remove_stale(const std::string& root_directory, std::chrono::seconds max_age);
+
+        /// @brief Reserves disk space for the expected size of the file.
+        /// @param fd The file.
+        /// @param size Expected size in bytes.
+        /// @return False if the disk has no room for the file.
+        static bool preallocate(int fd, int64_t size);
+
+        /// @brief Returns the descriptor of the file.
+        int get_fd() const;
+
+        /// @brief Appends bytes to the file.
+        /// @param data First byte.
+        /// @param size Number of bytes.
+        /// @return False if an earlier write failed.
+        bool append(const char* data, int size);
+
+        /// @brief Hands the partly filled buffer to the writer.
+        void flush();
+
+        /// @brief Returns the number of bytes the file holds once every
+        ///        appended byte is written.
+        uint64_t get_size() const;
+
+        /// @brief Keeps an upload which ends without a commit as the partial
+        ///        upload of its final path instead of removing it.
+        /// @param size Bytes written in order from the start of the file, 0 removes it.
+        void keep_partial(uint64_t size);
+
+        /// @brief Hands the file to the writer to be flushed and renamed to its
+        ///        final path, every write must have finished.
+        /// @param modified_time Time given to the file in nanoseconds since the epoch, 0 keeps the time of the last write.
+        void commit(int64_t modified_time);
+
+        /// @brief Returns true once the file is renamed to its final path.
+        bool is_committed() const;
+
+        /// @brief Returns false if the file was renamed but the flush of its
+        ///        directory failed, so the rename may not survive a crash.
+        bool is_durable() const;
+
+        /// @brief Returns true if no write or commit is running.
+        bool is_idle();
+
+        /// @brief Returns true if a write or the commit failed.
+        bool has_failed() const;
+
+        /// @brief Closes the file, every write must have finished.
+        /// @return False if a write or the close failed.
+        bool close();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Hands the current buffer to the writer and moves to the next one.
+        void submit_buffer();
+
+        /// @brief Returns a temporary path next to the final one which no
+        ///        other upload of this process uses.
+        /// @param file_path Final path of the file.
+        static std::string make_temp_path(const std::string& file_path);
+
+        /// @brief Records the result of a finished write.
+        /// @param job The finished write.
+        void check_job(const TFTPWriteBehind::write_job_t& job);
+
+        TFTPWriteBehind& m_writer; ///< Background writer of the server.
+        void* m_owner; ///< Pointer the writer reports finished writes with.
+        std::string m_final_path; ///< Path the file is renamed to.
+        std::string m_temp_path; ///< Path the file is written under.
+        int m_fd; ///< The file, -1 if not open.
+        char* m_buffers[TFTP_WRITE_BEHIND_BUFFERS]; ///< Staging buffers, allocated on first use.
+        TFTPWriteBehind::write_job_t m_jobs[TFTP_WRITE_BEHIND_BUFFERS]; ///< Write of every buffer.
+        TFTPWriteBehind::write_job_t m_commit_job; ///< Flush and rename of the finished file.
+        bool m_commit_submitted; ///< commit() has been called.
+        int m_current; ///< Buffer being filled.
+        size_t m_fill; ///< Bytes in the buffer being filled.
+        uint64_t m_offset; ///< File offset of the buffer being filled.
+        bool m_failed; ///< A write failed.
+        uint64_t m_partial_size; ///< Bytes kept if the upload is not committed, 0 to remove it.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_UPLOAD_FILE_HPP
+
+/* End of File */
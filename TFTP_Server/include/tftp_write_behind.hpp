@@ -0,0 +1,165 @@
+///
+/// @file tftp_write_behind.hpp
+/// @author Yasin BASAR
+/// @brief This file contains the declaration of the TFTPWriteBehind class,
+///        which writes staged WRQ blocks to disk on a background thread.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+#ifndef TFTP_SEVER_AND_CLIENT_TFTP_WRITE_BEHIND_HPP
+#define TFTP_SEVER_AND_CLIENT_TFTP_WRITE_BEHIND_HPP
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <socket_macros.hpp>
+#include <types_enums_macros.hpp>
+
+namespace YB
+{
+    /// @class TFTPWriteBehind
+    /// @brief Background writer shared by the WRQ sessions of a server. Jobs
+    ///        are written in submission order; every finished job is reported
+    ///        through take_completions(), and on Linux an eventfd becomes
+    ///        readable so the event loop wakes up for it. Commit jobs make a
+    ///        finished upload durable and rename it into place; under
+    ///        SYNC_POLICY_GROUP all commits queued together share one flush
+    ///        per file system.
+    class TFTPWriteBehind
+    {
+    public:
+    ////////////////////////////////////////////////////////////////////////////
+    // Special Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        TFTPWriteBehind(TFTPWriteBehind &&) noexcept = delete; ///< Deleted move constructor.
+        TFTPWriteBehind &operator=(TFTPWriteBehind &&) noexcept = delete; ///< Deleted move assignment operator.
+        TFTPWriteBehind(const TFTPWriteBehind &) noexcept = delete; ///< Deleted copy constructor.
+        TFTPWriteBehind &operator=(TFTPWriteBehind const &) noexcept = delete; ///< Deleted copy assignment operator.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Public Members
+    ////////////////////////////////////////////////////////////////////////////
+
+        /// @brief One positional write, or the commit of a finished file.
+        typedef struct write_job_s
+        {
+            int fd = -1; ///< File to write to or to commit.
+            const char* data = nullptr; ///< Bytes to write, must stay valid until done.
+            size_t size = 0; ///< Number of bytes to write.
+            uint64_t offset = 0; ///< File offset of the first byte.
+            const char* temp_path = nullptr; ///< Commit only, path the file was written under, nullptr for a write.
+            const char* final_path = nullptr; ///< Commit only, path the file is renamed to.
+            int64_t modified_time = 0; ///< Commit only, time given to the file in nanoseconds since the epoch, 0 keeps it.
+            void* owner = nullptr; ///< Pointer handed back by take_completions().
+            int error = 0; ///< errno of a failed write, 0 on success.
+            int directory_error = 0; ///< Commit only, errno of a failed flush of the directory after the rename, which leaves the file in place.
+            std::atomic<bool> done{true}; ///< The writer has finished with the job.
+        } write_job_t;
+
+        /// @brief Constructor for TFTPWriteBehind. Starts the writer thread.
+        /// @throw std::runtime_error if the wake up descriptor cannot be created.
+        TFTPWriteBehind();
+
+        /// @brief Destructor for TFTPWriteBehind. Writes the queued jobs and
+        ///        stops the writer thread.
+        ~TFTPWriteBehind();
+
+        /// @brief Queues a job for the writer thread.
+        /// @param job The job, must stay alive until it is done.
+        void submit(write_job_t& job);
+
+        /// @brief Blocks until a job is done.
+        /// @param job A submitted job.
+        void wait(const write_job_t& job);
+
+        /// @brief Moves the owners of the jobs finished since the last call
+        ///        into the list. An owner appears once per finished job.
+        /// @param owners Receives the owners.
+        void take_completions(std::vector<void*>& owners);
+
+        /// @brief Sets how commit jobs flush their files, SYNC_POLICY_GROUP by default.
+        /// @param sync_policy The policy.
+        void set_sync_policy(sync_policy_t sync_policy);
+
+        /// @brief Returns true while submitted jobs are not done.
+        bool has_pending() const;
+
+        /// @brief Returns the descriptor which becomes readable when a job
+        ///        finishes, INVALID_SOCKET where the platform has none.
+        SOCKET get_notify_socket() const;
+
+        /// @brief Consumes the wake up of the notify descriptor.
+        void clear_notification() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Private Members
+    ////////////////////////////////////////////////////////////////////////////
+    private:
+
+        /// @brief Body of the writer thread.
+        void run();
+
+        /// @brief Writes every byte of a job.
+        /// @param job The job.
+        /// @return 0 on success, the errno of the failure otherwise.
+        static int write_fully(const write_job_t& job);
+
+        /// @brief Flushes and renames the files of a group of commit jobs,
+        ///        storing the result of every job in its error member.
+        /// @param jobs The commit jobs.
+        /// @param sync_policy How the files are flushed.
+        static void commit_all(const std::vector<write_job_t*>& jobs, sync_policy_t sync_policy);
+
+        /// @brief Flushes the file systems the files of a group of commit jobs
+        ///        are on, once per file system, and gives a failed flush to
+        ///        the files it concerns.
+        /// @param jobs The commit jobs, failed ones are skipped.
+        static void sync_devices(const std::vector<write_job_t*>& jobs);
+
+        /// @brief Flushes the directory entries of the renamed files. A
+        ///        failure is stored in directory_error, the files are in place.
+        /// @param jobs The commit jobs, failed ones are skipped.
+        static void sync_directories(const std::vector<write_job_t*>& jobs);
+
+        mutable std::mutex m_mutex; ///< Guards the queue, the completions and the counters.
+        std::condition_variable m_work; ///< Signals new jobs and the stop request.
+        std::condition_variable m_done; ///< Signals finished jobs.
+        std::deque<write_job_t*> m_queue; ///< Jobs waiting for the writer thread.
+        std::vector<write_job_t*> m_finished; ///< Jobs handled by the current round of the writer thread.
+        std::vector<void*> m_completed; ///< Owners of the jobs finished since the last take.
+        size_t m_pending; ///< Jobs submitted and not done.
+        sync_policy_t m_sync_policy; ///< How commit jobs flush their files.
+        bool m_stopping; ///< The writer thread has to exit once the queue is empty.
+        int m_notify_fd; ///< Wake up descriptor of the event loop, -1 if none.
+        std::thread m_worker; ///< The writer thread.
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Protected Members
+    ////////////////////////////////////////////////////////////////////////////
+    protected:
+
+        // Data
+
+    };
+
+} // YB
+
+#endif //TFTP_SEVER_AND_CLIENT_TFTP_WRITE_BEHIND_HPP
+
+/* End of File */
@@ -8,18 +8,19 @@
  */
 
 #include <iostream>
-#include <tftp_server.hpp>
+#include <tftp_server_pool.hpp>
 
 int main()
 {
-    const std::unique_ptr<YB::TFTPServer> server{new YB::TFTPServer()};
+    // One shard per hardware thread, each pinned to its own CPU
+    const std::unique_ptr<YB::TFTPServerPool> server{new YB::TFTPServerPool()};
 
-    server->create_socket();
+    server->set_cpu_affinity(true);
     server->bind_socket("127.0.0.1", 1234);
 
     // Server always awake with its file transfer directory
     const std::string root_dir = R"(the\directory\for\you\to\send\the\file\or\save\the\file\)";
-    server->wait_for_a_request(root_dir);
+    server->run(root_dir);
 
     return 0;
 }
@@ -0,0 +1,120 @@
+///
+/// @file tftp_directory_storage.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPDirectoryStorage class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tftp_directory_storage.hpp"
+#include "tftp_upload_file.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPDirectoryStorage::TFTPDirectoryStorage(std::shared_ptr<TFTPFileCache> file_cache)
+        : m_file_cache{std::move(file_cache)},
+          m_root_index{},
+          m_root_directory{}
+    {
+    }
+
+    void TFTPDirectoryStorage::set_file_cache(std::shared_ptr<TFTPFileCache> file_cache)
+    {
+        this->m_file_cache = std::move(file_cache);
+    }
+
+    void TFTPDirectoryStorage::set_root(const std::string& root_directory)
+    {
+        this->m_root_index.set_root(root_directory);
+        this->m_root_directory = root_directory;
+    }
+
+    storage_status_t TFTPDirectoryStorage::resolve(const std::string& file_name, transfer_type_t transfer_type,
+                                                   resolved_file_t& file)
+    {
+        TFTPRootIndex::entry_t entry{};
+
+        if (TFTPUploadFile::is_temporary_name(file_name))
+        {
+            return STORAGE_STATUS_RESERVED;
+        }
+
+        if (!this->m_root_index.resolve(file_name, entry))
+        {
+            return STORAGE_STATUS_OUTSIDE_ROOT;
+        }
+
+        if (transfer_type == TRANSFER_TYPE_RRQ && !entry.regular)
+        {
+            return STORAGE_STATUS_NOT_FOUND;
+        }
+
+        if (transfer_type == TRANSFER_TYPE_WRQ && entry.exists && !entry.regular)
+        {
+            // The rename of the upload would fail, or replace what it names.
+            return STORAGE_STATUS_NOT_REGULAR;
+        }
+
+        // The index keeps size and time current, the cache checks its mapping against them.
+        file.path = entry.path;
+        file.size = entry.size;
+        file.modified = entry.modified;
+        return STORAGE_STATUS_FOUND;
+    }
+
+    std::shared_ptr<const TFTPMappedFile> TFTPDirectoryStorage::open_read(const resolved_file_t& file)
+    {
+        if (this->m_file_cache != nullptr)
+        {
+            return this->m_file_cache->open(file.path, file.size, file.modified);
+        }
+
+        auto mapped_file = std::make_shared<TFTPMappedFile>();
+
+        if (!mapped_file->open(file.path))
+        {
+            return nullptr;
+        }
+
+        return mapped_file;
+    }
+
+    SOCKET TFTPDirectoryStorage::get_notify_socket() const
+    {
+        return this->m_root_index.get_notify_socket();
+    }
+
+    void TFTPDirectoryStorage::refresh()
+    {
+        this->m_root_index.refresh();
+    }
+
+    void TFTPDirectoryStorage::expire_uploads()
+    {
+        TFTPUploadFile::remove_stale(this->m_root_directory, std::chrono::seconds(TFTP_PARTIAL_MAX_AGE_S));
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,127 @@
+///
+/// @file tftp_file_cache.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPFileCache class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tftp_file_cache.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPFileCache::TFTPFileCache(size_t capacity)
+        : m_entries{},
+          m_index{},
+          m_capacity{capacity},
+          m_stats{}
+    {
+    }
+
+    std::shared_ptr<const TFTPMappedFile> TFTPFileCache::open(const std::string& file_path, uintmax_t size,
+                                                              std::filesystem::file_time_type modified)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(this->m_mutex);
+            const auto found = this->m_index.find(file_path);
+
+            if (found != this->m_index.end())
+            {
+                const auto entry = found->second;
+
+                if (entry->modified == modified && entry->size == size)
+                {
+                    ++this->m_stats.hits;
+                    this->m_entries.splice(this->m_entries.begin(), this->m_entries, entry);
+                    return entry->file;
+                }
+
+                ++this->m_stats.invalidations;
+                this->erase(entry);
+            }
+
+            ++this->m_stats.misses;
+        }
+
+        // Mapped outside the lock, a slow disk does not hold up cache hits.
+        auto file = std::make_shared<TFTPMappedFile>();
+
+        if (!file->open(file_path))
+        {
+            return nullptr;
+        }
+
+        const std::lock_guard<std::mutex> lock(this->m_mutex);
+
+        if (file->get_size() > this->m_capacity || this->m_index.count(file_path) != 0)
+        {
+            // Too large to cache, or another thread cached it meanwhile.
+            return file;
+        }
+
+        this->m_entries.push_front(entry_t{file_path, modified, size, file});
+        this->m_index[file_path] = this->m_entries.begin();
+        ++this->m_stats.files;
+        this->m_stats.bytes += file->get_size();
+
+        this->evict();
+
+        return file;
+    }
+
+    void TFTPFileCache::set_capacity(size_t capacity)
+    {
+        const std::lock_guard<std::mutex> lock(this->m_mutex);
+
+        this->m_capacity = capacity;
+        this->evict();
+    }
+
+    TFTPFileCache::stats_t TFTPFileCache::get_stats() const
+    {
+        const std::lock_guard<std::mutex> lock(this->m_mutex);
+
+        return this->m_stats;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPFileCache::evict()
+    {
+        while (this->m_stats.bytes > this->m_capacity && !this->m_entries.empty())
+        {
+            ++this->m_stats.evictions;
+            this->erase(std::prev(this->m_entries.end()));
+        }
+    }
+
+    void TFTPFileCache::erase(std::list<entry_t>::iterator entry)
+    {
+        --this->m_stats.files;
+        this->m_stats.bytes -= entry->file->get_size();
+        this->m_index.erase(entry->file_path);
+        this->m_entries.erase(entry);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,309 @@
+///
+/// @file tftp_pack_storage.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPPackStorage class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "tftp_pack_storage.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPPackStorage::TFTPPackStorage()
+        : m_pack{nullptr},
+          m_entries{nullptr},
+          m_names{nullptr},
+          m_file_count{0}
+    {
+    }
+
+    bool TFTPPackStorage::open(const std::string& pack_path)
+    {
+        auto pack = std::make_shared<TFTPMappedFile>();
+
+        // Small files are fetched in any order, read ahead would be wasted.
+        if (!pack->open(pack_path, false) || pack->get_size() < sizeof(pack_header_t))
+        {
+            return false;
+        }
+
+        const uint64_t pack_size = pack->get_size();
+        pack_header_t header{};
+        memcpy(&header, pack->get_data(), sizeof(header));
+
+        if (memcmp(header.magic, TFTP_PACK_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != TFTP_PACK_VERSION ||
+            header.index_offset % alignof(pack_entry_t) != 0 ||
+            header.index_offset > pack_size ||
+            header.file_count > (pack_size - header.index_offset) / sizeof(pack_entry_t) ||
+            header.names_offset > pack_size ||
+            header.names_size > pack_size - header.names_offset)
+        {
+            return false;
+        }
+
+        const auto* entries = reinterpret_cast<const pack_entry_t*>(pack->get_data() + header.index_offset);
+        const char* names = pack->get_data() + header.names_offset;
+        std::string_view previous{};
+
+        // Every entry is checked once here, lookups trust the index afterwards.
+        for (uint32_t i = 0; i < header.file_count; ++i)
+        {
+            const pack_entry_t& entry = entries[i];
+
+            if (entry.name_offset > header.names_size ||
+                entry.name_size > header.names_size - entry.name_offset ||
+                entry.data_offset > pack_size ||
+                entry.data_size > pack_size - entry.data_offset)
+            {
+                return false;
+            }
+
+            const std::string_view name(names + entry.name_offset, entry.name_size);
+
+            if (i != 0 && !(previous < name))
+            {
+                return false;
+            }
+
+            previous = name;
+        }
+
+        this->m_pack = std::move(pack);
+        this->m_entries = entries;
+        this->m_names = names;
+        this->m_file_count = header.file_count;
+
+        return true;
+    }
+
+    size_t TFTPPackStorage::get_file_count() const
+    {
+        return this->m_file_count;
+    }
+
+    bool TFTPPackStorage::build(const std::string& directory, const std::string& pack_path)
+    {
+        std::vector<std::pair<std::string, std::filesystem::path>> files;
+        std::error_code error;
+
+        for (std::filesystem::recursive_directory_iterator it(directory, error), end;
+             !error && it != end;
+             it.increment(error))
+        {
+            // Symbolic links may lead out of the directory, they are not packed.
+            if (it->is_symlink(error) || !it->is_regular_file(error))
+            {
+                continue;
+            }
+
+            files.emplace_back(it->path().lexically_relative(directory).generic_string(), it->path());
+        }
+
+        if (error || files.size() > std::numeric_limits<uint32_t>::max())
+        {
+            return false;
+        }
+
+        std::sort(files.begin(), files.end());
+
+        pack_header_t header{};
+        memcpy(header.magic, TFTP_PACK_MAGIC, sizeof(header.magic));
+        header.version = TFTP_PACK_VERSION;
+        header.file_count = static_cast<uint32_t>(files.size());
+        header.index_offset = sizeof(pack_header_t);
+        header.names_offset = header.index_offset + files.size() * sizeof(pack_entry_t);
+
+        std::vector<pack_entry_t> entries(files.size());
+        std::string names;
+
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            entries[i].name_offset = names.size();
+            entries[i].name_size = static_cast<uint32_t>(files[i].first.size());
+            names += files[i].first;
+        }
+
+        header.names_size = names.size();
+
+        const auto align = [](uint64_t offset)
+        {
+            return (offset + TFTP_PACK_ALIGNMENT - 1) / TFTP_PACK_ALIGNMENT * TFTP_PACK_ALIGNMENT;
+        };
+
+        uint64_t data_offset = align(header.names_offset + header.names_size);
+
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            entries[i].data_offset = data_offset;
+            entries[i].data_size = std::filesystem::file_size(files[i].second, error);
+
+            if (error)
+            {
+                return false;
+            }
+
+            data_offset = align(data_offset + entries[i].data_size);
+        }
+
+        const std::string temp_path = pack_path + ".part";
+        std::ofstream pack(temp_path, std::ios::binary | std::ios::trunc);
+
+        pack.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pack.write(reinterpret_cast<const char*>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(pack_entry_t)));
+        pack.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        const char padding[TFTP_PACK_ALIGNMENT] = {};
+
+        for (size_t i = 0; i < files.size() && pack.good(); ++i)
+        {
+            const auto position = static_cast<uint64_t>(pack.tellp());
+            pack.write(padding, static_cast<std::streamsize>(entries[i].data_offset - position));
+
+            std::ifstream file(files[i].second, std::ios::binary);
+
+            if (entries[i].data_size != 0)
+            {
+                pack << file.rdbuf();
+            }
+
+            // A file which changed size while packing would break the index.
+            if (!file.is_open() ||
+                static_cast<uint64_t>(pack.tellp()) != entries[i].data_offset + entries[i].data_size)
+            {
+                pack.setstate(std::ios::failbit);
+            }
+        }
+
+        pack.close();
+
+        if (!pack.good())
+        {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        std::filesystem::rename(temp_path, pack_path, error);
+        return !error;
+    }
+
+    void TFTPPackStorage::set_root(const std::string& root_directory)
+    {
+        (void)root_directory;
+    }
+
+    storage_status_t TFTPPackStorage::resolve(const std::string& file_name, transfer_type_t transfer_type,
+                                              resolved_file_t& file)
+    {
+        if (transfer_type == TRANSFER_TYPE_WRQ)
+        {
+            return STORAGE_STATUS_READ_ONLY;
+        }
+
+        std::string name;
+
+        if (!normalize(file_name, name))
+        {
+            return STORAGE_STATUS_OUTSIDE_ROOT;
+        }
+
+        const pack_entry_t* entry = this->find(name);
+
+        if (entry == nullptr)
+        {
+            return STORAGE_STATUS_NOT_FOUND;
+        }
+
+        file.size = entry->data_size;
+        file.path = std::move(name);
+        return STORAGE_STATUS_FOUND;
+    }
+
+    std::shared_ptr<const TFTPMappedFile> TFTPPackStorage::open_read(const resolved_file_t& file)
+    {
+        const pack_entry_t* entry = this->find(file.path);
+        auto slice = std::make_shared<TFTPMappedFile>();
+
+        if (entry == nullptr ||
+            !slice->open_slice(this->m_pack, static_cast<size_t>(entry->data_offset),
+                               static_cast<size_t>(entry->data_size)))
+        {
+            return nullptr;
+        }
+
+        return slice;
+    }
+
+    bool TFTPPackStorage::has_file_paths() const
+    {
+        return false;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPPackStorage::normalize(const std::string& file_name, std::string& name)
+    {
+        std::string generic_name = file_name;
+        std::replace(generic_name.begin(), generic_name.end(), '\\', '/');
+
+        // Names are relative to the packed directory, a leading slash is dropped.
+        const size_t first = generic_name.find_first_not_of('/');
+        generic_name.erase(0, std::min(first, generic_name.size()));
+
+        name = std::filesystem::path(generic_name).lexically_normal().generic_string();
+
+        return !name.empty() && name != "." && name != ".." && name.compare(0, 3, "../") != 0;
+    }
+
+    const TFTPPackStorage::pack_entry_t* TFTPPackStorage::find(const std::string& name) const
+    {
+        const pack_entry_t* end = this->m_entries + this->m_file_count;
+        const char* names = this->m_names;
+
+        const pack_entry_t* entry = std::lower_bound(
+            this->m_entries, end, std::string_view(name),
+            [names](const pack_entry_t& candidate, std::string_view key)
+            {
+                return std::string_view(names + candidate.name_offset, candidate.name_size) < key;
+            });
+
+        if (entry == end || std::string_view(this->m_names + entry->name_offset, entry->name_size) != name)
+        {
+            return nullptr;
+        }
+
+        return entry;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,294 @@
+///
+/// @file tftp_root_index.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPRootIndex class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <stdexcept>
+#include "tftp_root_index.hpp"
+#include "tftp_upload_file.hpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPRootIndex::TFTPRootIndex()
+        : m_root{},
+          m_entries{},
+          m_names_by_path{},
+          m_watches{},
+          m_watched_directories{},
+          m_notify_fd{-1}
+    {
+#ifdef __linux__
+        this->m_notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (this->m_notify_fd < 0)
+        {
+            throw std::runtime_error("Error at root index inotify creation. Error code: " +
+                                     GET_LAST_ERROR());
+        }
+#endif
+    }
+
+    TFTPRootIndex::~TFTPRootIndex()
+    {
+#ifdef __linux__
+        close(this->m_notify_fd);
+#endif
+    }
+
+    void TFTPRootIndex::set_root(const std::string& root_directory)
+    {
+        std::string root = root_directory;
+        std::replace(root.begin(), root.end(), '\\', '/');
+
+        std::error_code error;
+        std::filesystem::path root_path = std::filesystem::weakly_canonical(root, error);
+
+        if (error)
+        {
+            root_path = std::filesystem::path(root).lexically_normal();
+        }
+
+        if (!root_path.has_filename() && root_path.has_relative_path())
+        {
+            // A trailing separator leaves an empty last element.
+            root_path = root_path.parent_path();
+        }
+
+        if (root_path != this->m_root)
+        {
+            this->clear();
+            this->m_root = std::move(root_path);
+        }
+    }
+
+    bool TFTPRootIndex::resolve(const std::string& file_name, entry_t& entry)
+    {
+        const auto found = this->m_entries.find(file_name);
+
+        if (found != this->m_entries.end())
+        {
+            entry = found->second;
+            return true;
+        }
+
+        if (!this->resolve_uncached(file_name, entry))
+        {
+            return false;
+        }
+
+        this->insert(file_name, entry);
+        return true;
+    }
+
+    void TFTPRootIndex::refresh()
+    {
+#ifdef __linux__
+        alignas(inotify_event) char buffer[4096];
+
+        while (true)
+        {
+            const ssize_t bytes = read(this->m_notify_fd, buffer, sizeof(buffer));
+
+            if (bytes <= 0)
+            {
+                return;
+            }
+
+            for (ssize_t offset = 0; offset < bytes;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(&buffer[offset]);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                const auto directory = this->m_watched_directories.find(event->wd);
+
+                if ((event->mask & IN_Q_OVERFLOW) != 0)
+                {
+                    this->clear();
+                    continue;
+                }
+
+                if (directory == this->m_watched_directories.end())
+                {
+                    // Left over from a watch removed by clear().
+                    continue;
+                }
+
+                if ((event->mask & (IN_ISDIR | IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0)
+                {
+                    // A directory changed, names below it may resolve elsewhere now.
+                    this->clear();
+                    continue;
+                }
+
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                const std::string path = (std::filesystem::path(directory->second) / event->name).string();
+                const auto names = this->m_names_by_path.find(path);
+
+                if (names == this->m_names_by_path.end())
+                {
+                    continue;
+                }
+
+                for (const std::string& name : names->second)
+                {
+                    this->m_entries.erase(name);
+                }
+
+                this->m_names_by_path.erase(names);
+            }
+        }
+#endif
+    }
+
+    SOCKET TFTPRootIndex::get_notify_socket() const
+    {
+#ifdef __linux__
+        return this->m_notify_fd;
+#else
+        return INVALID_SOCKET;
+#endif
+    }
+
+    size_t TFTPRootIndex::get_size() const
+    {
+        return this->m_entries.size();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPRootIndex::resolve_uncached(const std::string& file_name, entry_t& entry) const
+    {
+        std::string file_path = this->m_root.generic_string() + '/' + file_name;
+        std::replace(file_path.begin(), file_path.end(), '\\', '/');
+
+        std::error_code error;
+        std::filesystem::path canonical_path = std::filesystem::weakly_canonical(file_path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        // Symbolic links and ".." are resolved, so every element of the root
+        // has to lead the path.
+        const auto mismatch = std::mismatch(this->m_root.begin(), this->m_root.end(),
+                                            canonical_path.begin(), canonical_path.end());
+
+        if (mismatch.first != this->m_root.end())
+        {
+            return false;
+        }
+
+        // The root itself, or a name ending in a separator, names no file
+        // and would put the temporary file of an upload next to it.
+        if (mismatch.second == canonical_path.end() || !canonical_path.has_filename())
+        {
+            return false;
+        }
+
+        // A link may still lead to an unfinished upload.
+        if (TFTPUploadFile::is_temporary_name(canonical_path.filename().string()))
+        {
+            return false;
+        }
+
+        const std::filesystem::file_status status = std::filesystem::status(canonical_path, error);
+
+        entry.path = canonical_path.make_preferred().string();
+        entry.exists = !error && std::filesystem::exists(status);
+        entry.regular = entry.exists && std::filesystem::is_regular_file(status);
+        entry.size = entry.regular ? std::filesystem::file_size(canonical_path, error) : 0;
+        entry.modified = entry.exists ? std::filesystem::last_write_time(canonical_path, error)
+                                      : std::filesystem::file_time_type{};
+
+        return true;
+    }
+
+    void TFTPRootIndex::insert(const std::string& file_name, const entry_t& entry)
+    {
+#ifdef __linux__
+        if (this->m_entries.size() >= TFTP_ROOT_INDEX_ENTRIES)
+        {
+            this->clear();
+        }
+
+        const std::string directory = std::filesystem::path(entry.path).parent_path().string();
+
+        if (this->m_watches.count(directory) == 0)
+        {
+            // Plain writes are not watched, finished files are closed or
+            // renamed into place, and a flood of IN_MODIFY would overflow
+            // the queue during uploads.
+            const int watch = inotify_add_watch(this->m_notify_fd, directory.c_str(),
+                                                IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB |
+                                                IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                                IN_MOVE_SELF | IN_ONLYDIR);
+
+            if (watch < 0)
+            {
+                // Entries nobody watches would go stale.
+                return;
+            }
+
+            this->m_watches[directory] = watch;
+            this->m_watched_directories[watch] = directory;
+        }
+
+        this->m_entries[file_name] = entry;
+        this->m_names_by_path[entry.path].push_back(file_name);
+#else
+        (void)file_name;
+        (void)entry;
+#endif
+    }
+
+    void TFTPRootIndex::clear()
+    {
+#ifdef __linux__
+        for (const auto& watch : this->m_watches)
+        {
+            (void)inotify_rm_watch(this->m_notify_fd, watch.second);
+        }
+#endif
+
+        this->m_entries.clear();
+        this->m_names_by_path.clear();
+        this->m_watches.clear();
+        this->m_watched_directories.clear();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -11,9 +11,9 @@
 // Project Includes
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
+#include <algorithm>
 #include <iostream>
-#include <filesystem>
+#include <stdexcept>
 #include "tftp_server.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -27,8 +27,22 @@ namespace YB
 ////////////////////////////////////////////////////////////////////////////////
 
     TFTPServer::TFTPServer()
-        : m_incoming_buffer(new char[TFTP_INCOMING_DATA_BUFFER_LEN]),
-          m_outgoing_buffer(new char[TFTP_OUTGOING_DATA_BUFFER_LEN]),
+        : m_request_batch(TFTP_REQUEST_BUFFER_LEN, TFTP_BATCH_SIZE),
+          m_reactor{nullptr},
+          m_write_behind(new TFTPWriteBehind()),
+          m_max_retries{TFTP_DEFAULT_MAX_RETRIES},
+          m_rollover{ROLLOVER_POLICY_ZERO},
+          m_file_cache{std::make_shared<TFTPFileCache>()},
+          m_storage{std::make_shared<TFTPDirectoryStorage>(this->m_file_cache)},
+          m_next_upload_sweep{},
+#ifdef TFTP_IO_URING
+          m_ring{nullptr},
+          m_completions{},
+          m_sessions_by_ring_id{},
+          m_draining_sessions{},
+          m_next_ring_id{0},
+          m_request_receive_armed{false},
+#endif
           m_server_socket{INVALID_SOCKET},
           m_server_info{},
           m_server_storage{},
@@ -50,14 +64,44 @@ namespace YB
         }
 #endif
         std::cout << "Socket Architecture initialized.\n";
+
+#ifdef TFTP_IO_URING
+        // Buffers hold the receive header, the sender address and a datagram.
+        const int buffer_len = static_cast<int>(sizeof(io_uring_recvmsg_out) + sizeof(SOCKADDR_STORAGE_LH)) +
+                               data_begin + TFTP_URING_MAX_BLOCK_SIZE;
+
+        try
+        {
+            this->m_ring = std::make_unique<TFTPUring>(TFTP_URING_ENTRIES, buffer_len, TFTP_URING_BUFFER_COUNT);
+            std::cout << "io_uring transport initialized.\n";
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << e.what() << ". Falling back to epoll.\n";
+        }
+
+        // The ring receives the datagrams of the sessions, the reactor only
+        // keeps their deadlines then.
+        this->m_reactor = std::make_unique<TFTPReactor>(this->m_ring == nullptr);
+#else
+        this->m_reactor = std::make_unique<TFTPReactor>();
+#endif
     }
 
     TFTPServer::~TFTPServer()
     {
+#ifdef TFTP_IO_URING
+        // The kernel lets go of the session buffers before they are freed.
+        this->m_ring.reset();
+        this->m_sessions_by_ring_id.clear();
+        this->m_draining_sessions.clear();
+#endif
+        this->m_sessions_by_peer.clear();
+        this->m_sessions.clear();
         this->close_socket_architecture();
     }
 
-    void TFTPServer::create_socket()
+    void TFTPServer::create_socket(bool reuse_port)
     {
         this->m_server_socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_IP);
 
@@ -69,6 +113,24 @@ namespace YB
 
             throw std::runtime_error(error_str);
         }
+
+#ifdef __linux__
+        constexpr int enable = 1;
+
+        if (reuse_port &&
+            setsockopt(this->m_server_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == SOCKET_ERROR)
+        {
+            const std::string error_str = "Error at enabling port reuse. Error code: " +
+                                          GET_LAST_ERROR();
+            this->close_socket_architecture();
+
+            throw std::runtime_error(error_str);
+        }
+#endif
+#ifdef _WIN32
+        // Windows does not balance datagrams between sockets sharing a port.
+        (void)reuse_port;
+#endif
     }
 
     void TFTPServer::bind_socket(const char* server_ip, int port)
@@ -100,135 +162,585 @@ namespace YB
 
     void TFTPServer::wait_for_a_request(const std::string& save_directory)
     {
-        //Wait for Request//
-        int bytes = this->receive_data_from_client();
+        this->serve(save_directory, true);
+    }
 
-        if (this->m_incoming_buffer[1] == OP_CODE_WRQ)
+    void TFTPServer::set_max_retries(int max_retries)
+    {
+        if (max_retries < 0 || max_retries > TFTP_MAX_RETRIES)
         {
-            TFTP::reset_ack_data_block_num();
-            TFTP::reset_data_block_num();
+            throw std::runtime_error("Retries must be between 0 and " +
+                                     std::to_string(TFTP_MAX_RETRIES));
+        }
+
+        this->m_max_retries = max_retries;
+    }
 
+    void TFTPServer::set_file_cache_capacity(size_t capacity)
+    {
+        this->m_file_cache->set_capacity(capacity);
+    }
 
-            const std::string file_name(&this->m_incoming_buffer[2]);
-            const std::string file_path = this->preferred_file_path(save_directory, file_name);
+    void TFTPServer::set_file_cache(std::shared_ptr<TFTPFileCache> file_cache)
+    {
+        this->m_file_cache = std::move(file_cache);
 
-            std::ofstream out_file(file_path, std::ios::binary);
+        auto* directory_storage = dynamic_cast<TFTPDirectoryStorage*>(this->m_storage.get());
 
-            if (!out_file.is_open())
+        if (directory_storage != nullptr)
+        {
+            directory_storage->set_file_cache(this->m_file_cache);
+        }
+    }
+
+    TFTPFileCache::stats_t TFTPServer::get_file_cache_stats() const
+    {
+        return this->m_file_cache->get_stats();
+    }
+
+    void TFTPServer::set_storage(std::shared_ptr<TFTPStorage> storage)
+    {
+        this->m_storage = std::move(storage);
+    }
+
+    void TFTPServer::set_sync_policy(sync_policy_t sync_policy)
+    {
+        this->m_write_behind->set_sync_policy(sync_policy);
+    }
+
+    void TFTPServer::set_rollover_policy(rollover_policy_t rollover)
+    {
+        this->m_rollover = rollover;
+    }
+
+    void TFTPServer::run(const std::string& save_directory)
+    {
+        this->serve(save_directory, false);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPServer::serve(const std::string& save_directory, bool single_transfer)
+    {
+        this->m_storage->set_root(save_directory);
+
+        // Uploads aborted before a restart are given up like any other.
+        this->m_next_upload_sweep = TFTPTimingWheel::steady_clock_t::time_point{};
+        this->expire_uploads();
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            this->serve_ring(single_transfer);
+            return;
+        }
+#endif
+
+        TFTPPoller::set_non_blocking(this->m_server_socket);
+        this->m_reactor->watch_socket(this->m_server_socket, nullptr);
+
+        const SOCKET notify_socket = this->m_write_behind->get_notify_socket();
+        const SOCKET storage_socket = this->m_storage->get_notify_socket();
+
+        if (notify_socket != INVALID_SOCKET)
+        {
+            this->m_reactor->watch_socket(notify_socket, this->m_write_behind.get());
+        }
+
+        if (storage_socket != INVALID_SOCKET)
+        {
+            this->m_reactor->watch_socket(storage_socket, this->m_storage.get());
+        }
+
+        bool accepting = true;
+
+        while (accepting || !this->m_sessions.empty())
+        {
+            int timeout_ms = this->next_timeout_ms();
+
+            if (notify_socket == INVALID_SOCKET && this->m_write_behind->has_pending())
+            {
+                // Nothing wakes the loop for finished writes, look again soon.
+                timeout_ms = timeout_ms < 0 ? 1 : std::min(timeout_ms, 1);
+            }
+
+            // Sessions are resumed inside, the ones whose transfer ended are
+            // released before new requests can reuse their client address.
+            (void)this->m_reactor->poll(timeout_ms, this->m_resumed, this->m_ready_contexts);
+            this->close_ended_sessions();
+
+            for (void* context : this->m_ready_contexts)
             {
-                this->close_socket_architecture();
-                out_file.close();
+                if (context == nullptr)
+                {
+                    if (accepting && this->accept_requests(single_transfer))
+                    {
+                        accepting = false;
+                    }
+
+                    continue;
+                }
+
+                if (context == this->m_write_behind.get())
+                {
+                    this->m_write_behind->clear_notification();
+                    continue;
+                }
 
-                throw std::runtime_error("File could not be created for WRQ");
+                if (context == this->m_storage.get())
+                {
+                    this->m_storage->refresh();
+                }
             }
 
-            this->send_ack_packet();
+            this->complete_uploads();
+            this->expire_uploads();
+        }
+
+        if (notify_socket != INVALID_SOCKET)
+        {
+            this->m_reactor->unwatch_socket(notify_socket);
+        }
+
+        if (storage_socket != INVALID_SOCKET)
+        {
+            this->m_reactor->unwatch_socket(storage_socket);
+        }
+
+        this->m_reactor->unwatch_socket(this->m_server_socket);
+    }
+
+    bool TFTPServer::accept_requests(bool single_transfer)
+    {
+        const int count = this->m_request_batch.receive(this->m_server_socket);
+
+        for (int i = 0; i < count; ++i)
+        {
+            this->m_server_storage = this->m_request_batch.get_address(i);
+            this->m_addr_storage_size = this->m_request_batch.get_address_size(i);
+
+            if (this->accept_request(this->m_request_batch.get_data(i),
+                                     this->m_request_batch.get_size(i)) &&
+                single_transfer)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool TFTPServer::accept_request(const char* packet, int bytes)
+    {
+        if (bytes < data_begin)
+        {
+            return false;
+        }
+
+        const op_code code = TFTPPacket::get_op_code(packet, bytes);
+
+        if (code != op_code::WRQ &&
+            code != op_code::RRQ)
+        {
+            std::cout << "There is no RRQ or WRQ accepted. Ignoring the packet.\n";
+            this->send_error_packet(ERR_CODE_ILLEGAL_OPERATION, "Illegal TFTP operation");
+            return false;
+        }
+
+        const uint64_t key = peer_key(this->m_server_storage);
+
+        if (this->m_sessions_by_peer.count(key) != 0)
+        {
+            // Retransmitted request of a client whose session is already running.
+            return false;
+        }
+
+        // Fields without their NUL inside the datagram make the request malformed.
+        request_view_t request{};
+        transfer_options_t options{};
+
+        if (!TFTPPacket::parse_request(packet, bytes, request) ||
+            !TFTP::parse_request_options(request, options))
+        {
+            this->send_error_packet(ERR_CODE_ILLEGAL_OPERATION, "Malformed request or unknown mode");
+            return false;
+        }
+
+        if ((options.negotiated & OPTION_ROLLOVER) == 0)
+        {
+            options.rollover = this->m_rollover;
+        }
+
+        if (request.transfer_type == TRANSFER_TYPE_WRQ)
+        {
+            // An upload runs to the end of the file, an offset resumes a
+            // partial one and an mtime is given to the stored file.
+            options.negotiated &= ~OPTION_LENGTH;
+            options.length = 0;
+        }
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            // Incoming Data blocks have to fit into one provided buffer.
+            options.block_size = std::min(options.block_size, TFTP_URING_MAX_BLOCK_SIZE);
+        }
+#endif
+
+        const transfer_type_t transfer_type = request.transfer_type;
+        const std::string file_name(request.file_name);
+        TFTPStorage::resolved_file_t file{};
+
+        // Refused requests are answered here, no session socket is needed.
+        switch (this->m_storage->resolve(file_name, transfer_type, file))
+        {
+        case STORAGE_STATUS_OUTSIDE_ROOT:
+            this->send_error_packet(ERR_CODE_ACCESS_VIOLATION, "File is outside the served directory");
+            return true;
+
+        case STORAGE_STATUS_NOT_FOUND:
+            this->send_error_packet(ERR_CODE_FILE_NOT_FOUND, "File could not be found for RRQ");
+            return true;
+
+        case STORAGE_STATUS_READ_ONLY:
+            this->send_error_packet(ERR_CODE_ACCESS_VIOLATION, "Storage does not accept uploads");
+            return true;
+
+        case STORAGE_STATUS_RESERVED:
+            this->send_error_packet(ERR_CODE_ACCESS_VIOLATION, "File name is reserved for unfinished uploads");
+            return true;
+
+        case STORAGE_STATUS_NOT_REGULAR:
+            this->send_error_packet(ERR_CODE_ACCESS_VIOLATION, "File name does not name a regular file");
+            return true;
+
+        default:
+            break;
+        }
+
+        std::unique_ptr<TFTPServerSession> session;
+
+        try
+        {
+            session = std::make_unique<TFTPServerSession>(this->m_server_info,
+                                                          this->m_server_storage,
+                                                          this->m_addr_storage_size,
+                                                          transfer_type,
+                                                          std::move(file),
+                                                          options);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << e.what() << "\n";
+            this->send_error_packet(ERR_CODE_NOT_DEFINED, "Server could not start the transfer");
+            return false;
+        }
+
+        session->set_max_retries(this->m_max_retries);
+        session->set_storage(this->m_storage.get());
+        session->set_write_behind(this->m_write_behind.get());
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            session->attach_ring(this->m_ring.get(), ++this->m_next_ring_id);
+        }
+#endif
+
+        if (!session->start(*this->m_reactor))
+        {
+            return true;
+        }
+
+        TFTPServerSession* session_ptr = session.get();
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            this->arm_receive(session_ptr->get_socket(), session_ptr->get_ring_id());
+            this->m_sessions_by_ring_id[session_ptr->get_ring_id()] = session_ptr;
+        }
+#endif
+        this->m_sessions_by_peer[key] = session_ptr;
+        this->m_sessions[session_ptr] = std::move(session);
+
+        return true;
+    }
+
+    int TFTPServer::next_timeout_ms() const
+    {
+        return this->m_reactor->next_timeout_ms();
+    }
 
-            do
+    void TFTPServer::close_ended_sessions()
+    {
+        for (void* owner : this->m_resumed)
+        {
+            // A session resumed by a packet and its deadline comes twice.
+            const auto found = this->m_sessions.find(static_cast<TFTPServerSession*>(owner));
+
+            if (found != this->m_sessions.end() && found->first->is_done())
             {
-                memset(this->m_incoming_buffer.get(), 0, TFTP_OUTGOING_DATA_BUFFER_LEN);
+                this->close_session(found->first);
+            }
+        }
+    }
 
-                bytes = this->receive_data_from_client();
+    void TFTPServer::expire_uploads()
+    {
+        const auto now = TFTPTimingWheel::steady_clock_t::now();
 
-                out_file.write(&this->m_incoming_buffer[DATA_BEGIN], bytes - DATA_BEGIN);
+        if (now < this->m_next_upload_sweep)
+        {
+            return;
+        }
 
-                this->send_ack_packet();
+        this->m_next_upload_sweep = now + std::chrono::seconds(TFTP_PARTIAL_SWEEP_INTERVAL_S);
+        this->m_storage->expire_uploads();
+    }
+
+    void TFTPServer::complete_uploads()
+    {
+        this->m_write_behind->take_completions(this->m_written_uploads);
+
+        for (void* owner : this->m_written_uploads)
+        {
+            // Sessions which ended meanwhile are gone from the table.
+            const auto found = this->m_sessions.find(static_cast<TFTPServerSession*>(owner));
+
+            if (found == this->m_sessions.end())
+            {
+                continue;
             }
-            while (bytes >= TFTP_OUTGOING_DATA_BUFFER_LEN);
 
-            out_file.close();
+            TFTPServerSession* session = found->first;
+
+            if (!session->on_upload_written())
+            {
+                this->close_session(session);
+            }
+        }
+    }
+
+    void TFTPServer::close_session(TFTPServerSession* session)
+    {
+        this->m_sessions_by_peer.erase(peer_key(session->get_peer()));
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            const uint64_t ring_id = session->get_ring_id();
+            auto found = this->m_sessions.find(session);
+
+            this->m_ring->prepare_cancel(TFTPUring::make_user_data(URING_OP_RECEIVE, 0, ring_id));
+            this->m_sessions_by_ring_id.erase(ring_id);
 
+            if (session->has_file_io_in_flight())
+            {
+                // The kernel still reads into or writes from its buffers.
+                this->m_draining_sessions[ring_id] = std::move(found->second);
+            }
+
+            this->m_sessions.erase(found);
             return;
         }
+#endif
+
+        this->m_sessions.erase(session);
+    }
 
-        if (this->m_incoming_buffer[1] == OP_CODE_RRQ)
+#ifdef TFTP_IO_URING
+
+    void TFTPServer::serve_ring(bool single_transfer)
+    {
+        if (!this->m_request_receive_armed)
         {
-            //Get RRQ//
-            TFTP::reset_ack_data_block_num();
-            TFTP::reset_data_block_num();
+            this->arm_receive(this->m_server_socket, 0);
+        }
 
-            const std::string file_name(&this->m_incoming_buffer[2]);
-            const std::string file_path = this->preferred_file_path(save_directory, file_name);
+        bool accepting = true;
 
-            std::ifstream in_file(file_path, std::ios::binary);
+        while (accepting || !this->m_sessions.empty() || !this->m_draining_sessions.empty())
+        {
+            int timeout_ms = this->next_timeout_ms();
 
-            if (!in_file.is_open())
+            if (this->m_write_behind->has_pending())
             {
-                this->close_socket_architecture();
-                in_file.close();
+                // Uploads being committed do not complete on the ring, look again soon.
+                timeout_ms = timeout_ms < 0 ? 1 : std::min(timeout_ms, 1);
+            }
 
-                throw std::runtime_error("File could not be found for RRQ");
+            (void)this->m_ring->submit_and_wait(this->m_completions, timeout_ms);
+
+            for (const TFTPUring::completion_t& completion : this->m_completions)
+            {
+                if (TFTPUring::get_owner_id(completion.user_data) != 0)
+                {
+                    this->on_session_completion(completion);
+                    continue;
+                }
+
+                if (this->on_request_completion(completion, accepting) && single_transfer)
+                {
+                    // Later requests stay for the next call, clients resend the dropped ones.
+                    this->m_ring->prepare_cancel(TFTPUring::make_user_data(URING_OP_RECEIVE, 0, 0));
+                    accepting = false;
+                }
             }
 
-            memset(this->m_incoming_buffer.get(), 0, TFTP_OUTGOING_DATA_BUFFER_LEN);
-            //Create the file in the directory given//
+            // Deadlines are kept by the reactor, which has no socket to wait on here.
+            (void)this->m_reactor->expire(this->m_resumed);
+            this->close_ended_sessions();
+            this->complete_uploads();
+            this->expire_uploads();
+        }
+    }
+
+    bool TFTPServer::on_request_completion(const TFTPUring::completion_t& completion, bool accepting)
+    {
+        if ((completion.flags & IORING_CQE_F_MORE) == 0)
+        {
+            // Cancelled, or the kernel ran out of provided buffers.
+            this->m_request_receive_armed = false;
 
-            while (!in_file.eof())
+            if (accepting)
             {
-                memset(this->m_outgoing_buffer.get(), 0, TFTP_OUTGOING_DATA_BUFFER_LEN);
-                in_file.read(this->m_outgoing_buffer.get(), TFTP_OUTGOING_DATA_BUFFER_LEN);
+                this->arm_receive(this->m_server_socket, 0);
+            }
+        }
+
+        const int buffer_id = TFTPUring::get_buffer_id(completion);
+
+        if (buffer_id < 0)
+        {
+            return false;
+        }
+
+        TFTPUring::datagram_t datagram{};
+        bool started = false;
+
+        if (accepting && this->m_ring->get_datagram(completion, datagram))
+        {
+            this->m_server_storage = *datagram.sender;
+            this->m_addr_storage_size = datagram.sender_size;
 
-                int number_of_bytes_from_last_read = static_cast<int>(in_file.gcount());
+            // Without a poller the storage catches up with its changes per request.
+            this->m_storage->refresh();
+            started = this->accept_request(datagram.data, datagram.size);
+        }
 
-                this->send_data_packet(number_of_bytes_from_last_read);
+        this->m_ring->recycle_buffer(buffer_id);
 
-                memset(this->m_outgoing_buffer.get(), 0, TFTP_OUTGOING_DATA_BUFFER_LEN);
+        return started;
+    }
 
-                (void)this->receive_data_from_client();
+    void TFTPServer::on_session_completion(const TFTPUring::completion_t& completion)
+    {
+        const uring_op_t op = TFTPUring::get_op(completion.user_data);
+        const uint64_t ring_id = TFTPUring::get_owner_id(completion.user_data);
+        const auto found = this->m_sessions_by_ring_id.find(ring_id);
+        TFTPServerSession* session = found != this->m_sessions_by_ring_id.end() ? found->second : nullptr;
 
-                if (this->m_incoming_buffer[1] != OP_CODE_ACK)
+        if (op == URING_OP_WRITE)
+        {
+            // The written block came straight from a provided buffer.
+            this->m_ring->recycle_buffer(TFTPUring::get_request_buffer_id(completion.user_data));
+        }
+
+        if (session == nullptr)
+        {
+            const int buffer_id = TFTPUring::get_buffer_id(completion);
+
+            if (op == URING_OP_RECEIVE && buffer_id >= 0)
+            {
+                this->m_ring->recycle_buffer(buffer_id);
+            }
+
+            const auto draining = this->m_draining_sessions.find(ring_id);
+
+            if (op != URING_OP_RECEIVE && draining != this->m_draining_sessions.end())
+            {
+                draining->second->release_file_io(op);
+
+                if (!draining->second->has_file_io_in_flight())
                 {
-                    this->close_socket_architecture();
-                    throw std::runtime_error("ACK Packet of data is missing");
+                    this->m_draining_sessions.erase(draining);
                 }
             }
 
-            in_file.close();
-
             return;
         }
 
-        std::cout << "There is no RRQ or WRQ accepted. Quitting.\n";
-        this->close_socket_architecture();
-    }
+        bool running = true;
 
-////////////////////////////////////////////////////////////////////////////////
-// Private Functions
-////////////////////////////////////////////////////////////////////////////////
+        if (op == URING_OP_READ)
+        {
+            running = session->on_read_complete(completion.result);
+        }
+        else if (op == URING_OP_WRITE)
+        {
+            running = session->on_write_complete(completion.result);
+        }
+        else
+        {
+            const int buffer_id = TFTPUring::get_buffer_id(completion);
+            TFTPUring::datagram_t datagram{};
+            bool buffer_claimed = false;
 
-    void TFTPServer::send_ack_packet()
+            if (this->m_ring->get_datagram(completion, datagram))
+            {
+                running = session->on_datagram(datagram, buffer_id, buffer_claimed);
+            }
+
+            if (buffer_id >= 0 && !buffer_claimed)
+            {
+                this->m_ring->recycle_buffer(buffer_id);
+            }
+
+            if (running && (completion.flags & IORING_CQE_F_MORE) == 0)
+            {
+                this->arm_receive(session->get_socket(), ring_id);
+            }
+        }
+
+        if (!running)
+        {
+            this->close_session(session);
+        }
+    }
+
+    void TFTPServer::arm_receive(SOCKET socket, uint64_t ring_id)
     {
-        packet_t ack_packet = TFTP::make_ack_packet();
+        this->m_ring->prepare_receive(socket, TFTPUring::make_user_data(URING_OP_RECEIVE, 0, ring_id));
 
-        (void)sendto(this->m_server_socket,
-                     ack_packet.data_ptr.get(),
-                     ack_packet.size,
-                     0,
-                     reinterpret_cast<SOCKADDR*>(&this->m_server_storage),
-                     this->m_addr_storage_size);
+        if (ring_id == 0)
+        {
+            this->m_request_receive_armed = true;
+        }
     }
 
-    void TFTPServer::send_data_packet(int number_of_bytes_from_last_read)
+#endif
+
+    void TFTPServer::send_error_packet(int error_code, const std::string& error_message)
     {
-        packet_t data_packet
-            = TFTP::make_data_packet(this->m_outgoing_buffer.get());
+        packet_t error_packet = TFTP::make_error_packet(error_code, error_message);
 
         (void)sendto(this->m_server_socket,
-                     data_packet.data_ptr.get(),
-                     number_of_bytes_from_last_read + DATA_BEGIN,
+                     error_packet.data_ptr.get(),
+                     error_packet.size,
                      0,
                      reinterpret_cast<SOCKADDR*>(&this->m_server_storage),
                      this->m_addr_storage_size);
     }
 
-    int TFTPServer::receive_data_from_client()
+    uint64_t TFTPServer::peer_key(const SOCKADDR_STORAGE_LH& peer)
     {
-        return recvfrom(this->m_server_socket,
-                        this->m_incoming_buffer.get(),
-                        TFTP_INCOMING_DATA_BUFFER_LEN,
-                        0,
-                        reinterpret_cast<SOCKADDR*>(&this->m_server_storage),
-                        &this->m_addr_storage_size);
+        const auto* peer_in = reinterpret_cast<const SOCKADDR_IN*>(&peer);
+
+        return (static_cast<uint64_t>(ntohl(peer_in->sin_addr.s_addr)) << 16) |
+               ntohs(peer_in->sin_port);
     }
 
     void TFTPServer::close_socket_architecture() const
@@ -243,29 +755,6 @@ namespace YB
         std::cout << "Socket Architecture is closed." << std::endl;
     }
 
-    std::string TFTPServer::preferred_file_path(const std::string& save_directory,
-                                                const std::string& file_name) const
-    {
-        std::string file_path{};
-
-        if (save_directory[save_directory.length() - 1] == '/' ||
-            save_directory[save_directory.length() - 1] == '\\')
-        {
-            file_path = save_directory + file_name;
-        }
-        else
-        {
-            file_path = save_directory + '/' + file_name;
-        }
-
-        std::replace(file_path.begin(), file_path.end(), '\\', '/');
-
-        const std::filesystem::path path(file_path);
-        std::filesystem::path canonical_path = std::filesystem::weakly_canonical(path);
-
-        return canonical_path.make_preferred().string();
-    }
-
 ////////////////////////////////////////////////////////////////////////////////
 // Protected Functions
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,233 @@
+///
+/// @file tftp_server_pool.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPServerPool class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include "tftp_server_pool.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPServerPool::TFTPServerPool(unsigned worker_count)
+        : m_file_cache{std::make_shared<TFTPFileCache>()},
+          m_servers{},
+          m_workers{},
+          m_pin_workers{false}
+    {
+#ifdef _WIN32
+        worker_count = 1;
+#endif
+        if (worker_count == 0)
+        {
+            worker_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (unsigned i = 0; i < worker_count; ++i)
+        {
+            this->m_servers.push_back(std::make_unique<TFTPServer>());
+            this->m_servers.back()->set_file_cache(this->m_file_cache);
+        }
+    }
+
+    TFTPServerPool::~TFTPServerPool()
+    {
+        for (std::thread& worker : this->m_workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    void TFTPServerPool::bind_socket(const char* server_ip, int port)
+    {
+        for (const auto& server : this->m_servers)
+        {
+            server->create_socket(this->m_servers.size() > 1);
+            server->bind_socket(server_ip, port);
+        }
+    }
+
+    void TFTPServerPool::set_max_retries(int max_retries)
+    {
+        for (const auto& server : this->m_servers)
+        {
+            server->set_max_retries(max_retries);
+        }
+    }
+
+    void TFTPServerPool::set_storage(const std::shared_ptr<TFTPStorage>& storage)
+    {
+        for (const auto& server : this->m_servers)
+        {
+            server->set_storage(storage);
+        }
+    }
+
+    void TFTPServerPool::set_sync_policy(sync_policy_t sync_policy)
+    {
+        for (const auto& server : this->m_servers)
+        {
+            server->set_sync_policy(sync_policy);
+        }
+    }
+
+    void TFTPServerPool::set_rollover_policy(rollover_policy_t rollover)
+    {
+        for (const auto& server : this->m_servers)
+        {
+            server->set_rollover_policy(rollover);
+        }
+    }
+
+    void TFTPServerPool::set_file_cache_capacity(size_t capacity)
+    {
+        this->m_file_cache->set_capacity(capacity);
+    }
+
+    void TFTPServerPool::set_cpu_affinity(bool pin_workers)
+    {
+        this->m_pin_workers = pin_workers;
+    }
+
+    TFTPFileCache::stats_t TFTPServerPool::get_file_cache_stats() const
+    {
+        return this->m_file_cache->get_stats();
+    }
+
+    size_t TFTPServerPool::get_worker_count() const
+    {
+        return this->m_servers.size();
+    }
+
+    void TFTPServerPool::run(const std::string& save_directory)
+    {
+        const std::vector<unsigned> cpus = this->m_pin_workers ? get_allowed_cpus() : std::vector<unsigned>{};
+
+        for (size_t i = 0; i < this->m_servers.size(); ++i)
+        {
+            TFTPServer* server = this->m_servers[i].get();
+
+            this->m_workers.emplace_back([server, save_directory, i]()
+            {
+                try
+                {
+                    server->run(save_directory);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cout << "Shard " << i << " stopped: " << e.what() << "\n";
+                }
+            });
+
+            if (this->m_pin_workers && !pin_worker(this->m_workers.back(), cpus[i % cpus.size()]))
+            {
+                std::cout << "Shard " << i << " could not be pinned to a CPU.\n";
+            }
+        }
+
+        for (std::thread& worker : this->m_workers)
+        {
+            worker.join();
+        }
+
+        this->m_workers.clear();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    std::vector<unsigned> TFTPServerPool::get_allowed_cpus()
+    {
+        std::vector<unsigned> cpus;
+
+#ifdef __linux__
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+
+        if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+        {
+            for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &cpu_set))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+#ifdef _WIN32
+        DWORD_PTR process_mask = 0;
+        DWORD_PTR system_mask = 0;
+
+        if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+        {
+            for (unsigned cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+            {
+                if (process_mask & (DWORD_PTR{1} << cpu))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+
+        // The mask could not be read, fall back to the first hardware threads.
+        if (cpus.empty())
+        {
+            const unsigned cpu_count = std::max(1u, std::thread::hardware_concurrency());
+
+            for (unsigned cpu = 0; cpu < cpu_count; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+
+        return cpus;
+    }
+
+    bool TFTPServerPool::pin_worker(std::thread& worker, unsigned cpu)
+    {
+#ifdef __linux__
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+
+        return pthread_setaffinity_np(worker.native_handle(), sizeof(cpu_set), &cpu_set) == 0;
+#endif
+#ifdef _WIN32
+        return SetThreadAffinityMask(worker.native_handle(), DWORD_PTR{1} << cpu) != 0;
+#endif
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
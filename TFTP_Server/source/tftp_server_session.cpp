@@ -0,0 +1,1016 @@
+///
+/// @file tftp_server_session.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPServerSession class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include "tftp_server_session.hpp"
+
+#ifdef TFTP_IO_URING
+#include <fcntl.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <tftp_poller.hpp>
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPServerSession::TFTPServerSession(const SOCKADDR_IN& local_info,
+                                         const SOCKADDR_STORAGE_LH& peer,
+                                         socklen_t peer_size,
+                                         transfer_type_t transfer_type,
+                                         TFTPStorage::resolved_file_t file,
+                                         const transfer_options_t& options)
+        : m_storage{nullptr},
+          m_mapped_file{nullptr},
+          m_mapped_offset{0},
+          m_range_left{std::numeric_limits<uint64_t>::max()},
+          m_write_behind{nullptr},
+          m_upload{nullptr},
+          m_netascii{},
+          m_decoded_block{},
+          m_checksum{},
+          m_file{std::move(file)},
+          m_session_socket{INVALID_SOCKET},
+          m_peer{peer},
+          m_peer_size{peer_size},
+          m_session{},
+          m_task{},
+          m_requested_options{options},
+          m_max_retries{TFTP_DEFAULT_MAX_RETRIES},
+          m_transfer_type{transfer_type},
+          m_file_exhausted{false}
+#ifdef TFTP_IO_URING
+          ,
+          m_ring{nullptr},
+          m_ring_id{0},
+          m_file_fd{-1},
+          m_file_offset{0},
+          m_read_vectors{},
+          m_read_in_flight{false},
+          m_read_result{0},
+          m_writes_in_flight{0},
+          m_write_failed{false},
+          m_bytes_written{0},
+          m_receive_buffer_id{-1},
+          m_buffer_claimed{false}
+#endif
+    {
+        this->m_session_socket = socket(PF_INET, SOCK_DGRAM, IPPROTO_IP);
+
+        if (this->m_session_socket == SOCKET_ERROR)
+        {
+            throw std::runtime_error("Error at session socket creation. Error code: " +
+                                     GET_LAST_ERROR());
+        }
+
+        SOCKADDR_IN session_info = local_info;
+        session_info.sin_port = 0;
+
+        const int status = bind(this->m_session_socket,
+                                reinterpret_cast<SOCKADDR*>(&session_info),
+                                sizeof(session_info));
+
+        if (status == SOCKET_ERROR)
+        {
+            const std::string error_str = "Error at session socket binding. Error code: " +
+                                          GET_LAST_ERROR();
+            CLOSE_SOCKET(this->m_session_socket);
+
+            throw std::runtime_error(error_str);
+        }
+
+        TFTPPoller::set_non_blocking(this->m_session_socket);
+    }
+
+    TFTPServerSession::~TFTPServerSession()
+    {
+#ifdef TFTP_IO_URING
+        if (this->m_file_fd >= 0 && this->m_upload == nullptr)
+        {
+            close(this->m_file_fd);
+        }
+#endif
+
+        if (this->m_upload != nullptr && (this->m_requested_options.negotiated & OPTION_OFFSET) != 0)
+        {
+            // Only a client which negotiated the offset option can resume the
+            // aborted upload, a committed one ignores this.
+            uint64_t stored = this->m_upload->get_size();
+
+#ifdef TFTP_IO_URING
+            if (this->m_ring != nullptr)
+            {
+                // Only kept if every ring write completed, nothing is missing before the end.
+                stored = this->m_bytes_written == this->m_file_offset ? this->m_bytes_written : 0;
+            }
+#endif
+
+            this->m_upload->keep_partial(stored);
+        }
+
+        // The frame refers to the session, which the reactor forgets
+        // before the socket goes.
+        this->m_task = TFTPTask<bool>();
+        this->m_session.reset();
+
+        if (this->m_session_socket != INVALID_SOCKET &&
+            this->m_session_socket != SOCKET_ERROR)
+        {
+            CLOSE_SOCKET(this->m_session_socket);
+        }
+    }
+
+    bool TFTPServerSession::start(TFTPReactor& reactor)
+    {
+        const transfer_options_t& options = this->m_requested_options;
+        const bool upload = this->m_transfer_type == TRANSFER_TYPE_WRQ;
+
+        // An upload takes up to a window of Data packets with one call.
+        this->m_session = std::make_unique<TFTPCoSession>(reactor, this->m_session_socket,
+                                                          *reinterpret_cast<const SOCKADDR_IN*>(&this->m_peer), true,
+                                                          upload ? TRANSFER_ROLE_RECEIVER : TRANSFER_ROLE_SENDER,
+                                                          upload ? options.block_size + data_begin : TFTP_REQUEST_BUFFER_LEN,
+                                                          std::min(options.window_size, TFTP_BATCH_SIZE),
+                                                          options, this->m_max_retries, this);
+
+        this->m_task = upload ? this->serve_wrq() : this->serve_rrq();
+        this->m_task.start();
+
+        return !this->m_task.is_done();
+    }
+
+    bool TFTPServerSession::is_done() const
+    {
+        return this->m_task.is_done();
+    }
+
+#ifdef TFTP_IO_URING
+
+    void TFTPServerSession::attach_ring(TFTPUring* ring, uint64_t ring_id)
+    {
+        this->m_ring = ring;
+        this->m_ring_id = ring_id;
+    }
+
+    bool TFTPServerSession::on_datagram(const TFTPUring::datagram_t& datagram, int buffer_id,
+                                        bool& buffer_claimed)
+    {
+        this->m_receive_buffer_id = buffer_id;
+        this->m_buffer_claimed = false;
+
+        // A Data block is written straight from the provided buffer while the
+        // coroutine handles it, before the call returns.
+        (void)this->m_session->on_datagram(datagram.data, datagram.size,
+                                           *datagram.sender, datagram.sender_size);
+
+        buffer_claimed = this->m_buffer_claimed;
+        this->m_receive_buffer_id = -1;
+
+        return !this->m_task.is_done();
+    }
+
+    bool TFTPServerSession::on_read_complete(int result)
+    {
+        this->m_read_in_flight = false;
+        this->m_read_result = result;
+        (void)this->m_session->notify();
+
+        return !this->m_task.is_done();
+    }
+
+    bool TFTPServerSession::on_write_complete(int result)
+    {
+        --this->m_writes_in_flight;
+
+        if (result < 0)
+        {
+            this->m_write_failed = true;
+        }
+        else
+        {
+            this->m_bytes_written += result;
+        }
+
+        (void)this->m_session->notify();
+
+        return !this->m_task.is_done();
+    }
+
+    void TFTPServerSession::release_file_io(uring_op_t op)
+    {
+        if (op == URING_OP_READ)
+        {
+            this->m_read_in_flight = false;
+        }
+        else if (op == URING_OP_WRITE)
+        {
+            --this->m_writes_in_flight;
+        }
+    }
+
+    bool TFTPServerSession::has_file_io_in_flight() const
+    {
+        return this->m_read_in_flight || this->m_writes_in_flight > 0;
+    }
+
+    uint64_t TFTPServerSession::get_ring_id() const
+    {
+        return this->m_ring_id;
+    }
+
+#endif
+
+    const TFTPRetransmitter& TFTPServerSession::get_retransmitter() const
+    {
+        return this->m_session->get_retransmitter();
+    }
+
+    void TFTPServerSession::set_max_retries(int max_retries)
+    {
+        this->m_max_retries = max_retries;
+    }
+
+    void TFTPServerSession::set_storage(TFTPStorage* storage)
+    {
+        this->m_storage = storage;
+    }
+
+    void TFTPServerSession::set_write_behind(TFTPWriteBehind* write_behind)
+    {
+        this->m_write_behind = write_behind;
+    }
+
+    bool TFTPServerSession::on_upload_written()
+    {
+        if (this->m_task.is_done())
+        {
+            return false;
+        }
+
+        // Takes in the outcome of the finished writes, a failed one fails the
+        // next block or the commit of the coroutine.
+        (void)this->m_upload->is_idle();
+        (void)this->m_session->notify();
+
+        return !this->m_task.is_done();
+    }
+
+    SOCKET TFTPServerSession::get_socket() const
+    {
+        return this->m_session_socket;
+    }
+
+    const SOCKADDR_STORAGE_LH& TFTPServerSession::get_peer() const
+    {
+        return this->m_peer;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPServerSession::open_file()
+    {
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            if (this->m_transfer_type == TRANSFER_TYPE_WRQ)
+            {
+                // The ring writes into the temporary file the writer commits.
+                if (!this->open_upload())
+                {
+                    return false;
+                }
+
+                this->m_file_fd = this->m_upload->get_fd();
+                this->m_file_offset = this->m_upload->get_size();
+                this->m_bytes_written = this->m_file_offset;
+                return true;
+            }
+
+            if (this->m_storage != nullptr && !this->m_storage->has_file_paths())
+            {
+                // Nothing to read on the ring, blocks go out of the view.
+                this->m_mapped_file = this->m_storage->open_read(this->m_file);
+                return this->m_mapped_file != nullptr;
+            }
+
+            if (this->m_session->get_session().get_options().mode == TRANSFER_MODE_OCTET)
+            {
+                this->m_file_fd = open(this->m_file.path.c_str(), O_RDONLY | O_CLOEXEC);
+                return this->m_file_fd >= 0;
+            }
+
+            // Netascii blocks are translated on the way out, nothing is read
+            // straight into the window, so the file is mapped as below.
+        }
+#endif
+
+        if (this->m_transfer_type == TRANSFER_TYPE_WRQ)
+        {
+            return this->open_upload();
+        }
+
+        if (this->m_storage != nullptr)
+        {
+            this->m_mapped_file = this->m_storage->open_read(this->m_file);
+        }
+        else
+        {
+            auto mapped_file = std::make_shared<TFTPMappedFile>();
+
+            if (mapped_file->open(this->m_file.path))
+            {
+                this->m_mapped_file = std::move(mapped_file);
+            }
+        }
+
+        if (this->m_mapped_file != nullptr)
+        {
+            return true;
+        }
+
+        this->m_in_file.open(this->m_file.path, std::ios::binary);
+        return this->m_in_file.is_open();
+    }
+
+    bool TFTPServerSession::open_upload()
+    {
+        const int64_t offset = this->m_session->get_session().get_options().offset;
+
+        this->m_upload = std::make_unique<TFTPUploadFile>(*this->m_write_behind, this);
+
+        return offset > 0 ? this->m_upload->resume(this->m_file.path, offset)
+                          : this->m_upload->open(this->m_file.path);
+    }
+
+    bool TFTPServerSession::is_upload_current() const
+    {
+        const transfer_options_t& options = this->m_session->get_session().get_options();
+        constexpr int described = OPTION_TRANSFER_SIZE | OPTION_MODIFIED_TIME;
+
+        if ((options.negotiated & described) != described || options.mode != TRANSFER_MODE_OCTET)
+        {
+            return false;
+        }
+
+        std::error_code error;
+        const uintmax_t file_size = std::filesystem::file_size(this->m_file.path, error);
+        int64_t modified_time = 0;
+
+        return !error &&
+               file_size == static_cast<uintmax_t>(options.transfer_size) &&
+               TFTP::read_modified_time(this->m_file.path, modified_time) &&
+               modified_time == options.modified_time;
+    }
+
+    bool TFTPServerSession::preallocate_file()
+    {
+        const transfer_options_t& options = this->m_session->get_session().get_options();
+
+        if ((options.negotiated & OPTION_TRANSFER_SIZE) == 0)
+        {
+            return true;
+        }
+
+        return TFTPUploadFile::preallocate(this->m_upload->get_fd(), options.transfer_size);
+    }
+
+    bool TFTPServerSession::select_range()
+    {
+        transfer_options_t& options = this->m_session->get_session().get_options();
+        const bool ranged = (options.negotiated & (OPTION_OFFSET | OPTION_LENGTH)) != 0;
+
+        if ((options.negotiated & OPTION_MODIFIED_TIME) != 0 &&
+            !TFTP::read_modified_time(this->m_file.path, options.modified_time))
+        {
+            // Files inside a pack have no time of their own.
+            options.negotiated &= ~OPTION_MODIFIED_TIME;
+        }
+
+        if ((options.negotiated & OPTION_TRANSFER_SIZE) == 0 && !ranged)
+        {
+            return true;
+        }
+
+        std::error_code error;
+        const uintmax_t file_size = this->m_mapped_file != nullptr
+                                    ? this->m_mapped_file->get_size()
+                                    : std::filesystem::file_size(this->m_file.path, error);
+
+        if (error)
+        {
+            options.negotiated &= ~OPTION_TRANSFER_SIZE;
+            return !ranged;
+        }
+
+        // tsize stays the size of the whole file, a striping client splits it.
+        options.transfer_size = static_cast<int64_t>(file_size);
+
+        if (!ranged)
+        {
+            return true;
+        }
+
+        const auto offset = static_cast<uint64_t>(options.offset);
+
+        if (offset > file_size)
+        {
+            return false;
+        }
+
+        const uint64_t available = file_size - offset;
+
+        // The OACK echoes the length the range was cut to at the end of the file.
+        if ((options.negotiated & OPTION_LENGTH) != 0)
+        {
+            options.length = static_cast<int64_t>(std::min(static_cast<uint64_t>(options.length), available));
+            this->m_range_left = static_cast<uint64_t>(options.length);
+        }
+        else
+        {
+            this->m_range_left = available;
+        }
+
+        this->m_mapped_offset = static_cast<size_t>(offset);
+
+#ifdef TFTP_IO_URING
+        this->m_file_offset = offset;
+#endif
+
+        if (this->m_in_file.is_open())
+        {
+            this->m_in_file.seekg(static_cast<std::streamoff>(offset));
+        }
+
+        return true;
+    }
+
+    int TFTPServerSession::read_netascii_block(char* block)
+    {
+        const int block_size = this->m_session->get_session().get_options().block_size;
+
+        if (this->m_mapped_file == nullptr)
+        {
+            return this->m_netascii.encode_block(this->m_in_file, block, block_size);
+        }
+
+        // A pair split by the end of the previous block is finished first.
+        size_t consumed = 0;
+        const int produced = this->m_netascii.encode(this->m_mapped_file->get_data() + this->m_mapped_offset,
+                                                     this->m_mapped_file->get_size() - this->m_mapped_offset,
+                                                     consumed, block, block_size);
+        this->m_mapped_offset += consumed;
+
+        return produced;
+    }
+
+    void TFTPServerSession::add_to_checksum(const char* payload, int payload_size)
+    {
+        if ((this->m_session->get_session().get_options().negotiated & OPTION_CHECKSUM) != 0)
+        {
+            this->m_checksum.update(payload, static_cast<size_t>(payload_size));
+        }
+    }
+
+    void TFTPServerSession::verify_checksum(const ack_view_t& ack)
+    {
+        if ((this->m_session->get_session().get_options().negotiated & OPTION_CHECKSUM) == 0)
+        {
+            return;
+        }
+
+        uint32_t reported = 0;
+        char digests[48];
+
+        if (!TFTP::parse_ack_checksum(ack, reported))
+        {
+            std::cout << "Client sent no checksum for " << this->m_file.path << ".\n";
+            return;
+        }
+
+        if (reported == this->m_checksum.get_value())
+        {
+            snprintf(digests, sizeof(digests), "%08x", reported);
+            std::cout << "Transfer of " << this->m_file.path << " verified, crc32c " << digests << ".\n";
+            return;
+        }
+
+        snprintf(digests, sizeof(digests), "sent %08x, client got %08x", this->m_checksum.get_value(), reported);
+        std::cout << "Checksum of " << this->m_file.path << " does not match: " << digests << ".\n";
+    }
+
+    bool TFTPServerSession::store_block(const char* payload, int payload_size)
+    {
+        // Taken over the payload as it travelled, before any translation.
+        this->add_to_checksum(payload, payload_size);
+
+        if (this->m_session->get_session().get_options().mode == TRANSFER_MODE_NETASCII)
+        {
+            // Translated into a block of its own, the payload of a provided
+            // buffer is never claimed by a ring write.
+            const int decoded_size = this->m_netascii.decode(payload, payload_size, this->m_decoded_block.data());
+            return !this->m_upload->has_failed() && this->m_upload->append(this->m_decoded_block.data(), decoded_size);
+        }
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            if (this->m_write_failed)
+            {
+                return false;
+            }
+
+            // Written straight from the provided buffer, which stays out of
+            // the kernel's hands until the write completes.
+            this->m_ring->prepare_write(this->m_file_fd, payload, payload_size, this->m_file_offset,
+                                        TFTPUring::make_user_data(URING_OP_WRITE,
+                                                                  this->m_receive_buffer_id,
+                                                                  this->m_ring_id));
+            this->m_file_offset += payload_size;
+            ++this->m_writes_in_flight;
+            this->m_buffer_claimed = true;
+            return true;
+        }
+#endif
+
+        // Copied into a staging buffer, the block is acknowledged right away.
+        return !this->m_upload->has_failed() && this->m_upload->append(payload, payload_size);
+    }
+
+    bool TFTPServerSession::finish_wrq()
+    {
+        if (this->m_session->get_session().get_options().mode == TRANSFER_MODE_NETASCII)
+        {
+            const int decoded_size = this->m_netascii.finish_decode(this->m_decoded_block.data());
+
+            if (!this->m_upload->append(this->m_decoded_block.data(), decoded_size))
+            {
+                this->send_error_packet(ERR_CODE_DISK_FULL, "File could not be written");
+                return false;
+            }
+        }
+
+        this->m_upload->flush();
+
+        return true;
+    }
+
+    bool TFTPServerSession::commit_wrq()
+    {
+        bool written = !this->m_upload->has_failed();
+
+#ifdef TFTP_IO_URING
+        if (this->m_ring != nullptr)
+        {
+            written = written && this->m_bytes_written == this->m_file_offset;
+        }
+#endif
+
+        if (!written)
+        {
+            this->send_error_packet(ERR_CODE_DISK_FULL, "File could not be written");
+            return false;
+        }
+
+        const transfer_options_t& options = this->m_session->get_session().get_options();
+
+        // Completes once the writer renamed the file, on_upload_written() tells.
+        this->m_upload->commit((options.negotiated & OPTION_MODIFIED_TIME) != 0 ? options.modified_time : 0);
+        return true;
+    }
+
+    bool TFTPServerSession::complete_wrq()
+    {
+        if (!this->m_upload->close())
+        {
+            this->send_error_packet(ERR_CODE_DISK_FULL, "File could not be written");
+            return false;
+        }
+
+#ifdef TFTP_IO_URING
+        this->m_file_fd = -1;
+#endif
+
+        if (!this->m_upload->is_durable())
+        {
+            // The file is in place and served, the client is not told otherwise.
+            std::cout << "Upload of " << this->m_file.path << " stored, but its directory could not be flushed.\n";
+        }
+
+        if ((this->m_session->get_session().get_options().negotiated & OPTION_CHECKSUM) != 0)
+        {
+            // The client compares it with the blocks it sent.
+            char digest[16];
+            snprintf(digest, sizeof(digest), "%08x", this->m_checksum.get_value());
+            std::cout << "Upload of " << this->m_file.path << " stored, crc32c " << digest << ".\n";
+
+            this->m_session->get_session().set_final_checksum(this->m_checksum.get_value());
+        }
+
+        return true;
+    }
+
+    bool TFTPServerSession::is_upload_idle()
+    {
+#ifdef TFTP_IO_URING
+        if (this->m_writes_in_flight > 0)
+        {
+            return false;
+        }
+#endif
+
+        return this->m_upload->is_idle();
+    }
+
+#ifdef TFTP_IO_URING
+
+    void TFTPServerSession::submit_block_reads()
+    {
+        const int block_size = this->m_session->get_session().get_options().block_size;
+        const int slots = this->m_session->get_session().free_window_slots();
+
+        this->m_read_vectors.resize(slots);
+
+        for (int i = 0; i < slots; ++i)
+        {
+            this->m_read_vectors[i].iov_base = this->m_session->get_session().next_block_buffer(i);
+            this->m_read_vectors[i].iov_len = block_size;
+        }
+
+        this->m_ring->prepare_read(this->m_file_fd, this->m_read_vectors.data(), slots, this->m_file_offset,
+                                   TFTPUring::make_user_data(URING_OP_READ, 0, this->m_ring_id));
+        this->m_read_in_flight = true;
+    }
+
+    bool TFTPServerSession::send_read_blocks()
+    {
+        if (this->m_read_result < 0)
+        {
+            this->send_error_packet(ERR_CODE_NOT_DEFINED, "File could not be read");
+            return false;
+        }
+
+        TFTPSession& window = this->m_session->get_session();
+        const int block_size = window.get_options().block_size;
+        int remaining = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(this->m_read_result),
+                                                            this->m_range_left));
+
+        // One read filled consecutive window slots, short only at the end of the file.
+        for (size_t i = 0; i < this->m_read_vectors.size(); ++i)
+        {
+            const int read_size = std::min(remaining, block_size);
+
+            this->add_to_checksum(static_cast<const char*>(this->m_read_vectors[i].iov_base), read_size);
+            (void)this->m_session->send_block(read_size);
+            this->m_file_offset += read_size;
+            this->m_range_left -= read_size;
+            remaining -= read_size;
+
+            if (window.is_last_block(read_size))
+            {
+                this->m_file_exhausted = true;
+                break;
+            }
+        }
+
+        return true;
+    }
+
+#endif
+
+    TFTPTask<bool> TFTPServerSession::serve_rrq()
+    {
+        TFTPCoSession& session = *this->m_session;
+        ack_view_t ack{};
+
+        if (!this->open_file())
+        {
+            this->send_error_packet(ERR_CODE_FILE_NOT_FOUND,
+                                    "File could not be found for RRQ");
+            co_return false;
+        }
+
+        if (!this->select_range())
+        {
+            this->send_error_packet(ERR_CODE_OPTION_NEGOTIATION,
+                                    "Requested range does not start inside the file");
+            co_return false;
+        }
+
+        if (session.get_session().get_options().negotiated != 0)
+        {
+            // The client starts the data transfer with ACK 0 of the OACK.
+            co_await session.send_oack();
+
+            do
+            {
+                const receive_status_t status = co_await session.recv_ack(ack);
+
+                if (status != RECEIVE_STATUS_OK)
+                {
+                    this->end_transfer(status, "ACK Packet of data is missing");
+                    co_return false;
+                }
+            } while (!session.accept_ack(ack));
+        }
+
+        while (true)
+        {
+            while (this->send_data_packets())
+            {
+#ifdef TFTP_IO_URING
+                // ACKs which arrive during the read are kept for the next receive.
+                const receive_status_t status = co_await session.wait_for_owner();
+
+                if (status != RECEIVE_STATUS_OK)
+                {
+                    this->end_transfer(status, "");
+                    co_return false;
+                }
+
+                if (!this->send_read_blocks())
+                {
+                    co_return false;
+                }
+#endif
+            }
+
+            const receive_status_t status = co_await session.recv_ack(ack);
+
+            if (status != RECEIVE_STATUS_OK)
+            {
+                this->end_transfer(status, "ACK Packet of data is missing");
+                co_return false;
+            }
+
+            if (!session.accept_ack(ack))
+            {
+                continue;
+            }
+
+            if (this->m_file_exhausted && session.get_session().is_window_acked())
+            {
+                this->verify_checksum(ack);
+                co_return true;
+            }
+        }
+    }
+
+    TFTPTask<bool> TFTPServerSession::serve_wrq()
+    {
+        TFTPCoSession& session = *this->m_session;
+        const transfer_options_t& options = session.get_session().get_options();
+        data_view_t data{};
+
+        if (this->is_upload_current())
+        {
+            // A syncing client offers a file the server already holds.
+            this->send_error_packet(ERR_CODE_FILE_EXISTS, "File is up to date");
+            co_return false;
+        }
+
+        if (!this->open_file())
+        {
+            if (options.offset > 0)
+            {
+                this->send_error_packet(ERR_CODE_OPTION_NEGOTIATION,
+                                        "No partial upload to resume at the offset");
+                co_return false;
+            }
+
+            this->send_error_packet(ERR_CODE_ACCESS_VIOLATION,
+                                    "File could not be created for WRQ");
+            co_return false;
+        }
+
+        if (!this->preallocate_file())
+        {
+            this->send_error_packet(ERR_CODE_DISK_FULL, "Not enough disk space for the file");
+            co_return false;
+        }
+
+        if (options.mode == TRANSFER_MODE_NETASCII)
+        {
+            // Decoding shrinks a block, only a CR held back by the last one adds a byte.
+            this->m_decoded_block.resize(options.block_size + 1);
+        }
+
+        if (options.negotiated != 0)
+        {
+            co_await session.send_oack();
+        }
+        else
+        {
+            co_await session.send_ack();
+        }
+
+        while (true)
+        {
+            const receive_status_t status = co_await session.recv_block(data);
+
+            if (status != RECEIVE_STATUS_OK)
+            {
+                this->end_transfer(status, "Data Packet is missing");
+                co_return false;
+            }
+
+            const int payload_size = static_cast<int>(data.payload.size());
+            const data_verdict_t verdict = session.accept_data(data);
+
+            if (verdict == DATA_VERDICT_STORE || verdict == DATA_VERDICT_STORE_AND_ACK)
+            {
+                if (!this->store_block(data.payload.data(), payload_size))
+                {
+                    this->send_error_packet(ERR_CODE_DISK_FULL, "File could not be written");
+                    co_return false;
+                }
+
+                if (verdict == DATA_VERDICT_STORE_AND_ACK && session.get_session().is_last_block(payload_size))
+                {
+                    break;
+                }
+            }
+
+            if (verdict == DATA_VERDICT_STORE_AND_ACK || verdict == DATA_VERDICT_ACK)
+            {
+                co_await session.send_ack();
+            }
+        }
+
+        // The file is complete on disk before the client hears about it. A
+        // plain ACK of the last block would say so too early, so nothing is
+        // resent meanwhile and repeats of the block wait like the client.
+        if (!this->finish_wrq())
+        {
+            co_return false;
+        }
+
+        if (!co_await this->wait_for_upload())
+        {
+            co_return false;
+        }
+
+        if (!this->commit_wrq())
+        {
+            co_return false;
+        }
+
+        if (!co_await this->wait_for_upload())
+        {
+            co_return false;
+        }
+
+        if (!this->complete_wrq())
+        {
+            co_return false;
+        }
+
+        co_await session.send_ack();
+
+        // Long enough for the client to time out once and repeat its last
+        // block, the final ACK is sent again if it got lost.
+        const auto linger_time = std::clamp<std::chrono::microseconds>(2 * session.get_retransmitter().get_rto(),
+                                                                       std::chrono::milliseconds(TFTP_MIN_LINGER_MS),
+                                                                       std::chrono::milliseconds(TFTP_MAX_RTO_MS));
+        const auto linger_deadline = TFTPRetransmitter::steady_clock_t::now() + linger_time;
+
+        while (co_await session.recv_block_until(data, linger_deadline) == RECEIVE_STATUS_OK)
+        {
+            co_await session.send_ack();
+        }
+
+        co_return true;
+    }
+
+    TFTPTask<bool> TFTPServerSession::wait_for_upload()
+    {
+        while (!this->is_upload_idle())
+        {
+            const receive_status_t status = co_await this->m_session->wait_for_owner();
+
+            if (status != RECEIVE_STATUS_OK)
+            {
+                this->end_transfer(status, "");
+                co_return false;
+            }
+        }
+
+        co_return true;
+    }
+
+    bool TFTPServerSession::send_data_packets()
+    {
+        TFTPCoSession& session = *this->m_session;
+        TFTPSession& window = session.get_session();
+
+        // Blocks left of a rewound window go first, which also runs the timer
+        // again for the blocks still unacknowledged.
+        (void)session.send_unsent_blocks();
+
+        while (!this->m_file_exhausted && window.is_window_open())
+        {
+            if (window.get_options().mode == TRANSFER_MODE_NETASCII)
+            {
+                // Translated into the window slot, line ends change the block boundaries.
+                char* block = window.next_block_buffer();
+                const int read_size = this->read_netascii_block(block);
+
+                this->add_to_checksum(block, read_size);
+                this->m_file_exhausted = window.is_last_block(read_size);
+                (void)session.send_block(read_size);
+                continue;
+            }
+
+#ifdef TFTP_IO_URING
+            if (this->m_ring != nullptr && this->m_mapped_file == nullptr)
+            {
+                this->submit_block_reads();
+                return true;
+            }
+#endif
+
+            if (this->m_mapped_file != nullptr)
+            {
+                // The block goes out straight from the mapping, nothing is copied.
+                const int read_size = static_cast<int>(std::min<uint64_t>(
+                    std::min<uint64_t>(this->m_mapped_file->get_size() - this->m_mapped_offset, this->m_range_left),
+                    static_cast<uint64_t>(window.get_options().block_size)));
+
+                this->add_to_checksum(this->m_mapped_file->get_data() + this->m_mapped_offset, read_size);
+                (void)session.send_block(this->m_mapped_file->get_data() + this->m_mapped_offset, read_size);
+                this->m_mapped_offset += read_size;
+                this->m_range_left -= read_size;
+                this->m_file_exhausted = window.is_last_block(read_size);
+                continue;
+            }
+
+            // The file is read straight into the window slot of the block.
+            char* block = window.next_block_buffer();
+            this->m_in_file.read(block, static_cast<std::streamsize>(std::min<uint64_t>(
+                this->m_range_left, static_cast<uint64_t>(window.get_options().block_size))));
+            const int read_size = static_cast<int>(this->m_in_file.gcount());
+            this->m_range_left -= read_size;
+
+            this->add_to_checksum(block, read_size);
+            this->m_file_exhausted = window.is_last_block(read_size);
+            (void)session.send_block(read_size);
+        }
+
+        return false;
+    }
+
+    void TFTPServerSession::end_transfer(receive_status_t status, const std::string& missing)
+    {
+        switch (status)
+        {
+        case RECEIVE_STATUS_PEER_ERROR:
+            std::cout << "Client aborted the transfer of " << this->m_file.path << ".\n";
+            break;
+
+        case RECEIVE_STATUS_TIMED_OUT:
+            // The session has already told the client.
+            std::cout << "Session for " << this->m_file.path << " failed: Transfer timed out.\n";
+            break;
+
+        default:
+            this->send_error_packet(ERR_CODE_ILLEGAL_OPERATION, missing);
+            break;
+        }
+    }
+
+    void TFTPServerSession::send_error_packet(int error_code, const std::string& error_message)
+    {
+        this->m_session->send_error(error_code, error_message);
+
+        std::cout << "Session for " << this->m_file.path << " failed: " << error_message << ".\n";
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
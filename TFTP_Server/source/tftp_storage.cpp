@@ -0,0 +1,54 @@
+///
+/// @file tftp_storage.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the default implementations of the TFTPStorage interface.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tftp_storage.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    bool TFTPStorage::has_file_paths() const
+    {
+        return true;
+    }
+
+    SOCKET TFTPStorage::get_notify_socket() const
+    {
+        return INVALID_SOCKET;
+    }
+
+    void TFTPStorage::refresh()
+    {
+    }
+
+    void TFTPStorage::expire_uploads()
+    {
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
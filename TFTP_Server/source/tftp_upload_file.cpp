@@ -0,0 +1,418 @@
+///
+/// @file tftp_upload_file.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPUploadFile class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include "tftp_upload_file.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPUploadFile::TFTPUploadFile(TFTPWriteBehind& writer, void* owner)
+        : m_writer{writer},
+          m_owner{owner},
+          m_final_path{},
+          m_temp_path{},
+          m_fd{-1},
+          m_buffers{},
+          m_jobs{},
+          m_commit_job{},
+          m_commit_submitted{false},
+          m_current{0},
+          m_fill{0},
+          m_offset{0},
+          m_failed{false},
+          m_partial_size{0}
+    {
+    }
+
+    TFTPUploadFile::~TFTPUploadFile()
+    {
+        // The writer may still be using the buffers of an aborted transfer.
+        for (const TFTPWriteBehind::write_job_t& job : this->m_jobs)
+        {
+            this->m_writer.wait(job);
+            this->check_job(job);
+        }
+
+        this->m_writer.wait(this->m_commit_job);
+
+        const bool opened = this->m_fd >= 0;
+        (void)this->close();
+
+        if (this->is_committed())
+        {
+            // A finished upload leaves nothing to resume.
+            (void)std::remove((this->m_final_path + TFTP_PARTIAL_SUFFIX).c_str());
+        }
+        else if (opened && this->m_partial_size > 0 && !this->m_failed)
+        {
+            // Blocks past the size may be missing, a resume starts before them anyway.
+            std::error_code error;
+            std::filesystem::resize_file(this->m_temp_path, this->m_partial_size, error);
+            std::filesystem::rename(this->m_temp_path, this->m_final_path + TFTP_PARTIAL_SUFFIX, error);
+
+            if (error)
+            {
+                (void)std::remove(this->m_temp_path.c_str());
+            }
+        }
+        else if (opened)
+        {
+            (void)std::remove(this->m_temp_path.c_str());
+        }
+
+        for (char* buffer : this->m_buffers)
+        {
+            if (buffer != nullptr)
+            {
+                ::operator delete[](buffer, std::align_val_t{TFTP_WRITE_BEHIND_ALIGNMENT});
+            }
+        }
+    }
+
+    bool TFTPUploadFile::open(const std::string& file_path)
+    {
+        this->m_final_path = file_path;
+
+        // Uploads of the same path each get their own name, the last commit wins.
+        do
+        {
+            this->m_temp_path = make_temp_path(file_path);
+
+#ifdef __linux__
+            this->m_fd = ::open(this->m_temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+#endif
+#ifdef _WIN32
+            this->m_fd = _open(this->m_temp_path.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                               _S_IREAD | _S_IWRITE);
+#endif
+        } while (this->m_fd < 0 && errno == EEXIST);
+
+        return this->m_fd >= 0;
+    }
+
+    bool TFTPUploadFile::resume(const std::string& file_path, int64_t offset)
+    {
+        const std::string partial_path = file_path + TFTP_PARTIAL_SUFFIX;
+        std::error_code error;
+        const uintmax_t partial_size = std::filesystem::file_size(partial_path, error);
+
+        if (error || partial_size < static_cast<uintmax_t>(offset))
+        {
+            return false;
+        }
+
+        this->m_final_path = file_path;
+        this->m_temp_path = make_temp_path(file_path);
+
+        // Claimed under a name of its own, a second resume of the path finds nothing.
+        std::filesystem::rename(partial_path, this->m_temp_path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+#ifdef __linux__
+        this->m_fd = ::open(this->m_temp_path.c_str(), O_WRONLY | O_CLOEXEC);
+        const bool cut = this->m_fd >= 0 && ftruncate(this->m_fd, static_cast<off_t>(offset)) == 0;
+#endif
+#ifdef _WIN32
+        this->m_fd = _open(this->m_temp_path.c_str(), _O_WRONLY | _O_BINARY);
+        const bool cut = this->m_fd >= 0 && _chsize_s(this->m_fd, offset) == 0;
+#endif
+
+        if (this->m_fd < 0)
+        {
+            // Left for the next attempt under the name it was found with.
+            std::filesystem::rename(this->m_temp_path, partial_path, error);
+            return false;
+        }
+
+        this->m_offset = static_cast<uint64_t>(offset);
+
+        return cut;
+    }
+
+    bool TFTPUploadFile::is_temporary_name(const std::string& file_name)
+    {
+        const size_t separator = file_name.find_last_of("/\\");
+        const std::string name = separator == std::string::npos ? file_name : file_name.substr(separator + 1);
+        const std::string partial_suffix = TFTP_PARTIAL_SUFFIX;
+
+        if (name.size() >= partial_suffix.size() &&
+            name.compare(name.size() - partial_suffix.size(), partial_suffix.size(), partial_suffix) == 0)
+        {
+            return true;
+        }
+
+        // Temporary names end in TFTP_TEMP_INFIX, a number and TFTP_TEMP_SUFFIX.
+        const std::string temp_suffix = TFTP_TEMP_SUFFIX;
+
+        if (name.size() <= temp_suffix.size() ||
+            name.compare(name.size() - temp_suffix.size(), temp_suffix.size(), temp_suffix) != 0)
+        {
+            return false;
+        }
+
+        const size_t digits_end = name.size() - temp_suffix.size();
+        size_t digits_begin = digits_end;
+
+        while (digits_begin > 0 && isdigit(static_cast<unsigned char>(name[digits_begin - 1])) != 0)
+        {
+            --digits_begin;
+        }
+
+        const std::string temp_infix = TFTP_TEMP_INFIX;
+
+        return digits_begin < digits_end && digits_begin >= temp_infix.size() &&
+               name.compare(digits_begin - temp_infix.size(), temp_infix.size(), temp_infix) == 0;
+    }
+
+    void TFTPUploadFile::remove_stale(const std::string& root_directory, std::chrono::seconds max_age)
+    {
+        const auto oldest = std::filesystem::file_time_type::clock::now() - max_age;
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator entry(root_directory,
+                                                            std::filesystem::directory_options::skip_permission_denied,
+                                                            error);
+
+        // A running upload writes its file, only the abandoned ones grow old.
+        for (; !error && entry != std::filesystem::recursive_directory_iterator(); entry.increment(error))
+        {
+            std::error_code entry_error;
+
+            if (!entry->is_regular_file(entry_error) ||
+                !is_temporary_name(entry->path().filename().string()) ||
+                entry->last_write_time(entry_error) >= oldest || entry_error)
+            {
+                continue;
+            }
+
+            (void)std::filesystem::remove(entry->path(), entry_error);
+        }
+    }
+
+    bool TFTPUploadFile::preallocate(int fd, int64_t size)
+    {
+#ifdef __linux__
+        // Blocks are reserved without moving the end of the file, a client
+        // which sends less than it announced leaves no zeros behind.
+        if (size > 0 && fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) != 0)
+        {
+            return errno != ENOSPC && errno != EFBIG;
+        }
+#else
+        (void)fd;
+        (void)size;
+#endif
+        return true;
+    }
+
+    int TFTPUploadFile::get_fd() const
+    {
+        return this->m_fd;
+    }
+
+    bool TFTPUploadFile::append(const char* data, int size)
+    {
+        while (size > 0 && !this->m_failed)
+        {
+            if (this->m_fill == 0)
+            {
+                TFTPWriteBehind::write_job_t& job = this->m_jobs[this->m_current];
+
+                if (this->m_buffers[this->m_current] == nullptr)
+                {
+                    this->m_buffers[this->m_current] = static_cast<char*>(
+                        ::operator new[](TFTP_WRITE_BEHIND_BUFFER_SIZE, std::align_val_t{TFTP_WRITE_BEHIND_ALIGNMENT}));
+                }
+
+                // The disk is behind by every buffer, the network waits for it.
+                this->m_writer.wait(job);
+                this->check_job(job);
+            }
+
+            const size_t copy = std::min(static_cast<size_t>(size), TFTP_WRITE_BEHIND_BUFFER_SIZE - this->m_fill);
+
+            memcpy(this->m_buffers[this->m_current] + this->m_fill, data, copy);
+            this->m_fill += copy;
+            data += copy;
+            size -= static_cast<int>(copy);
+
+            if (this->m_fill == TFTP_WRITE_BEHIND_BUFFER_SIZE)
+            {
+                this->submit_buffer();
+            }
+        }
+
+        return !this->m_failed;
+    }
+
+    void TFTPUploadFile::flush()
+    {
+        if (this->m_fill != 0 && !this->m_failed)
+        {
+            this->submit_buffer();
+        }
+    }
+
+    uint64_t TFTPUploadFile::get_size() const
+    {
+        return this->m_offset + this->m_fill;
+    }
+
+    void TFTPUploadFile::keep_partial(uint64_t size)
+    {
+        // The destructor waits for the tail to be written.
+        this->flush();
+        this->m_partial_size = size;
+    }
+
+    void TFTPUploadFile::commit(int64_t modified_time)
+    {
+        this->m_commit_job.fd = this->m_fd;
+        this->m_commit_job.modified_time = modified_time;
+        this->m_commit_job.temp_path = this->m_temp_path.c_str();
+        this->m_commit_job.final_path = this->m_final_path.c_str();
+        this->m_commit_job.owner = this->m_owner;
+        this->m_commit_submitted = true;
+
+        this->m_writer.submit(this->m_commit_job);
+    }
+
+    bool TFTPUploadFile::is_committed() const
+    {
+        return this->m_commit_submitted &&
+               this->m_commit_job.done.load(std::memory_order_acquire) &&
+               this->m_commit_job.error == 0;
+    }
+
+    bool TFTPUploadFile::is_durable() const
+    {
+        return this->m_commit_job.directory_error == 0;
+    }
+
+    bool TFTPUploadFile::is_idle()
+    {
+        if (!this->m_commit_job.done.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        this->check_job(this->m_commit_job);
+
+        for (const TFTPWriteBehind::write_job_t& job : this->m_jobs)
+        {
+            if (!job.done.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            this->check_job(job);
+        }
+
+        return true;
+    }
+
+    bool TFTPUploadFile::has_failed() const
+    {
+        return this->m_failed;
+    }
+
+    bool TFTPUploadFile::close()
+    {
+        if (this->m_fd < 0)
+        {
+            return !this->m_failed;
+        }
+
+#ifdef __linux__
+        const int status = ::close(this->m_fd);
+#endif
+#ifdef _WIN32
+        const int status = _close(this->m_fd);
+#endif
+        this->m_fd = -1;
+
+        return status == 0 && !this->m_failed;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPUploadFile::submit_buffer()
+    {
+        TFTPWriteBehind::write_job_t& job = this->m_jobs[this->m_current];
+
+        job.fd = this->m_fd;
+        job.data = this->m_buffers[this->m_current];
+        job.size = this->m_fill;
+        job.offset = this->m_offset;
+        job.owner = this->m_owner;
+
+        this->m_writer.submit(job);
+
+        this->m_offset += this->m_fill;
+        this->m_fill = 0;
+        this->m_current = (this->m_current + 1) % TFTP_WRITE_BEHIND_BUFFERS;
+    }
+
+    std::string TFTPUploadFile::make_temp_path(const std::string& file_path)
+    {
+        static std::atomic<unsigned> next_id{0};
+
+        return file_path + TFTP_TEMP_INFIX + std::to_string(next_id.fetch_add(1)) + TFTP_TEMP_SUFFIX;
+    }
+
+    void TFTPUploadFile::check_job(const TFTPWriteBehind::write_job_t& job)
+    {
+        if (job.error != 0)
+        {
+            this->m_failed = true;
+        }
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */
@@ -0,0 +1,437 @@
+///
+/// @file tftp_write_behind.cpp
+/// @author Yasin BASAR
+/// @brief This file contains the implementation of the TFTPWriteBehind class methods.
+/// @version 1.0.0
+/// @date 11/08/2024
+/// @copyright (c) 2024 All rights reserved.
+///
+
+////////////////////////////////////////////////////////////////////////////////
+// Project Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+#include "tftp_write_behind.hpp"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Third Party Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <tftp.hpp>
+
+namespace YB
+{
+////////////////////////////////////////////////////////////////////////////////
+// Public Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    TFTPWriteBehind::TFTPWriteBehind()
+        : m_queue{},
+          m_finished{},
+          m_completed{},
+          m_pending{0},
+          m_sync_policy{SYNC_POLICY_GROUP},
+          m_stopping{false},
+          m_notify_fd{-1},
+          m_worker{}
+    {
+#ifdef __linux__
+        this->m_notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (this->m_notify_fd < 0)
+        {
+            throw std::runtime_error("Error at write behind eventfd creation. Error code: " +
+                                     GET_LAST_ERROR());
+        }
+#endif
+
+        this->m_worker = std::thread(&TFTPWriteBehind::run, this);
+    }
+
+    TFTPWriteBehind::~TFTPWriteBehind()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_stopping = true;
+        }
+
+        this->m_work.notify_one();
+        this->m_worker.join();
+
+#ifdef __linux__
+        close(this->m_notify_fd);
+#endif
+    }
+
+    void TFTPWriteBehind::submit(write_job_t& job)
+    {
+        job.error = 0;
+        job.done.store(false, std::memory_order_relaxed);
+
+        {
+            const std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_queue.push_back(&job);
+            ++this->m_pending;
+        }
+
+        this->m_work.notify_one();
+    }
+
+    void TFTPWriteBehind::wait(const write_job_t& job)
+    {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+
+        this->m_done.wait(lock, [&job]() { return job.done.load(std::memory_order_acquire); });
+    }
+
+    void TFTPWriteBehind::take_completions(std::vector<void*>& owners)
+    {
+        owners.clear();
+
+        const std::lock_guard<std::mutex> lock(this->m_mutex);
+        owners.swap(this->m_completed);
+    }
+
+    void TFTPWriteBehind::set_sync_policy(sync_policy_t sync_policy)
+    {
+        const std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_sync_policy = sync_policy;
+    }
+
+    bool TFTPWriteBehind::has_pending() const
+    {
+        const std::lock_guard<std::mutex> lock(this->m_mutex);
+
+        return this->m_pending != 0;
+    }
+
+    SOCKET TFTPWriteBehind::get_notify_socket() const
+    {
+#ifdef __linux__
+        return this->m_notify_fd;
+#else
+        return INVALID_SOCKET;
+#endif
+    }
+
+    void TFTPWriteBehind::clear_notification() const
+    {
+#ifdef __linux__
+        uint64_t count = 0;
+        (void)read(this->m_notify_fd, &count, sizeof(count));
+#endif
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Private Functions
+////////////////////////////////////////////////////////////////////////////////
+
+    void TFTPWriteBehind::run()
+    {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+
+        while (true)
+        {
+            this->m_work.wait(lock, [this]() { return this->m_stopping || !this->m_queue.empty(); });
+
+            if (this->m_queue.empty())
+            {
+                return;
+            }
+
+            if (this->m_queue.front()->temp_path != nullptr)
+            {
+                // The writes of a file are done before its commit is queued,
+                // so every queued commit can join the group.
+                this->m_finished.clear();
+
+                for (write_job_t* job : this->m_queue)
+                {
+                    if (job->temp_path != nullptr)
+                    {
+                        this->m_finished.push_back(job);
+                    }
+                }
+
+                this->m_queue.erase(std::remove_if(this->m_queue.begin(), this->m_queue.end(),
+                                                   [](const write_job_t* job) { return job->temp_path != nullptr; }),
+                                    this->m_queue.end());
+
+                const sync_policy_t sync_policy = this->m_sync_policy;
+
+                lock.unlock();
+                commit_all(this->m_finished, sync_policy);
+                lock.lock();
+            }
+            else
+            {
+                write_job_t* job = this->m_queue.front();
+                this->m_queue.pop_front();
+
+                lock.unlock();
+                const int error = write_fully(*job);
+                lock.lock();
+
+                job->error = error;
+                this->m_finished.assign(1, job);
+            }
+
+            for (write_job_t* job : this->m_finished)
+            {
+                this->m_completed.push_back(job->owner);
+                job->done.store(true, std::memory_order_release);
+                --this->m_pending;
+            }
+
+            this->m_done.notify_all();
+
+#ifdef __linux__
+            const uint64_t one = 1;
+            (void)write(this->m_notify_fd, &one, sizeof(one));
+#endif
+        }
+    }
+
+    int TFTPWriteBehind::write_fully(const write_job_t& job)
+    {
+        const char* data = job.data;
+        size_t remaining = job.size;
+        uint64_t offset = job.offset;
+
+        while (remaining > 0)
+        {
+#ifdef __linux__
+            const ssize_t written = pwrite(job.fd, data, remaining, static_cast<off_t>(offset));
+#endif
+#ifdef _WIN32
+            // Only this thread touches the file while the job runs.
+            const long long written = _lseeki64(job.fd, static_cast<long long>(offset), SEEK_SET) < 0
+                                      ? -1
+                                      : _write(job.fd, data, static_cast<unsigned>(remaining));
+#endif
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return errno;
+            }
+
+            if (written == 0)
+            {
+                return EIO;
+            }
+
+            data += written;
+            remaining -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+
+        return 0;
+    }
+
+    void TFTPWriteBehind::commit_all(const std::vector<write_job_t*>& jobs, sync_policy_t sync_policy)
+    {
+        for (write_job_t* job : jobs)
+        {
+            job->error = 0;
+            job->directory_error = 0;
+
+            // Every write of the file is done, none moves the time afterwards.
+            if (job->modified_time != 0)
+            {
+                (void)TFTP::write_modified_time(job->temp_path, job->modified_time);
+            }
+        }
+
+#ifdef __linux__
+        if (sync_policy == SYNC_POLICY_GROUP)
+        {
+            // Writeback of every file starts first, so the waits below
+            // overlap instead of queueing one behind the other.
+            for (const write_job_t* job : jobs)
+            {
+                (void)sync_file_range(job->fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+            }
+
+            // Waiting on the data reports the write errors of each file
+            // without flushing the disk cache.
+            for (write_job_t* job : jobs)
+            {
+                if (sync_file_range(job->fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                                                   SYNC_FILE_RANGE_WAIT_AFTER) != 0)
+                {
+                    job->error = errno;
+                }
+            }
+
+            sync_devices(jobs);
+        }
+        else if (sync_policy == SYNC_POLICY_FILE)
+        {
+            for (write_job_t* job : jobs)
+            {
+                if (fsync(job->fd) != 0)
+                {
+                    job->error = errno;
+                }
+            }
+        }
+#endif
+#ifdef _WIN32
+        if (sync_policy != SYNC_POLICY_NONE)
+        {
+            for (write_job_t* job : jobs)
+            {
+                if (_commit(job->fd) != 0)
+                {
+                    job->error = errno;
+                }
+            }
+        }
+#endif
+
+        for (write_job_t* job : jobs)
+        {
+            if (job->error != 0)
+            {
+                continue;
+            }
+
+            std::error_code error;
+            std::filesystem::rename(job->temp_path, job->final_path, error);
+
+            if (error)
+            {
+                job->error = error.value() != 0 ? error.value() : EIO;
+            }
+        }
+
+        if (sync_policy != SYNC_POLICY_NONE)
+        {
+            sync_directories(jobs);
+        }
+    }
+
+    void TFTPWriteBehind::sync_devices(const std::vector<write_job_t*>& jobs)
+    {
+#ifdef __linux__
+        std::vector<dev_t> devices(jobs.size());
+
+        for (size_t index = 0; index < jobs.size(); ++index)
+        {
+            struct stat info{};
+            devices[index] = fstat(jobs[index]->fd, &info) == 0 ? info.st_dev : 0;
+        }
+
+        std::vector<dev_t> synced;
+
+        for (size_t index = 0; index < jobs.size(); ++index)
+        {
+            const dev_t device = devices[index];
+
+            if (jobs[index]->error != 0 || std::find(synced.begin(), synced.end(), device) != synced.end())
+            {
+                continue;
+            }
+
+            synced.push_back(device);
+
+            // One journal commit and one cache flush make the data, the size
+            // and the time of every file of the group on this device durable.
+            if (syncfs(jobs[index]->fd) == 0)
+            {
+                continue;
+            }
+
+            // The failure may belong to any file of the file system, each
+            // file of the group finds out about its own with a sync of its own.
+            for (size_t other = index; other < jobs.size(); ++other)
+            {
+                if (devices[other] == device && jobs[other]->error == 0 && fsync(jobs[other]->fd) != 0)
+                {
+                    jobs[other]->error = errno;
+                }
+            }
+        }
+#else
+        (void)jobs;
+#endif
+    }
+
+    void TFTPWriteBehind::sync_directories(const std::vector<write_job_t*>& jobs)
+    {
+#ifdef __linux__
+        const auto directory_of = [](const write_job_t* job)
+        {
+            const std::filesystem::path directory = std::filesystem::path(job->final_path).parent_path();
+            return directory.empty() ? std::filesystem::path(".") : directory;
+        };
+
+        std::vector<std::filesystem::path> synced;
+
+        for (const write_job_t* job : jobs)
+        {
+            const std::filesystem::path directory = directory_of(job);
+
+            if (job->error != 0 || std::find(synced.begin(), synced.end(), directory) != synced.end())
+            {
+                continue;
+            }
+
+            synced.push_back(directory);
+
+            // The rename itself is only durable once the directory is flushed.
+            const int directory_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+            if (directory_fd < 0 || fsync(directory_fd) != 0)
+            {
+                const int error = errno;
+
+                // The files are already visible under their final names, only
+                // the durability of the rename is in doubt.
+                for (write_job_t* other : jobs)
+                {
+                    if (other->error == 0 && directory_of(other) == directory)
+                    {
+                        other->directory_error = error;
+                    }
+                }
+            }
+
+            if (directory_fd >= 0)
+            {
+                close(directory_fd);
+            }
+        }
+#else
+        // NTFS journals the rename, there is no directory handle to flush.
+        (void)jobs;
+#endif
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+// Protected Functions
+////////////////////////////////////////////////////////////////////////////////
+
+} // YB
+
+/* End of File */